@@ -0,0 +1,34 @@
+# Fontes da estação, compartilhadas pelo firmware (CMakeLists.txt) e pelo
+# build no PC (host/CMakeLists.txt): um arquivo novo entra só aqui.
+get_filename_component(ESTACAO_ROOT ${CMAKE_CURRENT_LIST_DIR}/.. ABSOLUTE)
+
+set(ESTACAO_SOURCES
+        meteriologicaInterfaceWeb.c
+        lib/buzzer/buzzer.c
+        lib/matriz/matriz.c
+        lib/sensores/aht20.c
+        lib/sensores/bmp280.c
+        lib/sensores/compensation.c
+        lib/sensores/i2c_async.c
+        lib/sensores/sensor_bus.c
+        lib/filter/filter.c
+        lib/metrics/metrics.c
+        lib/trace/trace.c
+        lib/log/dlog.c
+        lib/alerts/alert_rules.c
+        lib/led/led.c
+        lib/http/http_server.c
+        lib/http/http_parser.c
+        lib/http/http_router.c
+        lib/http/http_sse.c
+        lib/http/http_ws.c
+        lib/http/sha1.c
+        lib/http/web_assets.c
+        lib/util/fmt_fixed.c
+        lib/history/history.c
+        lib/tslog/tslog.c
+        lib/tslog/tslog_flash.c
+        lib/util/wall_clock.c
+        lib/config/config_store.c
+)
+list(TRANSFORM ESTACAO_SOURCES PREPEND ${ESTACAO_ROOT}/)
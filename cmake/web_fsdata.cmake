@@ -0,0 +1,78 @@
+# Arquivos web (web/): comprimidos com gzip em build e gravados na flash como
+# imagem do fs do lwIP (HTTPD_FSDATA_FILE em lwipopts.h), com ETag e 304.
+#
+# estacao_web_fsdata(<alvo>) gera generated/fsdata_web.c no build, põe o
+# diretório no include do alvo e define WEB_FSDATA_FILE no escopo de quem
+# chamou (para o OBJECT_DEPENDS do arquivo que o inclui).
+#
+# O Chart.js vai para a imagem e é servido aos usuários, então só entra com o
+# SHA-256 conferido. O caminho normal é versionar web/vendor/chart.umd.js
+# (build sem rede); com CHARTJS_SHA256 definido, o arquivo versionado é
+# conferido e, se faltar, baixado uma vez com EXPECTED_HASH. Hash diferente
+# sempre interrompe o build.
+#
+# Com ESTACAO_CHARTJS_OPTIONAL ligado (build no PC), a falta do arquivo sem
+# CHARTJS_SHA256 não interrompe o build: /vendor/chart.umd.js vira um script
+# vazio e a página fica sem gráficos.
+get_filename_component(ESTACAO_ROOT ${CMAKE_CURRENT_LIST_DIR}/.. ABSOLUTE)
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+set(WEB_DIR ${ESTACAO_ROOT}/web)
+set(CHARTJS_VERSION 4.4.1)
+set(CHARTJS_BUNDLE ${WEB_DIR}/vendor/chart.umd.js CACHE FILEPATH "Bundle UMD do Chart.js servido em /vendor/chart.umd.js")
+set(CHARTJS_SHA256 "" CACHE STRING "SHA-256 do chart.umd.js ${CHARTJS_VERSION} (confere o arquivo e permite baixá-lo)")
+
+function(estacao_web_fsdata target)
+    set(chartjs ${CHARTJS_BUNDLE})
+    string(TOLOWER "${CHARTJS_SHA256}" chartjs_expected)
+    if (EXISTS ${chartjs} AND CHARTJS_SHA256)
+        file(SHA256 ${chartjs} chartjs_hash)
+        if (NOT chartjs_hash STREQUAL chartjs_expected)
+            message(FATAL_ERROR "${chartjs} tem SHA-256 ${chartjs_hash}, esperado ${chartjs_expected}")
+        endif()
+    elseif (NOT EXISTS ${chartjs} AND CHARTJS_SHA256)
+        # Baixado uma única vez e conferido; versione o arquivo para builds em redes isoladas
+        message(STATUS "Baixando Chart.js ${CHARTJS_VERSION} para ${chartjs}")
+        file(DOWNLOAD https://cdn.jsdelivr.net/npm/chart.js@${CHARTJS_VERSION}/dist/chart.umd.js
+             ${chartjs} EXPECTED_HASH SHA256=${chartjs_expected} STATUS chartjs_status)
+        list(GET chartjs_status 0 chartjs_error)
+        if (NOT chartjs_error EQUAL 0)
+            file(REMOVE ${chartjs})
+            list(GET chartjs_status 1 chartjs_message)
+            message(FATAL_ERROR "Falha ao baixar ou conferir o Chart.js (${chartjs_message}): copie chart.umd.js ${CHARTJS_VERSION} para ${chartjs}")
+        endif()
+    elseif (NOT EXISTS ${chartjs})
+        if (NOT ESTACAO_CHARTJS_OPTIONAL)
+            message(FATAL_ERROR "Falta ${chartjs}: versione chart.umd.js ${CHARTJS_VERSION} ou defina CHARTJS_SHA256 para baixá-lo")
+        endif()
+        message(WARNING "Chart.js ausente: /vendor/chart.umd.js sai vazio (páginas sem gráficos)")
+        set(chartjs ${CMAKE_CURRENT_BINARY_DIR}/chart.umd.placeholder.js)
+        file(WRITE ${chartjs} "// Chart.js ${CHARTJS_VERSION} ausente neste build\n")
+    endif()
+
+    # Pares URL=arquivo de origem
+    set(web_files
+        /index.html=${WEB_DIR}/index.html
+        /limites.html=${WEB_DIR}/limites.html
+        /js/dashboard.js=${WEB_DIR}/js/dashboard.js
+        /js/limites.js=${WEB_DIR}/js/limites.js
+        /vendor/chart.umd.js=${chartjs}
+    )
+    set(web_sources ${web_files})
+    list(TRANSFORM web_sources REPLACE "^[^=]*=" "")
+
+    set(generated_dir ${CMAKE_CURRENT_BINARY_DIR}/generated)
+    add_custom_command(
+        OUTPUT ${generated_dir}/fsdata_web.c
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${generated_dir}
+        COMMAND ${Python3_EXECUTABLE} ${ESTACAO_ROOT}/tools/gerar_fsdata.py
+                ${generated_dir}/fsdata_web.c ${web_files}
+        DEPENDS ${ESTACAO_ROOT}/tools/gerar_fsdata.py ${web_sources}
+        COMMENT "Gerando imagem gzip dos arquivos web"
+        VERBATIM
+    )
+    add_custom_target(web_fsdata DEPENDS ${generated_dir}/fsdata_web.c)
+    add_dependencies(${target} web_fsdata)
+    target_include_directories(${target} PRIVATE ${generated_dir})
+    set(WEB_FSDATA_FILE ${generated_dir}/fsdata_web.c PARENT_SCOPE)
+endfunction()
@@ -0,0 +1,53 @@
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <poll.h>
+
+// Ligações internas entre os módulos do build no PC (host/). O firmware não
+// inclui este arquivo: para ele só existem os cabeçalhos do SDK em
+// host/include.
+//
+// Variáveis de ambiente (lidas no primeiro uso):
+//   ESTACAO_HOST_PORT=8080      porta TCP de quem pedir a 80 (só loopback)
+//   ESTACAO_HOST_SPEED=1        relógio virtual N vezes mais rápido
+//   ESTACAO_HOST_SENSORS=...    sensores em cada barramento (host_sensors.c)
+//   ESTACAO_HOST_SCENARIO=arq   roteiro de temperatura/umidade/pressão
+//   ESTACAO_HOST_NACK=N         uma transação I2C em N falha (NACK)
+//   ESTACAO_HOST_FLASH=arq      imagem da flash persistida em arquivo
+//   ESTACAO_HOST_PBUF=N         tamanho máximo de cada pbuf recebido
+//   ESTACAO_HOST_TRACE=gpio,i2c traços em stderr
+
+// Relógio (host_time.c). Virtual: o que time_us_64 devolve.
+uint64_t host_real_us(void);
+uint64_t host_virtual_to_real_us(uint64_t virtual_us);
+
+// true se o traço pedido está em ESTACAO_HOST_TRACE
+bool host_trace_enabled(const char *name);
+
+// Interrupções (host_irq.c): o handler roda na thread de interrupções, com
+// as interrupções "desligadas". tag identifica o evento para host_irq_cancel.
+void host_irq_post(uint64_t at_virtual_us, void (*handler)(void *arg), void *arg, const void *tag);
+void host_irq_cancel(const void *tag);
+void (*host_irq_handler(unsigned num))(void);
+bool host_irq_enabled(unsigned num);
+
+// Núcleo (0 ou 1) da thread que chama (host_async.c)
+unsigned host_core_num(void);
+
+// Dispositivos no barramento (host_sensors.c). false: ninguém respondeu.
+bool host_sensors_write(unsigned bus, uint8_t addr, const uint8_t *data, size_t len);
+bool host_sensors_read(unsigned bus, uint8_t addr, uint8_t *out, size_t len);
+
+// Rede (host_net.c), atendida pela thread do núcleo 0 enquanto ela espera
+// trabalho: host_net_pollfds preenche os sockets a observar e devolve
+// quantos; host_net_process trata os que ficaram prontos e os timers.
+int host_net_pollfds(struct pollfd *fds, int max);
+void host_net_process(const struct pollfd *fds, int count);
+uint64_t host_net_next_timer_us(void);
+
+#define HOST_NET_MAX_FDS 24
+
+#endif // HOST_H
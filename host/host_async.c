@@ -0,0 +1,271 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "pico/stdlib.h"
+#include "pico/async_context_poll.h"
+#include "pico/multicore.h"
+#include "host.h"
+
+// async_context e núcleos. Cada contexto pertence à thread que o criou
+// (núcleo 0: a thread principal; núcleo 1: a de multicore_launch_core1) e
+// só ela executa os trabalhos, em async_context_poll. set_work_pending e a
+// inclusão de trabalhos podem vir de outra thread ou das interrupções: as
+// listas ficam sob list_lock e o eventfd do contexto acorda a espera.
+//
+// O contexto do núcleo 0 também atende a rede: enquanto espera trabalho ele
+// observa os sockets de host_net.c e trata os que ficarem prontos, como o
+// lwIP em segundo plano na placa.
+
+static __thread unsigned core_num; // 0 na thread principal
+static pthread_mutex_t list_lock = PTHREAD_MUTEX_INITIALIZER;
+
+unsigned host_core_num(void) {
+    return core_num;
+}
+
+unsigned get_core_num(void) {
+    return core_num;
+}
+
+static void wake(async_context_t *context) {
+    uint64_t one = 1;
+    if (write(context->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        perror("[host] eventfd");
+    }
+}
+
+bool async_context_poll_init_with_defaults(async_context_poll_t *self) {
+    self->core = (async_context_t){.core_num = core_num};
+    self->core.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    return self->core.wake_fd >= 0;
+}
+
+bool async_context_add_at_time_worker(async_context_t *context, async_at_time_worker_t *worker) {
+    pthread_mutex_lock(&list_lock);
+    bool added = true;
+    for (async_at_time_worker_t *w = context->at_time_list; w; w = w->next) {
+        if (w == worker) {
+            added = false;
+        }
+    }
+    if (added) {
+        worker->next = context->at_time_list;
+        context->at_time_list = worker;
+    }
+    pthread_mutex_unlock(&list_lock);
+    if (added && core_num != context->core_num) {
+        wake(context);
+    }
+    return added;
+}
+
+bool async_context_add_at_time_worker_at(async_context_t *context, async_at_time_worker_t *worker,
+                                         absolute_time_t at) {
+    worker->next_time = at;
+    return async_context_add_at_time_worker(context, worker);
+}
+
+bool async_context_add_at_time_worker_in_ms(async_context_t *context, async_at_time_worker_t *worker,
+                                            uint32_t ms) {
+    return async_context_add_at_time_worker_at(context, worker, make_timeout_time_ms(ms));
+}
+
+bool async_context_remove_at_time_worker(async_context_t *context, async_at_time_worker_t *worker) {
+    pthread_mutex_lock(&list_lock);
+    bool removed = false;
+    for (async_at_time_worker_t **p = &context->at_time_list; *p; p = &(*p)->next) {
+        if (*p == worker) {
+            *p = worker->next;
+            removed = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&list_lock);
+    return removed;
+}
+
+bool async_context_add_when_pending_worker(async_context_t *context, async_when_pending_worker_t *worker) {
+    pthread_mutex_lock(&list_lock);
+    worker->next = context->when_pending_list;
+    context->when_pending_list = worker;
+    pthread_mutex_unlock(&list_lock);
+    return true;
+}
+
+bool async_context_remove_when_pending_worker(async_context_t *context, async_when_pending_worker_t *worker) {
+    pthread_mutex_lock(&list_lock);
+    bool removed = false;
+    for (async_when_pending_worker_t **p = &context->when_pending_list; *p; p = &(*p)->next) {
+        if (*p == worker) {
+            *p = worker->next;
+            removed = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&list_lock);
+    return removed;
+}
+
+void async_context_set_work_pending(async_context_t *context, async_when_pending_worker_t *worker) {
+    worker->work_pending = true;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    wake(context);
+}
+
+void async_context_poll(async_context_t *context) {
+    for (;;) {
+        async_when_pending_worker_t *pending = NULL;
+        pthread_mutex_lock(&list_lock);
+        for (async_when_pending_worker_t *w = context->when_pending_list; w && !pending; w = w->next) {
+            if (w->work_pending) {
+                w->work_pending = false;
+                pending = w;
+            }
+        }
+        pthread_mutex_unlock(&list_lock);
+        if (!pending) {
+            break;
+        }
+        pending->do_work(context, pending);
+    }
+
+    // Um trabalho com prazo sai da lista antes de rodar e pode se recolocar
+    for (;;) {
+        uint64_t now = time_us_64();
+        async_at_time_worker_t *due = NULL;
+        pthread_mutex_lock(&list_lock);
+        for (async_at_time_worker_t **p = &context->at_time_list; *p; p = &(*p)->next) {
+            if (to_us_since_boot((*p)->next_time) <= now) {
+                due = *p;
+                *p = due->next;
+                break;
+            }
+        }
+        pthread_mutex_unlock(&list_lock);
+        if (!due) {
+            break;
+        }
+        due->do_work(context, due);
+    }
+}
+
+// Próximo prazo do contexto; 0 se há trabalho pendente
+static uint64_t next_deadline_us(async_context_t *context, uint64_t until) {
+    pthread_mutex_lock(&list_lock);
+    uint64_t deadline = until;
+    for (async_when_pending_worker_t *w = context->when_pending_list; w; w = w->next) {
+        if (w->work_pending) {
+            deadline = 0;
+        }
+    }
+    for (async_at_time_worker_t *w = context->at_time_list; w; w = w->next) {
+        deadline = MIN(deadline, to_us_since_boot(w->next_time));
+    }
+    pthread_mutex_unlock(&list_lock);
+    if (context->core_num == 0) {
+        deadline = MIN(deadline, host_net_next_timer_us());
+    }
+    return deadline;
+}
+
+void async_context_wait_for_work_until(async_context_t *context, absolute_time_t until) {
+    struct pollfd fds[1 + HOST_NET_MAX_FDS];
+    fds[0] = (struct pollfd){.fd = context->wake_fd, .events = POLLIN};
+    int net_count = context->core_num == 0 ? host_net_pollfds(&fds[1], HOST_NET_MAX_FDS) : 0;
+
+    uint64_t deadline = next_deadline_us(context, to_us_since_boot(until));
+    uint64_t now = time_us_64();
+    struct timespec timeout = {0};
+    struct timespec *ptimeout = &timeout;
+    if (deadline == UINT64_MAX) {
+        ptimeout = NULL;
+    } else if (deadline > now) {
+        uint64_t real = host_virtual_to_real_us(deadline - now);
+        timeout.tv_sec = (time_t)(real / 1000000u);
+        timeout.tv_nsec = (long)(real % 1000000u) * 1000;
+    }
+    if (ppoll(fds, (nfds_t)(1 + net_count), ptimeout, NULL) < 0 && errno != EINTR) {
+        perror("[host] ppoll");
+        return;
+    }
+    if (fds[0].revents & POLLIN) {
+        uint64_t count;
+        if (read(context->wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+            perror("[host] eventfd");
+        }
+    }
+    if (context->core_num == 0) {
+        host_net_process(&fds[1], net_count);
+    }
+}
+
+void async_context_wait_for_work_ms(async_context_t *context, uint32_t ms) {
+    async_context_wait_for_work_until(context, make_timeout_time_ms(ms));
+}
+
+// FIFO entre os núcleos: 8 palavras em cada sentido, como no RP2040
+#define FIFO_DEPTH 8
+
+struct fifo {
+    uint32_t data[FIFO_DEPTH];
+    unsigned head;
+    unsigned count;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+};
+
+static struct fifo fifos[2] = { // Índice: núcleo que lê
+    {.lock = PTHREAD_MUTEX_INITIALIZER, .changed = PTHREAD_COND_INITIALIZER},
+    {.lock = PTHREAD_MUTEX_INITIALIZER, .changed = PTHREAD_COND_INITIALIZER},
+};
+
+void multicore_fifo_push_blocking(uint32_t data) {
+    struct fifo *f = &fifos[!core_num];
+    pthread_mutex_lock(&f->lock);
+    while (f->count == FIFO_DEPTH) {
+        pthread_cond_wait(&f->changed, &f->lock);
+    }
+    f->data[(f->head + f->count++) % FIFO_DEPTH] = data;
+    pthread_cond_broadcast(&f->changed);
+    pthread_mutex_unlock(&f->lock);
+}
+
+uint32_t multicore_fifo_pop_blocking(void) {
+    struct fifo *f = &fifos[core_num];
+    pthread_mutex_lock(&f->lock);
+    while (f->count == 0) {
+        pthread_cond_wait(&f->changed, &f->lock);
+    }
+    uint32_t data = f->data[f->head];
+    f->head = (f->head + 1) % FIFO_DEPTH;
+    f->count--;
+    pthread_cond_broadcast(&f->changed);
+    pthread_mutex_unlock(&f->lock);
+    return data;
+}
+
+static void *core1_thread(void *arg) {
+    core_num = 1;
+    ((void (*)(void))arg)();
+    return NULL;
+}
+
+void multicore_launch_core1(void (*entry)(void)) {
+    // Os sinais (Ctrl+C) ficam com a thread principal
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, core1_thread, (void *)entry) != 0) {
+        perror("[host] núcleo 1");
+        exit(1);
+    }
+    pthread_detach(thread);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+}
@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include "host.h"
+
+// Flash simulada: 2 MB em RAM, apagada (0xFF) no início. Com
+// ESTACAO_HOST_FLASH a imagem é lida do arquivo ao iniciar e regravada a
+// cada apagamento ou programação, então o log e a configuração sobrevivem a
+// um reinício como na placa. Programar só zera bits, como na flash real.
+//
+// __flash_binary_end (fim do programa, lib/flash_layout.h) é definido no
+// link como o início da imagem (host/CMakeLists.txt): todo o espaço fica
+// para os dados.
+
+uint8_t host_flash_image[PICO_FLASH_SIZE_BYTES];
+
+static const char *image_path(void) {
+    return getenv("ESTACAO_HOST_FLASH");
+}
+
+__attribute__((constructor)) static void flash_load(void) {
+    memset(host_flash_image, 0xFF, sizeof(host_flash_image));
+    const char *path = image_path();
+    FILE *f = path ? fopen(path, "rb") : NULL;
+    if (f) {
+        if (fread(host_flash_image, 1, sizeof(host_flash_image), f) != sizeof(host_flash_image)) {
+            fprintf(stderr, "[host] %s: imagem incompleta, resto apagado\n", path);
+        }
+        fclose(f);
+    }
+}
+
+// Só o trecho alterado vai para o arquivo
+static void flash_save(uint32_t offset, size_t count) {
+    const char *path = image_path();
+    if (!path) {
+        return;
+    }
+    FILE *f = fopen(path, "r+b");
+    if (!f) {
+        f = fopen(path, "w+b");
+        if (f) {
+            fwrite(host_flash_image, 1, sizeof(host_flash_image), f);
+            fclose(f);
+        }
+        return;
+    }
+    fseek(f, (long)offset, SEEK_SET);
+    fwrite(&host_flash_image[offset], 1, count, f);
+    fclose(f);
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "[host] flash_range_erase fora de setor: 0x%x +%zu\n", flash_offs, count);
+        abort();
+    }
+    memset(&host_flash_image[flash_offs], 0xFF, count);
+    flash_save(flash_offs, count);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "[host] flash_range_program fora de página: 0x%x +%zu\n", flash_offs, count);
+        abort();
+    }
+    for (size_t i = 0; i < count; i++) {
+        host_flash_image[flash_offs + i] &= data[i];
+    }
+    flash_save(flash_offs, count);
+}
+
+// Nada executa da flash no PC: basta chamar a função
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
+
+bool flash_safe_execute_core_init(void) {
+    return true;
+}
@@ -0,0 +1,170 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "host.h"
+
+// GPIO, PWM e PIO simulados. Saídas, níveis de PWM e quadros da matriz de
+// LEDs aparecem em stderr com ESTACAO_HOST_TRACE=gpio. Um número de GPIO
+// digitado no stdin (uma linha) é um aperto de botão: a entrada vai a 0 e a
+// borda de descida chega ao callback na thread de interrupções, se estiver
+// habilitada.
+
+#define NUM_GPIOS   30
+#define MATRIX_LEDS 25 // Palavras por quadro da matriz WS2812 (5x5)
+
+struct pio_hw {
+    uint32_t words[MATRIX_LEDS];
+    unsigned count;
+};
+
+static struct pio_hw pio_blocks[2];
+PIO const pio0 = &pio_blocks[0];
+PIO const pio1 = &pio_blocks[1];
+
+static bool levels[NUM_GPIOS];
+static bool outputs[NUM_GPIOS];
+static uint32_t irq_events[NUM_GPIOS];
+static gpio_irq_callback_t irq_callback;
+static uint16_t pwm_wrap[8];
+static pthread_once_t stdin_once = PTHREAD_ONCE_INIT;
+
+void gpio_init(uint gpio) {
+    if (gpio < NUM_GPIOS) {
+        levels[gpio] = false;
+        outputs[gpio] = false;
+    }
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    if (gpio < NUM_GPIOS) {
+        outputs[gpio] = out;
+    }
+}
+
+void gpio_put(uint gpio, bool value) {
+    if (gpio < NUM_GPIOS && levels[gpio] != value) {
+        levels[gpio] = value;
+        if (host_trace_enabled("gpio")) {
+            fprintf(stderr, "[gpio] %u = %d\n", gpio, value);
+        }
+    }
+}
+
+bool gpio_get(uint gpio) {
+    return gpio < NUM_GPIOS && levels[gpio];
+}
+
+void gpio_pull_up(uint gpio) {
+    if (gpio < NUM_GPIOS && !outputs[gpio]) {
+        levels[gpio] = true;
+    }
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio, (void)fn;
+}
+
+// Aperto: borda de descida agora, soltura 100 ms (virtuais) depois
+static void button_release(void *arg) {
+    uint gpio = (uint)(uintptr_t)arg;
+    levels[gpio] = true;
+    if ((irq_events[gpio] & GPIO_IRQ_EDGE_RISE) && irq_callback) {
+        irq_callback(gpio, GPIO_IRQ_EDGE_RISE);
+    }
+}
+
+static void button_press(void *arg) {
+    uint gpio = (uint)(uintptr_t)arg;
+    levels[gpio] = false;
+    if ((irq_events[gpio] & GPIO_IRQ_EDGE_FALL) && irq_callback) {
+        irq_callback(gpio, GPIO_IRQ_EDGE_FALL);
+    }
+    host_irq_post(time_us_64() + 100000u, button_release, arg, &levels[gpio]);
+}
+
+static void *stdin_thread(void *arg) {
+    (void)arg;
+    char line[64];
+    while (fgets(line, sizeof(line), stdin)) {
+        char *end;
+        long gpio = strtol(line, &end, 10);
+        if (end == line || gpio < 0 || gpio >= NUM_GPIOS || outputs[gpio]) {
+            fprintf(stderr, "[host] digite o número de uma entrada para apertá-la\n");
+            continue;
+        }
+        host_irq_post(time_us_64(), button_press, (void *)(uintptr_t)gpio, &levels[gpio]);
+    }
+    return NULL;
+}
+
+static void stdin_start(void) {
+    pthread_t thread;
+    pthread_create(&thread, NULL, stdin_thread, NULL);
+    pthread_detach(thread);
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled,
+                                        gpio_irq_callback_t callback) {
+    if (gpio >= NUM_GPIOS) {
+        return;
+    }
+    uint32_t irq = save_and_disable_interrupts();
+    irq_events[gpio] = enabled ? irq_events[gpio] | event_mask : irq_events[gpio] & ~event_mask;
+    irq_callback = callback; // Um callback por núcleo; a estação usa um só
+    restore_interrupts(irq);
+    pthread_once(&stdin_once, stdin_start);
+}
+
+// PWM: a fatia de cada pino como no RP2040; o nível sai no trace
+uint pwm_gpio_to_slice_num(uint gpio) {
+    return (gpio >> 1) & 7u;
+}
+
+pwm_config pwm_get_default_config(void) {
+    return (pwm_config){.div = 1u << 4, .top = 0xFFFF};
+}
+
+void pwm_config_set_clkdiv(pwm_config *c, float div) {
+    c->div = (uint32_t)(div * 16.0f);
+}
+
+void pwm_init(uint slice_num, pwm_config *c, bool start) {
+    (void)start;
+    pwm_wrap[slice_num & 7u] = (uint16_t)c->top;
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {
+    pwm_wrap[slice_num & 7u] = wrap;
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level) {
+    if (host_trace_enabled("gpio")) {
+        fprintf(stderr, "[pwm] %u = %u/%u\n", gpio, level, pwm_wrap[pwm_gpio_to_slice_num(gpio)]);
+    }
+}
+
+// PIO: só a máquina de estados da matriz recebe dados
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    (void)pio, (void)program;
+    return 0;
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) {
+    (void)sm;
+    pio->words[pio->count++] = data >> 8; // GRB nos 24 bits de cima
+    if (pio->count < MATRIX_LEDS) {
+        return;
+    }
+    pio->count = 0;
+    if (host_trace_enabled("gpio")) {
+        fprintf(stderr, "[matriz]");
+        for (int i = 0; i < MATRIX_LEDS; i++) {
+            fprintf(stderr, " %06x", (unsigned)pio->words[i]);
+        }
+        fprintf(stderr, "\n");
+    }
+}
@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "host.h"
+
+// Controlador I2C e DMA simulados. As transações vão para os dispositivos de
+// host_sensors.c e ocupam o tempo que levariam no fio a 400 kHz: as
+// bloqueantes dormem esse tempo, as por DMA terminam com o evento de
+// interrupção do I2C nesse prazo (STOP_DET, ou TX_ABRT com NACK).
+
+#define BUS_BYTE_US    23u   // 9 bits a 400 kHz
+#define BUS_OVERHEAD_US 10u  // START e STOP
+
+#define DREQ_I2C0_TX 32u
+
+struct i2c_inst {
+    i2c_hw_t hw;
+    uint index;
+};
+
+i2c_inst_t i2c0_inst = {.index = 0};
+i2c_inst_t i2c1_inst = {.index = 1};
+
+static unsigned nack_every = UINT32_MAX; // Falha injetada (ESTACAO_HOST_NACK)
+static unsigned transfer_count;
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    const char *s = getenv("ESTACAO_HOST_NACK");
+    if (s && atoi(s) > 0) {
+        nack_every = (unsigned)atoi(s);
+    }
+    i2c->hw.enable = 1;
+    return baudrate;
+}
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return &i2c->hw;
+}
+
+uint i2c_hw_index(i2c_inst_t *i2c) {
+    return i2c->index;
+}
+
+i2c_inst_t *i2c_get_instance(uint num) {
+    return num ? i2c1 : i2c0;
+}
+
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return DREQ_I2C0_TX + 2 * i2c->index + !is_tx;
+}
+
+static uint32_t bus_time_us(size_t bytes) {
+    return BUS_OVERHEAD_US + (uint32_t)(bytes + 1) * BUS_BYTE_US; // + endereço
+}
+
+// Escrita e leitura com repeated start entre elas; false no primeiro NACK
+static bool bus_transfer(uint bus, uint8_t addr, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len) {
+    bool ok = ++transfer_count % nack_every != 0;
+    if (ok && (tx_len || !rx_len)) {
+        ok = host_sensors_write(bus, addr, tx, tx_len);
+    }
+    if (ok && rx_len) {
+        ok = host_sensors_read(bus, addr, rx, rx_len);
+    }
+    if (host_trace_enabled("i2c")) {
+        fprintf(stderr, "[i2c%u] 0x%02x escreve %zu lê %zu: %s\n", bus, addr, tx_len, rx_len, ok ? "ok" : "NACK");
+    }
+    return ok;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    bool ok = bus_transfer(i2c->index, addr, src, len, NULL, 0);
+    sleep_us(bus_time_us(len));
+    return ok ? (int)len : PICO_ERROR_GENERIC;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)nostop;
+    bool ok = bus_transfer(i2c->index, addr, NULL, 0, dst, len);
+    sleep_us(bus_time_us(len));
+    return ok ? (int)len : PICO_ERROR_GENERIC;
+}
+
+// DMA
+
+struct dma_channel {
+    bool claimed;
+    bool busy;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint count;
+    enum dma_channel_transfer_size size;
+};
+
+// Transação por DMA em andamento num barramento
+struct dma_transfer {
+    int tx_channel;
+    int rx_channel;          // -1: só escrita
+    bool ok;
+    uint8_t rx[32];          // Copiado para o destino só no fim, como a DMA
+    uint rx_len;
+};
+
+static struct dma_channel channels[NUM_DMA_CHANNELS];
+static struct dma_transfer transfers[2] = {{.tx_channel = -1, .rx_channel = -1},
+                                          {.tx_channel = -1, .rx_channel = -1}};
+
+int dma_claim_unused_channel(bool required) {
+    for (int i = 0; i < NUM_DMA_CHANNELS; i++) {
+        if (!channels[i].claimed) {
+            channels[i].claimed = true;
+            return i;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "[host] sem canais de DMA livres\n");
+        abort();
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    channels[channel] = (struct dma_channel){0};
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    (void)channel;
+    return (dma_channel_config){.size = DMA_SIZE_32, .read_increment = true};
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return channels[channel].busy;
+}
+
+static i2c_inst_t *i2c_of_fifo(const volatile void *addr) {
+    for (uint i = 0; i < 2; i++) {
+        if (addr == &i2c_get_instance(i)->hw.data_cmd) {
+            return i2c_get_instance(i);
+        }
+    }
+    return NULL;
+}
+
+// Fim da transação: entrega os bytes e chama a interrupção do I2C
+static void transfer_done(void *arg) {
+    i2c_inst_t *i2c = arg;
+    struct dma_transfer *t = &transfers[i2c->index];
+    if (t->rx_channel >= 0) {
+        struct dma_channel *rx = &channels[t->rx_channel];
+        if (t->ok) {
+            for (uint i = 0; i < t->rx_len; i++) {
+                ((volatile uint8_t *)rx->write_addr)[i] = t->rx[i];
+            }
+        }
+        rx->busy = false;
+    }
+    channels[t->tx_channel].busy = false;
+
+    uint32_t status = I2C_IC_INTR_STAT_R_STOP_DET_BITS | (t->ok ? 0 : I2C_IC_INTR_STAT_R_TX_ABRT_BITS);
+    i2c->hw.raw_intr_stat = status;
+    i2c->hw.intr_stat = status & i2c->hw.intr_mask;
+    uint irq = I2C0_IRQ + i2c->index;
+    if (i2c->hw.intr_stat && host_irq_enabled(irq)) {
+        host_irq_handler(irq)();
+    }
+    i2c->hw.intr_stat = 0;
+    i2c->hw.raw_intr_stat = 0;
+}
+
+// O canal de TX disparado carrega as palavras de IC_DATA_CMD: bytes a
+// escrever, e um comando de leitura (CMD) por byte a ler
+static void start_transfer(i2c_inst_t *i2c, int tx_channel) {
+    struct dma_channel *tx = &channels[tx_channel];
+    struct dma_transfer *t = &transfers[i2c->index];
+    *t = (struct dma_transfer){.tx_channel = tx_channel, .rx_channel = -1};
+    for (int i = 0; i < NUM_DMA_CHANNELS; i++) {
+        if (channels[i].busy && channels[i].read_addr == &i2c->hw.data_cmd) {
+            t->rx_channel = i;
+        }
+    }
+
+    uint8_t out[32];
+    uint out_len = 0;
+    const volatile uint16_t *words = tx->read_addr;
+    for (uint i = 0; i < tx->count; i++) {
+        if (words[i] & I2C_IC_DATA_CMD_CMD_BITS) {
+            t->rx_len++;
+        } else if (out_len < sizeof(out)) {
+            out[out_len++] = (uint8_t)words[i];
+        }
+    }
+    if (t->rx_len > sizeof(t->rx) || (t->rx_len && t->rx_channel < 0)) {
+        fprintf(stderr, "[host] transação por DMA inválida no i2c%u\n", i2c->index);
+        abort();
+    }
+    t->ok = bus_transfer(i2c->index, (uint8_t)i2c->hw.tar, out, out_len, t->rx, t->rx_len);
+    tx->busy = true;
+    host_irq_post(time_us_64() + bus_time_us(tx->count), transfer_done, i2c, i2c);
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    uint32_t irq = save_and_disable_interrupts();
+    struct dma_channel *c = &channels[channel];
+    c->write_addr = write_addr;
+    c->read_addr = read_addr;
+    c->count = transfer_count;
+    c->size = config->size;
+    if (trigger) {
+        c->busy = true;
+        i2c_inst_t *i2c = i2c_of_fifo(write_addr);
+        if (i2c) {
+            start_transfer(i2c, (int)channel);
+        } else if (!i2c_of_fifo(read_addr)) {
+            fprintf(stderr, "[host] DMA sem destino simulado (canal %u)\n", channel);
+            abort();
+        }
+    }
+    restore_interrupts(irq);
+}
+
+void dma_channel_abort(uint channel) {
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint i = 0; i < 2; i++) {
+        struct dma_transfer *t = &transfers[i];
+        if (channels[channel].busy && (t->tx_channel == (int)channel || t->rx_channel == (int)channel)) {
+            host_irq_cancel(i2c_get_instance(i));
+        }
+    }
+    channels[channel].busy = false;
+    restore_interrupts(irq);
+}
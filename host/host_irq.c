@@ -0,0 +1,274 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "host.h"
+
+// Interrupções do PC: uma thread executa, na ordem dos prazos (relógio
+// virtual), os eventos postados por alarmes, pelo fim das transações I2C e
+// pelos botões. Enquanto um handler roda ela segura irq_lock, a mesma trava
+// de save_and_disable_interrupts: o código que "desliga as interrupções"
+// nunca vê um handler no meio, como no RP2040. Fora disso os handlers
+// correm em paralelo com os dois núcleos, o que é mais agressivo que o
+// hardware (lá a interrupção para o núcleo) e bom para achar corridas.
+
+#define HOST_IRQ_EVENTS 64
+
+struct irq_event {
+    bool used;
+    uint64_t at_us;
+    uint32_t seq;            // Desempate: ordem de chegada
+    void (*handler)(void *arg);
+    void *arg;
+    const void *tag;
+};
+
+static pthread_mutex_t irq_lock;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_cond;
+static struct irq_event events[HOST_IRQ_EVENTS];
+static uint32_t next_seq;
+static pthread_once_t irq_once = PTHREAD_ONCE_INIT;
+
+static irq_handler_t handlers[NUM_IRQS];
+static bool enabled[NUM_IRQS];
+
+static void *irq_thread(void *arg);
+
+static void irq_init(void) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&irq_lock, &attr);
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&queue_cond, &cond_attr);
+    pthread_t thread;
+    pthread_create(&thread, NULL, irq_thread, NULL);
+    pthread_detach(thread);
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    pthread_once(&irq_once, irq_init);
+    pthread_mutex_lock(&irq_lock);
+    return 0;
+}
+
+void restore_interrupts(uint32_t status) {
+    (void)status;
+    pthread_mutex_unlock(&irq_lock);
+}
+
+// Com queue_lock
+static struct irq_event *earliest_event(void) {
+    struct irq_event *next = NULL;
+    for (int i = 0; i < HOST_IRQ_EVENTS; i++) {
+        struct irq_event *e = &events[i];
+        if (e->used && (!next || e->at_us < next->at_us ||
+                        (e->at_us == next->at_us && (int32_t)(e->seq - next->seq) < 0))) {
+            next = e;
+        }
+    }
+    return next;
+}
+
+void host_irq_post(uint64_t at_virtual_us, void (*handler)(void *arg), void *arg, const void *tag) {
+    pthread_once(&irq_once, irq_init);
+    pthread_mutex_lock(&queue_lock);
+    struct irq_event *slot = NULL;
+    for (int i = 0; i < HOST_IRQ_EVENTS && !slot; i++) {
+        if (!events[i].used) {
+            slot = &events[i];
+        }
+    }
+    if (!slot) {
+        fprintf(stderr, "[host] fila de interrupções cheia (%d eventos)\n", HOST_IRQ_EVENTS);
+        abort();
+    }
+    *slot = (struct irq_event){
+        .used = true,
+        .at_us = at_virtual_us,
+        .seq = next_seq++,
+        .handler = handler,
+        .arg = arg,
+        .tag = tag,
+    };
+    pthread_cond_signal(&queue_cond);
+    pthread_mutex_unlock(&queue_lock);
+}
+
+void host_irq_cancel(const void *tag) {
+    pthread_mutex_lock(&queue_lock);
+    for (int i = 0; i < HOST_IRQ_EVENTS; i++) {
+        if (events[i].used && events[i].tag == tag) {
+            events[i].used = false;
+        }
+    }
+    pthread_mutex_unlock(&queue_lock);
+}
+
+// Executa os eventos vencidos com as interrupções "desligadas". Cada evento
+// sai da fila só com irq_lock já tomado: um cancelamento feito com as
+// interrupções desligadas nunca perde para um handler já retirado.
+static void run_due_events(void) {
+    pthread_mutex_lock(&irq_lock);
+    for (;;) {
+        pthread_mutex_lock(&queue_lock);
+        struct irq_event *e = earliest_event();
+        if (!e || e->at_us > time_us_64()) {
+            pthread_mutex_unlock(&queue_lock);
+            break;
+        }
+        struct irq_event due = *e;
+        e->used = false;
+        pthread_mutex_unlock(&queue_lock);
+        due.handler(due.arg);
+    }
+    pthread_mutex_unlock(&irq_lock);
+}
+
+static void *irq_thread(void *arg) {
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&queue_lock);
+        for (;;) {
+            struct irq_event *next = earliest_event();
+            uint64_t now = time_us_64();
+            if (next && next->at_us <= now) {
+                break;
+            }
+            if (!next) {
+                pthread_cond_wait(&queue_cond, &queue_lock);
+                continue;
+            }
+            uint64_t wait_us = host_virtual_to_real_us(next->at_us - now);
+            struct timespec deadline;
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_sec += (time_t)(wait_us / 1000000u);
+            deadline.tv_nsec += (long)(wait_us % 1000000u) * 1000;
+            if (deadline.tv_nsec >= 1000000000) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000;
+            }
+            pthread_cond_timedwait(&queue_cond, &queue_lock, &deadline);
+        }
+        pthread_mutex_unlock(&queue_lock);
+        run_due_events();
+    }
+    return NULL;
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num < NUM_IRQS) {
+        handlers[num] = handler;
+    }
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    (void)order_priority;
+    irq_set_exclusive_handler(num, handler); // A estação usa um handler por linha
+}
+
+void irq_set_enabled(uint num, bool on) {
+    if (num < NUM_IRQS) {
+        enabled[num] = on;
+    }
+}
+
+void (*host_irq_handler(unsigned num))(void) {
+    return num < NUM_IRQS ? handlers[num] : NULL;
+}
+
+bool host_irq_enabled(unsigned num) {
+    return num < NUM_IRQS && enabled[num] && handlers[num];
+}
+
+// Alarmes: um evento por alarme, com o id na própria entrada
+struct alarm_pool {
+    int unused;
+};
+
+struct alarm {
+    alarm_id_t id;           // 0: livre
+    uint64_t at_us;
+    alarm_callback_t callback;
+    void *user_data;
+};
+
+static struct alarm_pool default_pool;
+static struct alarm alarms[HOST_IRQ_EVENTS];
+static alarm_id_t next_alarm_id = 1;
+
+static void fire_alarm(void *arg) {
+    struct alarm *a = arg;
+    alarm_id_t id = a->id;
+    int64_t again = a->callback(id, a->user_data);
+    if (a->id != id) {
+        return; // Cancelado de dentro do callback
+    }
+    if (again == 0) {
+        a->id = 0;
+        return;
+    }
+    // > 0: a partir do prazo anterior; < 0: a partir de agora (como no SDK)
+    a->at_us = again > 0 ? a->at_us + (uint64_t)again : time_us_64() + (uint64_t)-again;
+    host_irq_post(a->at_us, fire_alarm, a, a);
+}
+
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers) {
+    (void)max_timers;
+    return &default_pool; // Todos os alarmes saem da mesma thread de interrupções
+}
+
+alarm_id_t alarm_pool_add_alarm_in_us(alarm_pool_t *pool, uint64_t us, alarm_callback_t callback,
+                                      void *user_data, bool fire_if_past) {
+    (void)pool, (void)fire_if_past;
+    uint32_t irq = save_and_disable_interrupts();
+    struct alarm *a = NULL;
+    for (int i = 0; i < HOST_IRQ_EVENTS && !a; i++) {
+        if (!alarms[i].id) {
+            a = &alarms[i];
+        }
+    }
+    alarm_id_t id = -1;
+    if (a) {
+        id = next_alarm_id;
+        next_alarm_id = next_alarm_id == INT32_MAX ? 1 : next_alarm_id + 1;
+        *a = (struct alarm){.id = id, .at_us = time_us_64() + us, .callback = callback, .user_data = user_data};
+        host_irq_post(a->at_us, fire_alarm, a, a);
+    }
+    restore_interrupts(irq);
+    return id;
+}
+
+bool alarm_pool_cancel_alarm(alarm_pool_t *pool, alarm_id_t alarm_id) {
+    (void)pool;
+    bool found = false;
+    uint32_t irq = save_and_disable_interrupts();
+    for (int i = 0; i < HOST_IRQ_EVENTS; i++) {
+        if (alarm_id > 0 && alarms[i].id == alarm_id) {
+            alarms[i].id = 0;
+            host_irq_cancel(&alarms[i]);
+            found = true;
+        }
+    }
+    restore_interrupts(irq);
+    return found;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return alarm_pool_add_alarm_in_us(&default_pool, us, callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_in_us(ms * 1000ull, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id) {
+    return alarm_pool_cancel_alarm(&default_pool, alarm_id);
+}
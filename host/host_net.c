@@ -0,0 +1,670 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#undef TCP_MSS // O de <netinet/tcp.h>; vale o de lwipopts.h
+#include "pico/cyw43_arch.h"
+#include "lwip/apps/fs.h"
+#include "lwip/apps/sntp.h"
+#include "lwip/tcp.h"
+#include "lwip/stats.h"
+#include "host.h"
+
+// API "raw" de TCP do lwIP sobre sockets do PC, só em 127.0.0.1. Cada
+// tcp_pcb é um socket não bloqueante e os callbacks são chamados pela
+// thread do núcleo 0 (host_async.c), com as mesmas regras do lwIP:
+//   - MEMP_NUM_TCP_PCB conexões; sem pcb livre o pedido de conexão fica na
+//     fila do kernel, como um SYN descartado que o cliente repete;
+//   - tcp_write só copia para o buffer de envio (TCP_SND_BUF bytes,
+//     TCP_SND_QUEUELEN segmentos); o envio sai quando o socket aceita e
+//     tcp_sent devolve o espaço, nunca de dentro de tcp_write/tcp_output;
+//   - até TCP_WND bytes entregues em tcp_recv sem tcp_recved: depois disso
+//     o socket não é lido, e o kernel segura o cliente;
+//   - dados recusados pelo callback (erro diferente de ERR_ABRT) voltam na
+//     próxima passada; pcb abortado dentro de um callback devolve ERR_ABRT;
+//   - tcp_poll a cada intervalo * 500 ms do relógio virtual.
+// Os dados recebidos são entregues em pbufs de até ESTACAO_HOST_PBUF bytes
+// (padrão TCP_MSS), para exercitar pedidos quebrados entre segmentos.
+// lwip_stats acompanha os pcbs, os pbufs recebidos (MEMP_PBUF_POOL), os
+// buffers de envio (heap e MEMP_TCP_SEG) e os segmentos de TCP.
+
+#define HOST_NET_RX_CHUNK 4096
+#define TCP_SLOW_INTERVAL_US 500000u
+
+struct host_pcb {
+    struct tcp_pcb pcb;      // Primeiro: a aplicação só vê este
+    bool used;
+    bool listening;
+    bool closing;            // tcp_close: sem callbacks, fecha após o envio
+    bool shut_tx;            // FIN depois do envio pendente
+    bool fin_sent;
+    bool fin_received;
+    int fd;
+    u16_t port;
+    uint32_t generation;     // Muda a cada liberação: detecta pcb abortado
+    void *arg;
+    tcp_accept_fn accept;
+    tcp_recv_fn recv;
+    tcp_sent_fn sent;
+    tcp_err_fn err;
+    tcp_poll_fn poll;
+    u8_t poll_interval;
+    uint64_t next_poll_us;
+    u32_t unacked_window;    // Entregue em tcp_recv e ainda sem tcp_recved
+    struct pbuf *refused;
+    u8_t tx[TCP_SND_BUF];
+    u32_t tx_len;
+};
+
+const ip_addr_t ip_addr_any = {0};
+cyw43_t cyw43_state;
+
+static struct host_pcb pcbs[MEMP_NUM_TCP_PCB];
+static struct host_pcb listeners[MEMP_NUM_TCP_PCB_LISTEN];
+
+static struct stats_mem memp_stats[MEMP_MAX] = {
+    [MEMP_TCP_PCB] = {.avail = MEMP_NUM_TCP_PCB},
+    [MEMP_TCP_PCB_LISTEN] = {.avail = MEMP_NUM_TCP_PCB_LISTEN},
+    [MEMP_TCP_SEG] = {.avail = MEMP_NUM_TCP_SEG},
+    [MEMP_PBUF_POOL] = {.avail = PBUF_POOL_SIZE},
+};
+
+struct stats_ lwip_stats = {
+    .mem = {.avail = MEM_SIZE},
+    .memp = {&memp_stats[0], &memp_stats[1], &memp_stats[2], &memp_stats[3], &memp_stats[4]},
+};
+
+static void stats_take(struct stats_mem *m, mem_size_t n) {
+    m->used += n;
+    if (m->used > m->max) {
+        m->max = m->used;
+    }
+}
+
+static void stats_give(struct stats_mem *m, mem_size_t n) {
+    m->used -= LWIP_MIN(n, m->used);
+}
+
+static struct stats_mem *pool_stats(const struct host_pcb *pool) {
+    return lwip_stats.memp[pool == pcbs ? MEMP_TCP_PCB : MEMP_TCP_PCB_LISTEN];
+}
+
+static struct host_pcb *host_pcb_of(struct tcp_pcb *pcb) {
+    return (struct host_pcb *)pcb;
+}
+
+static struct host_pcb *alloc_from(struct host_pcb *pool, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (!pool[i].used) {
+            uint32_t generation = pool[i].generation;
+            pool[i] = (struct host_pcb){.used = true, .fd = -1, .generation = generation};
+            pool[i].pcb.snd_buf = TCP_SND_BUF;
+            stats_take(pool_stats(pool), 1);
+            return &pool[i];
+        }
+    }
+    pool_stats(pool)->err++;
+    return NULL;
+}
+
+static u16_t segments(u32_t bytes) {
+    return (u16_t)((bytes + TCP_MSS - 1) / TCP_MSS);
+}
+
+// Buffer de envio de old_len para tx_len bytes: heap e segmentos
+static void tx_account(struct host_pcb *h, u32_t old_len) {
+    if (h->tx_len > old_len) {
+        stats_take(&lwip_stats.mem, h->tx_len - old_len);
+        stats_take(lwip_stats.memp[MEMP_TCP_SEG], (mem_size_t)(segments(h->tx_len) - segments(old_len)));
+    } else {
+        stats_give(&lwip_stats.mem, old_len - h->tx_len);
+        stats_give(lwip_stats.memp[MEMP_TCP_SEG], (mem_size_t)(segments(old_len) - segments(h->tx_len)));
+    }
+}
+
+static void release(struct host_pcb *h) {
+    if (h->fd >= 0) {
+        close(h->fd);
+    }
+    if (h->refused) {
+        pbuf_free(h->refused);
+    }
+    u32_t tx_len = h->tx_len;
+    h->tx_len = 0;
+    tx_account(h, tx_len);
+    stats_give(pool_stats(h->listening ? listeners : pcbs), 1);
+    h->used = false;
+    h->fd = -1;
+    h->refused = NULL;
+    h->generation++;
+}
+
+// pbufs: um bloco por pbuf, payload logo depois da estrutura
+
+static u16_t pbuf_max_len(void) {
+    static u16_t max_len;
+    if (!max_len) {
+        const char *s = getenv("ESTACAO_HOST_PBUF");
+        int n = s ? atoi(s) : 0;
+        max_len = n > 0 && n <= 0xFFFF ? (u16_t)n : TCP_MSS;
+    }
+    return max_len;
+}
+
+static struct pbuf *pbuf_chain(const u8_t *data, size_t len) {
+    struct pbuf *head = NULL, **tail = &head;
+    size_t step = pbuf_max_len();
+    for (size_t off = 0; off < len; off += step) {
+        u16_t n = (u16_t)(len - off < step ? len - off : step);
+        struct pbuf *p = malloc(sizeof(*p) + n);
+        if (!p) {
+            fprintf(stderr, "[host] sem memória para pbuf\n");
+            abort();
+        }
+        *p = (struct pbuf){.payload = p + 1, .len = n, .ref = 1};
+        stats_take(lwip_stats.memp[MEMP_PBUF_POOL], 1);
+        memcpy(p->payload, &data[off], n);
+        *tail = p;
+        tail = &p->next;
+    }
+    u16_t tot = (u16_t)len;
+    for (struct pbuf *p = head; p; p = p->next) {
+        p->tot_len = tot;
+        tot = (u16_t)(tot - p->len);
+    }
+    return head;
+}
+
+u8_t pbuf_free(struct pbuf *p) {
+    u8_t count = 0;
+    while (p && --p->ref == 0) {
+        struct pbuf *next = p->next;
+        free(p);
+        stats_give(lwip_stats.memp[MEMP_PBUF_POOL], 1);
+        count++;
+        p = next;
+    }
+    return count;
+}
+
+void pbuf_ref(struct pbuf *p) {
+    if (p) {
+        p->ref++;
+    }
+}
+
+void pbuf_cat(struct pbuf *head, struct pbuf *tail) {
+    struct pbuf *p = head;
+    for (; p->next; p = p->next) {
+        p->tot_len = (u16_t)(p->tot_len + tail->tot_len);
+    }
+    p->tot_len = (u16_t)(p->tot_len + tail->tot_len);
+    p->next = tail;
+}
+
+struct pbuf *pbuf_free_header(struct pbuf *q, u16_t size) {
+    struct pbuf *p = q;
+    u16_t left = size;
+    while (left && p && left >= p->len) {
+        struct pbuf *whole = p;
+        left = (u16_t)(left - p->len);
+        p = p->next;
+        whole->next = NULL;
+        pbuf_free(whole);
+    }
+    if (left && p) {
+        p->payload = (u8_t *)p->payload + left;
+        p->len = (u16_t)(p->len - left);
+        p->tot_len = (u16_t)(p->tot_len - left);
+    }
+    return p;
+}
+
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset) {
+    u16_t copied = 0;
+    for (; p && copied < len; p = p->next) {
+        if (offset >= p->len) {
+            offset = (u16_t)(offset - p->len);
+            continue;
+        }
+        u16_t n = (u16_t)LWIP_MIN((u16_t)(p->len - offset), (u16_t)(len - copied));
+        memcpy((u8_t *)dataptr + copied, (const u8_t *)p->payload + offset, n);
+        copied = (u16_t)(copied + n);
+        offset = 0;
+    }
+    return copied;
+}
+
+u8_t pbuf_get_at(const struct pbuf *p, u16_t offset) {
+    for (; p; p = p->next) {
+        if (offset < p->len) {
+            return ((const u8_t *)p->payload)[offset];
+        }
+        offset = (u16_t)(offset - p->len);
+    }
+    return 0;
+}
+
+// API de TCP
+
+struct tcp_pcb *tcp_new(void) {
+    struct host_pcb *h = alloc_from(pcbs, MEMP_NUM_TCP_PCB);
+    return h ? &h->pcb : NULL;
+}
+
+// A porta 80 da placa vira ESTACAO_HOST_PORT (padrão 8080), sem root
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port) {
+    (void)ipaddr;
+    const char *s = getenv("ESTACAO_HOST_PORT");
+    host_pcb_of(pcb)->port = port == 80 ? (u16_t)(s ? atoi(s) : 8080) : port;
+    return ERR_OK;
+}
+
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb) {
+    struct host_pcb *h = host_pcb_of(pcb);
+    struct host_pcb *l = alloc_from(listeners, MEMP_NUM_TCP_PCB_LISTEN);
+    if (!l) {
+        return NULL;
+    }
+    l->listening = true;
+    l->port = h->port;
+    l->arg = h->arg;
+    release(h);
+
+    int one = 1;
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(l->port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    l->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (l->fd < 0 || setsockopt(l->fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0 ||
+        bind(l->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(l->fd, 16) < 0) {
+        fprintf(stderr, "[host] porta %u: %s\n", l->port, strerror(errno));
+        exit(1);
+    }
+    fprintf(stderr, "[host] http://127.0.0.1:%u/\n", l->port);
+    return &l->pcb;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg) {
+    host_pcb_of(pcb)->arg = arg;
+}
+
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept) {
+    host_pcb_of(pcb)->accept = accept;
+}
+
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv) {
+    host_pcb_of(pcb)->recv = recv;
+}
+
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent) {
+    host_pcb_of(pcb)->sent = sent;
+}
+
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err) {
+    host_pcb_of(pcb)->err = err;
+}
+
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval) {
+    struct host_pcb *h = host_pcb_of(pcb);
+    h->poll = poll;
+    h->poll_interval = interval;
+    h->next_poll_us = time_us_64() + interval * (uint64_t)TCP_SLOW_INTERVAL_US;
+}
+
+void tcp_recved(struct tcp_pcb *pcb, u16_t len) {
+    struct host_pcb *h = host_pcb_of(pcb);
+    h->unacked_window -= LWIP_MIN(len, h->unacked_window);
+}
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags) {
+    (void)apiflags; // Sempre copia: o buffer de envio é do pcb
+    struct host_pcb *h = host_pcb_of(pcb);
+    if (h->closing || h->shut_tx) {
+        return ERR_CONN;
+    }
+    if (len > pcb->snd_buf || segments(h->tx_len + len) > TCP_SND_QUEUELEN) {
+        lwip_stats.tcp.memerr++;
+        return ERR_MEM;
+    }
+    memcpy(&h->tx[h->tx_len], dataptr, len);
+    h->tx_len += len;
+    tx_account(h, h->tx_len - len);
+    pcb->snd_buf -= len;
+    pcb->snd_queuelen = segments(h->tx_len);
+    return ERR_OK;
+}
+
+err_t tcp_output(struct tcp_pcb *pcb) {
+    (void)pcb; // O envio sai em host_net_process, quando o socket aceitar
+    return ERR_OK;
+}
+
+err_t tcp_shutdown(struct tcp_pcb *pcb, int shut_rx, int shut_tx) {
+    if (shut_rx && shut_tx) {
+        return tcp_close(pcb);
+    }
+    if (shut_tx) {
+        host_pcb_of(pcb)->shut_tx = true;
+    }
+    return ERR_OK;
+}
+
+err_t tcp_close(struct tcp_pcb *pcb) {
+    struct host_pcb *h = host_pcb_of(pcb);
+    if (h->listening || h->fd < 0) {
+        release(h);
+        return ERR_OK;
+    }
+    h->closing = true;
+    h->shut_tx = true;
+    return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb) {
+    struct host_pcb *h = host_pcb_of(pcb);
+    tcp_err_fn err = h->err;
+    void *arg = h->arg;
+    if (h->fd >= 0) {
+        struct linger reset = {.l_onoff = 1, .l_linger = 0}; // RST em vez de FIN
+        setsockopt(h->fd, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+    }
+    release(h);
+    if (err) {
+        err(arg, ERR_ABRT);
+    }
+}
+
+void tcp_nagle_disable(struct tcp_pcb *pcb) {
+    int one = 1;
+    setsockopt(host_pcb_of(pcb)->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+void tcp_setprio(struct tcp_pcb *pcb, u8_t prio) {
+    (void)pcb, (void)prio;
+}
+
+// Laço de rede (núcleo 0)
+
+// Erro do socket: o pcb some e a aplicação é avisada, como um RST no lwIP
+static void connection_failed(struct host_pcb *h, err_t reason) {
+    tcp_err_fn err = h->closing ? NULL : h->err;
+    void *arg = h->arg;
+    release(h);
+    if (err) {
+        err(arg, reason);
+    }
+}
+
+static bool rx_open(const struct host_pcb *h) {
+    return !h->fin_received && !h->refused && h->unacked_window < TCP_WND;
+}
+
+int host_net_pollfds(struct pollfd *fds, int max) {
+    int count = 0;
+    bool pcb_free = false;
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+        pcb_free |= !pcbs[i].used;
+    }
+    for (int i = 0; i < MEMP_NUM_TCP_PCB_LISTEN && count < max; i++) {
+        if (listeners[i].used && pcb_free) {
+            fds[count++] = (struct pollfd){.fd = listeners[i].fd, .events = POLLIN};
+        }
+    }
+    for (int i = 0; i < MEMP_NUM_TCP_PCB && count < max; i++) {
+        struct host_pcb *h = &pcbs[i];
+        if (h->used && h->fd >= 0) {
+            short events = (short)((rx_open(h) || h->closing ? POLLIN : 0) | (h->tx_len ? POLLOUT : 0));
+            fds[count++] = (struct pollfd){.fd = h->fd, .events = events};
+        }
+    }
+    return count;
+}
+
+uint64_t host_net_next_timer_us(void) {
+    uint64_t next = UINT64_MAX;
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+        struct host_pcb *h = &pcbs[i];
+        if (!h->used) {
+            continue;
+        }
+        if (h->refused || (h->closing && !h->tx_len) || (h->shut_tx && !h->fin_sent && !h->tx_len)) {
+            return 0; // Trabalho que não depende do socket
+        }
+        if (h->poll && !h->closing) {
+            next = MIN(next, h->next_poll_us);
+        }
+    }
+    return next;
+}
+
+static void accept_connections(struct host_pcb *l) {
+    for (;;) {
+        struct host_pcb *h = alloc_from(pcbs, MEMP_NUM_TCP_PCB);
+        if (!h) {
+            return; // O resto espera na fila do kernel
+        }
+        h->fd = accept4(l->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (h->fd < 0) {
+            release(h);
+            return;
+        }
+        h->port = l->port;
+        h->arg = l->arg;
+        if (!l->accept || l->accept(l->arg, &h->pcb, ERR_OK) != ERR_OK) {
+            if (h->used) {
+                tcp_abort(&h->pcb);
+            }
+        }
+    }
+}
+
+// Entrega à aplicação; false se o pcb deixou de existir no callback
+static bool deliver(struct host_pcb *h, struct pbuf *p) {
+    uint32_t generation = h->generation;
+    err_t err;
+    if (h->recv) {
+        err = h->recv(h->arg, &h->pcb, p, ERR_OK);
+    } else if (p) { // tcp_recv_null do lwIP
+        tcp_recved(&h->pcb, p->tot_len);
+        pbuf_free(p);
+        err = ERR_OK;
+    } else {
+        err = tcp_close(&h->pcb);
+    }
+    if (err == ERR_ABRT || h->generation != generation) {
+        return false;
+    }
+    if (err != ERR_OK && p) {
+        h->refused = p; // Mesmo pbuf na próxima passada
+        h->unacked_window -= LWIP_MIN(p->tot_len, h->unacked_window);
+    }
+    return true;
+}
+
+static bool receive(struct host_pcb *h) {
+    if (h->refused) {
+        struct pbuf *p = h->refused;
+        h->refused = NULL;
+        h->unacked_window += p->tot_len;
+        if (!deliver(h, p) || h->refused) {
+            return h->used;
+        }
+    }
+    if (!rx_open(h)) {
+        return true;
+    }
+    u8_t buf[HOST_NET_RX_CHUNK];
+    size_t room = LWIP_MIN(sizeof(buf), (size_t)(TCP_WND - h->unacked_window));
+    ssize_t n = recv(h->fd, buf, room, 0);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            connection_failed(h, ERR_RST);
+            return false;
+        }
+        return true;
+    }
+    if (n == 0) {
+        h->fin_received = true;
+        return deliver(h, NULL);
+    }
+    h->unacked_window += (u32_t)n;
+    lwip_stats.tcp.recv += segments((u32_t)n);
+    return deliver(h, pbuf_chain(buf, (size_t)n));
+}
+
+static bool transmit(struct host_pcb *h) {
+    if (h->tx_len) {
+        ssize_t n = send(h->fd, h->tx, h->tx_len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                connection_failed(h, ERR_RST);
+                return false;
+            }
+            return true;
+        }
+        memmove(h->tx, &h->tx[n], h->tx_len - (u32_t)n);
+        h->tx_len -= (u32_t)n;
+        tx_account(h, h->tx_len + (u32_t)n);
+        lwip_stats.tcp.xmit += segments((u32_t)n);
+        h->pcb.snd_buf += (u32_t)n;
+        h->pcb.snd_queuelen = segments(h->tx_len);
+        if (h->sent && !h->closing) {
+            uint32_t generation = h->generation;
+            if (h->sent(h->arg, &h->pcb, (u16_t)n) == ERR_ABRT || h->generation != generation) {
+                return false;
+            }
+        }
+    }
+    if (h->shut_tx && !h->fin_sent && !h->tx_len) {
+        shutdown(h->fd, SHUT_WR);
+        h->fin_sent = true;
+    }
+    return true;
+}
+
+// Depois do FIN, descarta o que o cliente ainda mandar e fecha: close() com
+// dados não lidos mandaria RST
+static void finish_close(struct host_pcb *h) {
+    if (h->tx_len) {
+        return;
+    }
+    u8_t discard[512];
+    while (recv(h->fd, discard, sizeof(discard), 0) > 0) {
+    }
+    release(h);
+}
+
+void host_net_process(const struct pollfd *fds, int count) {
+    for (int i = 0; i < count; i++) {
+        for (int k = 0; k < MEMP_NUM_TCP_PCB_LISTEN; k++) {
+            if (listeners[k].used && listeners[k].fd == fds[i].fd && (fds[i].revents & POLLIN)) {
+                accept_connections(&listeners[k]);
+            }
+        }
+    }
+
+    uint64_t now = time_us_64();
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++) {
+        struct host_pcb *h = &pcbs[i];
+        if (!h->used || h->fd < 0) {
+            continue;
+        }
+        short revents = 0;
+        for (int k = 0; k < count; k++) {
+            if (fds[k].fd == h->fd) {
+                revents = fds[k].revents;
+            }
+        }
+        if ((revents & POLLERR) && !h->closing) {
+            connection_failed(h, ERR_RST);
+            continue;
+        }
+        if (!transmit(h)) {
+            continue;
+        }
+        if (h->closing) {
+            finish_close(h);
+            continue;
+        }
+        if ((h->refused || (revents & (POLLIN | POLLHUP))) && !receive(h)) {
+            continue;
+        }
+        if (h->used && !h->closing && h->poll && now >= h->next_poll_us) {
+            h->next_poll_us = now + h->poll_interval * (uint64_t)TCP_SLOW_INTERVAL_US;
+            uint32_t generation = h->generation;
+            if (h->poll(h->arg, &h->pcb) == ERR_ABRT || h->generation != generation) {
+                continue;
+            }
+        }
+        if (h->used && h->tx_len) {
+            transmit(h); // O que os callbacks acabaram de escrever
+        }
+    }
+}
+
+// fs do httpd: a imagem gerada de web/ (cmake/web_fsdata.cmake)
+#include "fsdata_web.c"
+
+err_t fs_open(struct fs_file *file, const char *name) {
+    for (const struct fsdata_file *f = FS_ROOT; f; f = f->next) {
+        if (strcmp(name, (const char *)f->name) == 0) {
+            file->data = (const char *)f->data;
+            file->len = f->len;
+            file->index = f->len;
+            file->flags = f->flags;
+            return ERR_OK;
+        }
+    }
+    return ERR_VAL;
+}
+
+void fs_close(struct fs_file *file) {
+    (void)file;
+}
+
+// Wi-Fi: a "rede" é o loopback, já conectado
+int cyw43_arch_init(void) {
+    cyw43_state.netif[0].ip_addr.addr = htonl(INADDR_LOOPBACK);
+    return 0;
+}
+
+void cyw43_arch_deinit(void) {
+}
+
+void cyw43_arch_enable_sta_mode(void) {
+}
+
+int cyw43_arch_wifi_connect_timeout_ms(const char *ssid, const char *pw, uint32_t auth, uint32_t timeout) {
+    (void)pw, (void)auth, (void)timeout;
+    fprintf(stderr, "[host] Wi-Fi simulado: \"%s\" conectado\n", ssid);
+    return 0;
+}
+
+void cyw43_arch_poll(void) {
+}
+
+// SNTP: a primeira "resposta" é o relógio do PC
+void sntp_setoperatingmode(u8_t operating_mode) {
+    (void)operating_mode;
+}
+
+void sntp_setservername(u8_t idx, const char *server) {
+    (void)idx, (void)server;
+}
+
+void sntp_init(void) {
+    SNTP_SET_SYSTEM_TIME((u32_t)time(NULL));
+}
+
+void sntp_stop(void) {
+}
@@ -0,0 +1,336 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "sensores/compensation.h"
+#include "host.h"
+
+// Dispositivos nos barramentos simulados: BMP280 (0x76/0x77), AHT20 (0x38)
+// e, se algum sensor estiver atrás dele, o multiplexador TCA9548A (0x70).
+//
+// ESTACAO_HOST_SENSORS lista os sensores como barramento:endereço[@canal],
+// endereço em hexadecimal; o padrão é a placa: "0:76,1:38". Por exemplo,
+// "0:76,0:77,1:38,1:38@0,1:38@1" põe dois AHT20 atrás do mux no i2c1.
+//
+// As grandezas vêm de ESTACAO_HOST_SCENARIO, um arquivo com linhas
+//   <segundos> <temperatura °C> <umidade %> <pressão Pa>
+// em ordem de tempo (virtual), interpoladas linearmente entre as linhas e
+// mantidas depois da última; '#' começa um comentário. Sem roteiro, 25 °C,
+// 50 % e 101325 Pa. Cada sensor devolve os valores brutos que a compensação
+// do firmware transforma de volta nessas grandezas.
+
+#define MAX_DEVICES        16
+#define MAX_SCENARIO_STEPS 256
+
+#define TCA9548A_ADDR 0x70
+
+#define AHT20_CONVERSION_US 75000u
+#define BMP280_RESET_RAW    0x80000  // Valor dos registradores de dados sem conversão
+
+enum device_kind { DEV_BMP280, DEV_AHT20 };
+
+struct device {
+    enum device_kind kind;
+    unsigned bus;
+    uint8_t addr;
+    int mux_channel;         // -1: ligado direto no barramento
+    // BMP280
+    uint8_t reg;             // Ponteiro de registrador
+    uint8_t ctrl_meas;
+    uint8_t config;
+    uint64_t conversion_end_us;
+    int32_t raw_temp;
+    int32_t raw_pressure;
+    // AHT20
+    bool calibrated;
+    uint64_t trigger_us;     // 0: nenhuma medida pedida
+};
+
+struct scenario_step {
+    double t_s;
+    double temp_c;
+    double humidity;
+    double pressure_pa;
+};
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+static struct device devices[MAX_DEVICES];
+static size_t device_count;
+static bool has_mux;
+static uint8_t mux_mask[2];
+
+static struct scenario_step steps[MAX_SCENARIO_STEPS] = {{0, 25.0, 50.0, 101325.0}};
+static size_t step_count = 1;
+
+// Calibração de um BMP280 real (registradores 0x88..0x9F)
+static const uint8_t bmp280_calib[24] = {
+    0x70, 0x6b, 0x43, 0x67, 0x18, 0xfc, 0x7d, 0x8e, 0x43, 0xd6, 0xd0, 0x0b,
+    0x27, 0x0b, 0x8c, 0x00, 0xf9, 0xff, 0x8c, 0x3c, 0xf8, 0xc6, 0x70, 0x17,
+};
+static struct bmp280_calib_param calib;
+
+static void load_devices(void) {
+    const char *cfg = getenv("ESTACAO_HOST_SENSORS");
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", cfg ? cfg : "0:76,1:38");
+    for (char *save, *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        unsigned bus, addr;
+        int channel = -1;
+        if (sscanf(tok, "%u:%x@%d", &bus, &addr, &channel) < 2 || bus > 1 || channel > 7 ||
+            (addr != 0x38 && addr != 0x76 && addr != 0x77)) {
+            fprintf(stderr, "[host] sensor inválido em ESTACAO_HOST_SENSORS: %s\n", tok);
+            exit(1);
+        }
+        if (device_count == MAX_DEVICES) {
+            break;
+        }
+        devices[device_count++] = (struct device){
+            .kind = addr == 0x38 ? DEV_AHT20 : DEV_BMP280,
+            .bus = bus,
+            .addr = (uint8_t)addr,
+            .mux_channel = channel,
+            .raw_temp = BMP280_RESET_RAW,
+            .raw_pressure = BMP280_RESET_RAW,
+        };
+        has_mux |= channel >= 0;
+    }
+}
+
+static void load_scenario(void) {
+    const char *path = getenv("ESTACAO_HOST_SCENARIO");
+    if (!path) {
+        return;
+    }
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    step_count = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f) && step_count < MAX_SCENARIO_STEPS) {
+        char *comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        struct scenario_step s;
+        if (sscanf(line, "%lf %lf %lf %lf", &s.t_s, &s.temp_c, &s.humidity, &s.pressure_pa) == 4) {
+            steps[step_count++] = s;
+        }
+    }
+    fclose(f);
+    if (!step_count) {
+        fprintf(stderr, "[host] roteiro vazio: %s\n", path);
+        exit(1);
+    }
+}
+
+static void sensors_init(void) {
+    load_devices();
+    load_scenario();
+    const uint8_t *c = bmp280_calib;
+    calib.dig_t1 = (uint16_t)(c[1] << 8 | c[0]);
+    calib.dig_t2 = (int16_t)(c[3] << 8 | c[2]);
+    calib.dig_t3 = (int16_t)(c[5] << 8 | c[4]);
+    calib.dig_p1 = (uint16_t)(c[7] << 8 | c[6]);
+    calib.dig_p2 = (int16_t)(c[9] << 8 | c[8]);
+    calib.dig_p3 = (int16_t)(c[11] << 8 | c[10]);
+    calib.dig_p4 = (int16_t)(c[13] << 8 | c[12]);
+    calib.dig_p5 = (int16_t)(c[15] << 8 | c[14]);
+    calib.dig_p6 = (int16_t)(c[17] << 8 | c[16]);
+    calib.dig_p7 = (int16_t)(c[19] << 8 | c[18]);
+    calib.dig_p8 = (int16_t)(c[21] << 8 | c[20]);
+    calib.dig_p9 = (int16_t)(c[23] << 8 | c[22]);
+}
+
+// Grandezas do roteiro no instante (virtual) pedido
+static struct scenario_step scenario_at(uint64_t now_us) {
+    double t = now_us / 1e6;
+    if (t <= steps[0].t_s) {
+        return steps[0];
+    }
+    for (size_t i = 1; i < step_count; i++) {
+        const struct scenario_step *a = &steps[i - 1], *b = &steps[i];
+        if (t < b->t_s) {
+            double k = (t - a->t_s) / (b->t_s - a->t_s);
+            return (struct scenario_step){
+                t,
+                a->temp_c + k * (b->temp_c - a->temp_c),
+                a->humidity + k * (b->humidity - a->humidity),
+                a->pressure_pa + k * (b->pressure_pa - a->pressure_pa),
+            };
+        }
+    }
+    return steps[step_count - 1];
+}
+
+static int32_t clamp_raw(double v) {
+    return v < 0 ? 0 : v > 0xFFFFF ? 0xFFFFF : (int32_t)(v + 0.5);
+}
+
+// Inverte a compensação do BMP280 por busca binária: a temperatura cresce
+// com o valor bruto, a pressão cai
+static void bmp280_raw_for(const struct scenario_step *s, int32_t *raw_temp, int32_t *raw_pressure) {
+    int32_t want_temp = (int32_t)(s->temp_c * 100.0 + (s->temp_c < 0 ? -0.5 : 0.5));
+    int32_t lo = 0, hi = 0xFFFFF;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if ((bmp280_t_fine(mid, &calib) * 5 + 128) >> 8 < want_temp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *raw_temp = lo;
+
+    int32_t t_fine = bmp280_t_fine(lo, &calib);
+    uint32_t want_pressure = (uint32_t)(s->pressure_pa + 0.5);
+    lo = 0, hi = 0xFFFFF;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (bmp280_pressure_from_t_fine(mid, t_fine, &calib) > want_pressure) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    *raw_pressure = lo;
+}
+
+static bool reachable(const struct device *d, unsigned bus) {
+    return d->bus == bus && (d->mux_channel < 0 || (mux_mask[bus] >> d->mux_channel & 1));
+}
+
+static uint32_t bmp280_conversion_us(uint8_t ctrl_meas) {
+    uint8_t osrs_t = ctrl_meas >> 5 & 7, osrs_p = ctrl_meas >> 2 & 7;
+    return 1250u + (osrs_t ? 2300u << (osrs_t - 1) : 0) + (osrs_p ? 2300u << (osrs_p - 1) : 0) + 575u;
+}
+
+// Fim da conversão forçada e atualização contínua do modo normal
+static void bmp280_update(struct device *d, uint64_t now) {
+    uint8_t mode = d->ctrl_meas & 3;
+    if (mode == 3 || ((mode == 1 || mode == 2) && now >= d->conversion_end_us)) {
+        struct scenario_step s = scenario_at(mode == 3 ? now : d->conversion_end_us);
+        bmp280_raw_for(&s, &d->raw_temp, &d->raw_pressure);
+        if (mode != 3) {
+            d->ctrl_meas &= (uint8_t)~3; // Volta a dormir
+        }
+    }
+}
+
+static void bmp280_write(struct device *d, const uint8_t *data, size_t len) {
+    if (!len) {
+        return;
+    }
+    d->reg = data[0];
+    for (size_t i = 1; i < len; i++) {
+        uint8_t reg = (uint8_t)(data[0] + i - 1);
+        if (reg == 0xF4) {
+            d->ctrl_meas = data[i];
+            d->conversion_end_us = time_us_64() + bmp280_conversion_us(data[i]);
+        } else if (reg == 0xF5) {
+            d->config = data[i];
+        } else if (reg == 0xE0 && data[i] == 0xB6) {
+            d->ctrl_meas = d->config = 0;
+            d->raw_temp = d->raw_pressure = BMP280_RESET_RAW;
+        }
+    }
+}
+
+static void bmp280_read(struct device *d, uint8_t *out, size_t len) {
+    uint64_t now = time_us_64();
+    bmp280_update(d, now);
+    uint8_t regs[256] = {0};
+    memcpy(&regs[0x88], bmp280_calib, sizeof(bmp280_calib));
+    regs[0xD0] = 0x58;
+    uint8_t mode = d->ctrl_meas & 3;
+    regs[0xF3] = (mode == 1 || mode == 2) && now < d->conversion_end_us ? 0x08 : 0;
+    regs[0xF4] = d->ctrl_meas;
+    regs[0xF5] = d->config;
+    regs[0xF7] = (uint8_t)(d->raw_pressure >> 12);
+    regs[0xF8] = (uint8_t)(d->raw_pressure >> 4);
+    regs[0xF9] = (uint8_t)((d->raw_pressure & 0xF) << 4);
+    regs[0xFA] = (uint8_t)(d->raw_temp >> 12);
+    regs[0xFB] = (uint8_t)(d->raw_temp >> 4);
+    regs[0xFC] = (uint8_t)((d->raw_temp & 0xF) << 4);
+    for (size_t i = 0; i < len; i++) {
+        out[i] = regs[(uint8_t)(d->reg + i)];
+    }
+}
+
+static void aht20_write(struct device *d, const uint8_t *data, size_t len) {
+    if (!len) {
+        return;
+    }
+    if (data[0] == 0xBA) {
+        d->calibrated = false;
+        d->trigger_us = 0;
+    } else if (data[0] == 0xBE) {
+        d->calibrated = true;
+    } else if (data[0] == 0xAC) {
+        d->trigger_us = time_us_64();
+    }
+}
+
+static void aht20_read(struct device *d, uint8_t *out, size_t len) {
+    uint64_t now = time_us_64();
+    bool busy = d->trigger_us && now - d->trigger_us < AHT20_CONVERSION_US;
+    struct scenario_step s = scenario_at(d->trigger_us ? d->trigger_us + AHT20_CONVERSION_US : now);
+    // UR = raw / 2^20 * 100; T = raw / 2^20 * 200 - 50
+    int32_t raw_h = clamp_raw(s.humidity / 100.0 * 1048576.0);
+    int32_t raw_t = clamp_raw((s.temp_c + 50.0) / 200.0 * 1048576.0);
+    uint8_t frame[7] = {
+        (uint8_t)((busy ? 0x80 : 0) | (d->calibrated ? 0x08 : 0) | 0x10),
+        (uint8_t)(raw_h >> 12),
+        (uint8_t)(raw_h >> 4),
+        (uint8_t)((raw_h & 0xF) << 4 | raw_t >> 16),
+        (uint8_t)(raw_t >> 8),
+        (uint8_t)raw_t,
+        0, // CRC: o firmware não confere
+    };
+    memcpy(out, frame, len < sizeof(frame) ? len : sizeof(frame));
+}
+
+bool host_sensors_write(unsigned bus, uint8_t addr, const uint8_t *data, size_t len) {
+    pthread_once(&once, sensors_init);
+    pthread_mutex_lock(&lock);
+    bool ack = false;
+    if (has_mux && addr == TCA9548A_ADDR) {
+        if (len) {
+            mux_mask[bus] = data[len - 1];
+        }
+        ack = true;
+    }
+    for (size_t i = 0; i < device_count; i++) {
+        struct device *d = &devices[i];
+        if (d->addr == addr && reachable(d, bus)) {
+            d->kind == DEV_BMP280 ? bmp280_write(d, data, len) : aht20_write(d, data, len);
+            ack = true;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return ack;
+}
+
+bool host_sensors_read(unsigned bus, uint8_t addr, uint8_t *out, size_t len) {
+    pthread_once(&once, sensors_init);
+    pthread_mutex_lock(&lock);
+    bool ack = false;
+    if (has_mux && addr == TCA9548A_ADDR) {
+        memset(out, mux_mask[bus], len);
+        ack = true;
+    }
+    // Dois dispositivos iguais visíveis ao mesmo tempo: o último vence (no
+    // fio os bits se misturariam, o que o firmware também não distingue)
+    for (size_t i = 0; i < device_count; i++) {
+        struct device *d = &devices[i];
+        if (d->addr == addr && reachable(d, bus)) {
+            d->kind == DEV_BMP280 ? bmp280_read(d, out, len) : aht20_read(d, out, len);
+            ack = true;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return ack;
+}
@@ -0,0 +1,98 @@
+#define _GNU_SOURCE
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include "host.h"
+
+// Relógio virtual: time_us_64() = tempo real desde o início * speed. Com
+// ESTACAO_HOST_SPEED=10 uma rodada de sensores, um alarme ou um tcp_poll
+// acontecem 10 vezes mais cedo em tempo real, então um roteiro de uma hora
+// roda em 6 minutos. Tudo que espera (async_context, interrupções, sockets)
+// converte o prazo virtual com host_virtual_to_real_us.
+
+static uint64_t boot_real_us;
+static double speed = 1.0;
+static pthread_once_t clock_once = PTHREAD_ONCE_INIT;
+
+uint64_t host_real_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static void clock_init(void) {
+    boot_real_us = host_real_us();
+    const char *s = getenv("ESTACAO_HOST_SPEED");
+    if (s && atof(s) > 0) {
+        speed = atof(s);
+    }
+}
+
+uint64_t host_virtual_to_real_us(uint64_t virtual_us) {
+    pthread_once(&clock_once, clock_init);
+    return speed == 1.0 ? virtual_us : (uint64_t)ceil((double)virtual_us / speed);
+}
+
+uint64_t time_us_64(void) {
+    pthread_once(&clock_once, clock_init);
+    uint64_t real = host_real_us() - boot_real_us;
+    return speed == 1.0 ? real : (uint64_t)((double)real * speed);
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+absolute_time_t get_absolute_time(void) {
+    return from_us_since_boot(time_us_64());
+}
+
+void sleep_us(uint64_t us) {
+    uint64_t real = host_virtual_to_real_us(us);
+    struct timespec ts = {.tv_sec = (time_t)(real / 1000000u), .tv_nsec = (long)(real % 1000000u) * 1000};
+    while (nanosleep(&ts, &ts) != 0) {
+    }
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us(ms * 1000ull);
+}
+
+bool stdio_init_all(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0); // Linha a linha, como o USB CDC
+    return true;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    return clk_index == clk_ref ? 12000000u : 125000000u;
+}
+
+// Ciclos do SysTick a 125 MHz pelo relógio real: os benchmarks medem o PC,
+// não o RP2040, mas o código que os lê roda sem mudanças
+systick_hw_t *host_systick_hw(void) {
+    static systick_hw_t systick;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t cycles = (uint64_t)ts.tv_sec * 125000000u + (uint64_t)ts.tv_nsec / 8u;
+    systick.cvr = (uint32_t)~cycles & 0xFFFFFFu;
+    return &systick;
+}
+
+bool host_trace_enabled(const char *name) {
+    const char *p = getenv("ESTACAO_HOST_TRACE");
+    size_t len = strlen(name);
+    while (p && *p) {
+        size_t n = strcspn(p, ",");
+        if (n == len && strncmp(p, name, len) == 0) {
+            return true;
+        }
+        p += n + (p[n] == ',');
+    }
+    return false;
+}
@@ -0,0 +1,50 @@
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+// Controlador I2C simulado (host_i2c.c). Os sensores do outro lado são os
+// de host_sensors.c. As chamadas bloqueantes ocupam o tempo de barramento a
+// 400 kHz; as transações por DMA (lib/sensores/i2c_async.c) terminam pela
+// "interrupção" do I2C com os mesmos bits de status do RP2040.
+
+typedef struct {
+    volatile uint32_t enable;
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t status;
+    volatile uint32_t intr_stat;
+    volatile uint32_t intr_mask;
+    volatile uint32_t raw_intr_stat;
+    volatile uint32_t clr_intr;
+    volatile uint32_t clr_tx_abrt;
+    volatile uint32_t clr_stop_det;
+} i2c_hw_t;
+
+typedef struct i2c_inst i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+#define I2C_IC_DATA_CMD_CMD_BITS           0x00000100u
+#define I2C_IC_DATA_CMD_STOP_BITS          0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS       0x00000400u
+#define I2C_IC_STATUS_ACTIVITY_BITS        0x00000001u
+#define I2C_IC_INTR_STAT_R_TX_ABRT_BITS    0x00000040u
+#define I2C_IC_INTR_STAT_R_STOP_DET_BITS   0x00000200u
+#define I2C_IC_INTR_MASK_M_TX_ABRT_BITS    0x00000040u
+#define I2C_IC_INTR_MASK_M_STOP_DET_BITS   0x00000200u
+
+#define PICO_ERROR_GENERIC -1
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c);
+uint i2c_hw_index(i2c_inst_t *i2c);
+i2c_inst_t *i2c_get_instance(uint num);
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx);
+
+#endif // HOST_HARDWARE_I2C_H
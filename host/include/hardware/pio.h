@@ -0,0 +1,23 @@
+#ifndef HOST_HARDWARE_PIO_H
+#define HOST_HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+// PIO simulado (host_gpio.c): só guarda as palavras enviadas à máquina de
+// estados; a matriz de LEDs aparece no trace "gpio" a cada quadro completo
+typedef struct pio_hw pio_hw_t;
+typedef pio_hw_t *PIO;
+
+extern PIO const pio0;
+extern PIO const pio1;
+
+typedef struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+uint pio_add_program(PIO pio, const pio_program_t *program);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+
+#endif // HOST_HARDWARE_PIO_H
@@ -0,0 +1,18 @@
+#ifndef HOST_HARDWARE_STRUCTS_SYSTICK_H
+#define HOST_HARDWARE_STRUCTS_SYSTICK_H
+
+#include <stdint.h>
+
+// SysTick lido pelos benchmarks (lib/bench/bench_cycles.h): cvr conta para
+// baixo a 125 MHz, pelo relógio real, em 24 bits (host_time.c)
+typedef struct {
+    volatile uint32_t csr;
+    volatile uint32_t rvr;
+    volatile uint32_t cvr;
+    const volatile uint32_t calib;
+} systick_hw_t;
+
+systick_hw_t *host_systick_hw(void);
+#define systick_hw (host_systick_hw())
+
+#endif // HOST_HARDWARE_STRUCTS_SYSTICK_H
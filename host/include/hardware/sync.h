@@ -0,0 +1,14 @@
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+// "Interrupções" são a thread de host_irq.c; desligá-las é segurar a trava
+// que ela segura ao executar um handler (recursiva, como no RP2040)
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+#define __dmb() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __compiler_memory_barrier() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+
+#endif // HOST_HARDWARE_SYNC_H
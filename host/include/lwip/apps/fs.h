@@ -0,0 +1,32 @@
+#ifndef HOST_LWIP_APPS_FS_H
+#define HOST_LWIP_APPS_FS_H
+
+#include "lwip/arch.h"
+#include "lwip/err.h"
+
+// fs do httpd do lwIP sobre a imagem gerada em build (fsdata_web.c), como o
+// fs.c do lwIP com HTTPD_FSDATA_FILE (host_net.c)
+
+#define FS_FILE_FLAGS_HEADER_INCLUDED    0x01
+#define FS_FILE_FLAGS_HEADER_PERSISTENT  0x02
+#define FS_FILE_FLAGS_HEADER_HTTPVER_1_1 0x04
+
+struct fsdata_file {
+    const struct fsdata_file *next;
+    const unsigned char *name;
+    const unsigned char *data;
+    int len;
+    u8_t flags;
+};
+
+struct fs_file {
+    const char *data;
+    int len;
+    int index;
+    u8_t flags;
+};
+
+err_t fs_open(struct fs_file *file, const char *name);
+void fs_close(struct fs_file *file);
+
+#endif // HOST_LWIP_APPS_FS_H
@@ -0,0 +1,15 @@
+#ifndef HOST_LWIP_APPS_SNTP_H
+#define HOST_LWIP_APPS_SNTP_H
+
+#include "lwip/arch.h"
+
+// O "servidor" é o relógio do PC: sntp_init acerta o horário na hora por
+// SNTP_SET_SYSTEM_TIME (lib/lwipopts.h), como a primeira resposta do SNTP
+#define SNTP_OPMODE_POLL 0
+
+void sntp_setoperatingmode(u8_t operating_mode);
+void sntp_setservername(u8_t idx, const char *server);
+void sntp_init(void);
+void sntp_stop(void);
+
+#endif // HOST_LWIP_APPS_SNTP_H
@@ -0,0 +1,18 @@
+#ifndef HOST_LWIP_ARCH_H
+#define HOST_LWIP_ARCH_H
+
+// Substituto do lwIP para o build no PC (host_net.c): só os tipos e a API
+// "raw" de TCP que lib/http usa, com as opções de lib/lwipopts.h
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t u8_t;
+typedef int8_t s8_t;
+typedef uint16_t u16_t;
+typedef int16_t s16_t;
+typedef uint32_t u32_t;
+typedef int32_t s32_t;
+typedef uintptr_t mem_ptr_t;
+
+#endif // HOST_LWIP_ARCH_H
@@ -0,0 +1,11 @@
+#ifndef HOST_LWIP_DEF_H
+#define HOST_LWIP_DEF_H
+
+#include "lwip/arch.h"
+
+#define LWIP_MIN(x, y) (((x) < (y)) ? (x) : (y))
+#define LWIP_MAX(x, y) (((x) > (y)) ? (x) : (y))
+#define LWIP_ARRAYSIZE(x) (sizeof(x) / sizeof((x)[0]))
+#define LWIP_UNUSED_ARG(x) (void)x
+
+#endif // HOST_LWIP_DEF_H
@@ -0,0 +1,14 @@
+#ifndef HOST_LWIP_IP_ADDR_H
+#define HOST_LWIP_IP_ADDR_H
+
+#include "lwip/arch.h"
+
+// Só IPv4, em ordem de rede como no lwIP
+typedef struct ip4_addr {
+    u32_t addr;
+} ip_addr_t;
+
+extern const ip_addr_t ip_addr_any;
+#define IP_ADDR_ANY (&ip_addr_any)
+
+#endif // HOST_LWIP_IP_ADDR_H
@@ -0,0 +1,24 @@
+#ifndef HOST_LWIP_PBUF_H
+#define HOST_LWIP_PBUF_H
+
+#include "lwip/arch.h"
+#include "lwip/err.h"
+
+// Cadeia de buffers recebidos. host_net.c entrega cada leitura do socket em
+// pbufs de até ESTACAO_HOST_PBUF bytes (padrão TCP_MSS), como segmentos.
+struct pbuf {
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len;
+    u16_t len;
+    u16_t ref;
+};
+
+u8_t pbuf_free(struct pbuf *p);
+void pbuf_ref(struct pbuf *p);
+void pbuf_cat(struct pbuf *head, struct pbuf *tail);
+struct pbuf *pbuf_free_header(struct pbuf *q, u16_t size);
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset);
+u8_t pbuf_get_at(const struct pbuf *p, u16_t offset);
+
+#endif // HOST_LWIP_PBUF_H
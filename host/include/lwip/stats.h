@@ -0,0 +1,55 @@
+#ifndef HOST_LWIP_STATS_H
+#define HOST_LWIP_STATS_H
+
+#include "lwip/opt.h"
+#include "lwip/arch.h"
+
+// lwip_stats do build no PC, com os campos que /metrics lê. host_net.c
+// mantém os pools que simula (pcbs, pbufs recebidos), o "heap" (bytes nos
+// buffers de envio, que o lwIP alocaria com TCP_WRITE_FLAG_COPY) e os
+// segmentos de TCP.
+
+typedef u32_t STAT_COUNTER; // LWIP_STATS_LARGE
+typedef u32_t mem_size_t;
+
+struct stats_mem {
+    STAT_COUNTER err;
+    mem_size_t avail;
+    mem_size_t used;
+    mem_size_t max;
+    STAT_COUNTER illegal;
+};
+
+struct stats_proto {
+    STAT_COUNTER xmit;
+    STAT_COUNTER recv;
+    STAT_COUNTER fw;
+    STAT_COUNTER drop;
+    STAT_COUNTER chkerr;
+    STAT_COUNTER lenerr;
+    STAT_COUNTER memerr;
+    STAT_COUNTER rterr;
+    STAT_COUNTER proterr;
+    STAT_COUNTER opterr;
+    STAT_COUNTER err;
+    STAT_COUNTER cachehit;
+};
+
+typedef enum {
+    MEMP_TCP_PCB,
+    MEMP_TCP_PCB_LISTEN,
+    MEMP_TCP_SEG,
+    MEMP_PBUF,
+    MEMP_PBUF_POOL,
+    MEMP_MAX
+} memp_t;
+
+struct stats_ {
+    struct stats_proto tcp;
+    struct stats_mem mem;
+    struct stats_mem *memp[MEMP_MAX];
+};
+
+extern struct stats_ lwip_stats;
+
+#endif // HOST_LWIP_STATS_H
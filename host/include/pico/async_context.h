@@ -0,0 +1,47 @@
+#ifndef HOST_PICO_ASYNC_CONTEXT_H
+#define HOST_PICO_ASYNC_CONTEXT_H
+
+#include "pico/time.h"
+
+// Mesmo modelo do async_context do SDK (host_async.c): trabalhos com prazo e
+// trabalhos marcados como pendentes, executados por async_context_poll na
+// thread dona do contexto. set_work_pending pode vir de outra thread ou da
+// thread de interrupções.
+
+typedef struct async_context async_context_t;
+
+typedef struct async_work_on_timeout {
+    struct async_work_on_timeout *next;
+    void (*do_work)(async_context_t *context, struct async_work_on_timeout *timeout);
+    absolute_time_t next_time;
+    void *user_data;
+} async_at_time_worker_t;
+
+typedef struct async_when_pending_worker {
+    struct async_when_pending_worker *next;
+    void (*do_work)(async_context_t *context, struct async_when_pending_worker *worker);
+    volatile bool work_pending;
+    void *user_data;
+} async_when_pending_worker_t;
+
+struct async_context {
+    async_at_time_worker_t *at_time_list;
+    async_when_pending_worker_t *when_pending_list;
+    unsigned core_num;       // Thread dona (0: também atende a rede)
+    int wake_fd;             // eventfd: acorda async_context_wait_for_work_until
+};
+
+bool async_context_add_at_time_worker(async_context_t *context, async_at_time_worker_t *worker);
+bool async_context_add_at_time_worker_at(async_context_t *context, async_at_time_worker_t *worker,
+                                         absolute_time_t at);
+bool async_context_add_at_time_worker_in_ms(async_context_t *context, async_at_time_worker_t *worker,
+                                            uint32_t ms);
+bool async_context_remove_at_time_worker(async_context_t *context, async_at_time_worker_t *worker);
+bool async_context_add_when_pending_worker(async_context_t *context, async_when_pending_worker_t *worker);
+bool async_context_remove_when_pending_worker(async_context_t *context, async_when_pending_worker_t *worker);
+void async_context_set_work_pending(async_context_t *context, async_when_pending_worker_t *worker);
+void async_context_poll(async_context_t *context);
+void async_context_wait_for_work_until(async_context_t *context, absolute_time_t until);
+void async_context_wait_for_work_ms(async_context_t *context, uint32_t ms);
+
+#endif // HOST_PICO_ASYNC_CONTEXT_H
@@ -0,0 +1,33 @@
+#ifndef HOST_PICO_CYW43_ARCH_H
+#define HOST_PICO_CYW43_ARCH_H
+
+#include "pico/stdlib.h"
+#include "lwip/tcp.h"
+
+// Sem Wi-Fi: a "conexão" é a interface de loopback do PC e o lwIP é
+// substituído por sockets (host_net.c). A rede é atendida na thread do
+// núcleo 0, entre os trabalhos do async_context, então begin/end não
+// precisam travar nada.
+
+#define CYW43_AUTH_WPA2_AES_PSK 0x00400004
+
+struct netif {
+    ip_addr_t ip_addr;
+};
+
+typedef struct cyw43 {
+    struct netif netif[1];
+} cyw43_t;
+
+extern cyw43_t cyw43_state;
+
+int cyw43_arch_init(void);
+void cyw43_arch_deinit(void);
+void cyw43_arch_enable_sta_mode(void);
+int cyw43_arch_wifi_connect_timeout_ms(const char *ssid, const char *pw, uint32_t auth, uint32_t timeout);
+void cyw43_arch_poll(void);
+
+static inline void cyw43_arch_lwip_begin(void) {}
+static inline void cyw43_arch_lwip_end(void) {}
+
+#endif // HOST_PICO_CYW43_ARCH_H
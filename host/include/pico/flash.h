@@ -0,0 +1,13 @@
+#ifndef HOST_PICO_FLASH_H
+#define HOST_PICO_FLASH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PICO_OK 0
+
+// No PC nada executa da flash: a função roda direto (host_flash.c)
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms);
+bool flash_safe_execute_core_init(void);
+
+#endif // HOST_PICO_FLASH_H
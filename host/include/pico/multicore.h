@@ -0,0 +1,13 @@
+#ifndef HOST_PICO_MULTICORE_H
+#define HOST_PICO_MULTICORE_H
+
+#include <stdint.h>
+
+// O núcleo 1 é uma thread (host_async.c); a FIFO entre os núcleos, uma fila
+// com semáforos nos dois sentidos
+void multicore_launch_core1(void (*entry)(void));
+void multicore_fifo_push_blocking(uint32_t data);
+uint32_t multicore_fifo_pop_blocking(void);
+unsigned get_core_num(void);
+
+#endif // HOST_PICO_MULTICORE_H
@@ -0,0 +1,38 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Build no PC (host/): só a parte do SDK que a estação usa, com as mesmas
+// assinaturas. Tempo, GPIO, PWM e PIO em host_time.c e host_gpio.c.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned int uint;
+
+#define _u(x) x##u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define __not_in_flash_func(f) f
+#define __in_flash(group)
+
+static inline void tight_loop_contents(void) {}
+
+// Núcleo da thread que chama (host_async.c); no SDK vem de pico/platform.h
+unsigned get_core_num(void);
+
+bool stdio_init_all(void);
+
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#endif // HOST_PICO_STDLIB_H
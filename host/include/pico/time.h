@@ -0,0 +1,75 @@
+#ifndef HOST_PICO_TIME_H
+#define HOST_PICO_TIME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+// Relógio virtual: conta do início do processo e anda ESTACAO_HOST_SPEED
+// vezes mais rápido que o relógio real (host_time.c)
+typedef struct {
+    uint64_t _private_us_since_boot;
+} absolute_time_t;
+
+static const absolute_time_t at_the_end_of_time = {UINT64_MAX};
+static const absolute_time_t nil_time = {0};
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) {
+    return t._private_us_since_boot;
+}
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t._private_us_since_boot / 1000);
+}
+
+static inline absolute_time_t from_us_since_boot(uint64_t us) {
+    absolute_time_t t = {us};
+    return t;
+}
+
+static inline bool is_nil_time(absolute_time_t t) {
+    return t._private_us_since_boot == 0;
+}
+
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) {
+    uint64_t base = t._private_us_since_boot;
+    return from_us_since_boot(base + us < base ? UINT64_MAX : base + us);
+}
+
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) {
+    return delayed_by_us(t, ms * 1000ull);
+}
+
+static inline absolute_time_t make_timeout_time_us(uint64_t us) {
+    return delayed_by_us(get_absolute_time(), us);
+}
+
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return delayed_by_ms(get_absolute_time(), ms);
+}
+
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t)(to._private_us_since_boot - from._private_us_since_boot);
+}
+
+// Alarmes (host_irq.c): o callback roda na thread de interrupções
+typedef int32_t alarm_id_t;
+typedef struct alarm_pool alarm_pool_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers);
+alarm_id_t alarm_pool_add_alarm_in_us(alarm_pool_t *pool, uint64_t us, alarm_callback_t callback,
+                                      void *user_data, bool fire_if_past);
+bool alarm_pool_cancel_alarm(alarm_pool_t *pool, alarm_id_t alarm_id);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t alarm_id);
+
+#endif // HOST_PICO_TIME_H
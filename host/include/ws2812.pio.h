@@ -0,0 +1,15 @@
+#ifndef HOST_WS2812_PIO_H
+#define HOST_WS2812_PIO_H
+
+// No firmware este cabeçalho é gerado de lib/matriz/ws2812.pio
+// (pico_generate_pio_header); no PC o programa não executa
+
+#include "hardware/pio.h"
+
+static const pio_program_t ws2812_program = {0};
+
+static inline void ws2812_program_init(PIO pio, uint sm, uint offset, uint pin, float freq, bool rgbw) {
+    (void)pio, (void)sm, (void)offset, (void)pin, (void)freq, (void)rgbw;
+}
+
+#endif // HOST_WS2812_PIO_H
@@ -0,0 +1,164 @@
+// Testes do parser HTTP (lib/http/http_parser.c) no PC, rodados pelo ctest.
+//
+//   cmake -S host -B build-host && cmake --build build-host -j
+//   ctest --test-dir build-host --output-on-failure
+
+#include <stdio.h>
+#include <string.h>
+#include "lwip/def.h"
+#include "http/http_parser.h"
+
+static int failures;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        fprintf(stderr, "FALHOU: %s\n", what);
+        failures++;
+    }
+}
+
+// Interpreta uma requisição inteira; false se o parser não terminar sem erro
+static bool parse(struct http_parser *parser, const char *request)
+{
+    http_parser_reset(parser);
+    http_parser_feed(parser, request, (u16_t)strlen(request));
+    return parser->state == HTTP_PARSE_DONE;
+}
+
+// Entrega a requisição em pedaços de chunk bytes, como pbufs de uma cadeia
+static bool parse_in_pieces(struct http_parser *parser, const char *request, u16_t chunk)
+{
+    http_parser_reset(parser);
+    u16_t len = (u16_t)strlen(request);
+    for (u16_t off = 0; off < len; off += chunk) {
+        u16_t n = LWIP_MIN(chunk, (u16_t)(len - off));
+        if (http_parser_feed(parser, request + off, n) != n) {
+            return false; // Sobra só se a requisição terminar antes do fim
+        }
+    }
+    return parser->state == HTTP_PARSE_DONE;
+}
+
+// Status de erro da requisição (0 se terminou sem erro)
+static int error_for(const char *request)
+{
+    static struct http_parser parser;
+    parse(&parser, request);
+    return parser.state == HTTP_PARSE_ERROR ? parser.error_status : 0;
+}
+
+static bool gzip_for(const char *accept_encoding)
+{
+    static struct http_parser parser;
+    char request[HTTP_LINE_MAX * 2];
+    snprintf(request, sizeof(request), "GET / HTTP/1.1\r\nAccept-Encoding: %s\r\n\r\n", accept_encoding);
+    return parse(&parser, request) && parser.req.accepts_gzip;
+}
+
+int main(void)
+{
+    static struct http_parser parser;
+
+    // Sem Accept-Encoding qualquer codificação serve (RFC 9110, 12.5.3)
+    check(parse(&parser, "GET / HTTP/1.1\r\nHost: x\r\n\r\n") && parser.req.accepts_gzip,
+          "sem Accept-Encoding aceita gzip");
+    check(parse(&parser, "GET / HTTP/1.0\r\n\r\n") && parser.req.accepts_gzip,
+          "HTTP/1.0 sem cabeçalhos aceita gzip");
+
+    check(gzip_for("gzip, deflate, br"), "gzip na lista");
+    check(gzip_for("GZIP;q=0.8"), "gzip em maiúsculas com q");
+    check(gzip_for("x-gzip"), "x-gzip");
+    check(gzip_for("br, *;q=0.5"), "* com q diferente de 0");
+    check(!gzip_for("gzip;q=0, *"), "gzip;q=0 vale mais que *");
+    check(!gzip_for("identity"), "só identity");
+    check(!gzip_for("*;q=0"), "*;q=0");
+    check(!gzip_for("gzip;q=0.000"), "q=0.000");
+
+    // Parser reaproveitado: a requisição seguinte volta ao padrão
+    check(!gzip_for("identity") && parse(&parser, "GET / HTTP/1.1\r\n\r\n") && parser.req.accepts_gzip,
+          "reset volta a aceitar gzip");
+
+    // Fragmentação: byte a byte e em pedaços que cortam linhas e o CRLF
+    static const char post[] =
+        "POST /set_limits HTTP/1.1\r\nHost: x\r\nContent-Length: 16\r\n\r\n{\"temp_min\":1.5}";
+    for (u16_t chunk = 1; chunk <= 7; chunk++) {
+        char what[48];
+        snprintf(what, sizeof(what), "POST em pedaços de %u byte(s)", chunk);
+        check(parse_in_pieces(&parser, post, chunk) && parser.req.method == HTTP_METHOD_POST &&
+              strcmp(parser.req.path, "/set_limits") == 0 && parser.req.body_len == 16 &&
+              strcmp(parser.req.body, "{\"temp_min\":1.5}") == 0, what);
+    }
+
+    // Corpo pelo Content-Length chegando aos poucos, inclusive num feed só dele
+    http_parser_reset(&parser);
+    static const char head[] = "POST /x HTTP/1.1\r\nContent-Length: 5\r\n\r\n";
+    http_parser_feed(&parser, head, sizeof(head) - 1);
+    check(parser.state == HTTP_PARSE_BODY, "aguarda o corpo após os cabeçalhos");
+    http_parser_feed(&parser, "ab", 2);
+    check(parser.state == HTTP_PARSE_BODY && parser.req.body_len == 2, "corpo parcial");
+    check(http_parser_feed(&parser, "cdeGET", 6) == 3 && parser.state == HTTP_PARSE_DONE &&
+          strcmp(parser.req.body, "abcde") == 0, "corpo completo não consome a requisição seguinte");
+
+    // Pipelining: duas requisições num feed; a segunda fica para o próximo reset
+    static const char pipelined[] = "GET /a?since=7 HTTP/1.1\r\n\r\nGET /b HTTP/1.1\r\nConnection: close\r\n\r\n";
+    http_parser_reset(&parser);
+    u16_t used = http_parser_feed(&parser, pipelined, sizeof(pipelined) - 1);
+    check(parser.state == HTTP_PARSE_DONE && strcmp(parser.req.path, "/a") == 0 &&
+          strcmp(parser.req.query, "since=7") == 0 && parser.req.keep_alive, "primeira requisição do pipeline");
+    http_parser_reset(&parser);
+    u16_t rest = (u16_t)(sizeof(pipelined) - 1 - used);
+    check(http_parser_feed(&parser, pipelined + used, rest) == rest && parser.state == HTTP_PARSE_DONE &&
+          strcmp(parser.req.path, "/b") == 0 && !parser.req.keep_alive, "segunda requisição do pipeline");
+
+    // Keep-alive: padrão do HTTP/1.1; HTTP/1.0 e "Connection: close" fecham
+    check(parse(&parser, "GET / HTTP/1.1\r\n\r\n") && parser.req.keep_alive, "HTTP/1.1 mantém a conexão");
+    check(parse(&parser, "GET / HTTP/1.0\r\n\r\n") && !parser.req.keep_alive, "HTTP/1.0 fecha");
+    check(parse(&parser, "GET / HTTP/1.1\r\nConnection: Close\r\n\r\n") && !parser.req.keep_alive,
+          "Connection: close fecha");
+    check(parse(&parser, "GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n") && parser.req.keep_alive,
+          "HTTP/1.0 com keep-alive mantém");
+
+    // Limites: linha, caminho, query e corpo
+    char request[HTTP_LINE_MAX * 2];
+    char long_path[HTTP_LINE_MAX + 1];
+    memset(long_path, 'a', sizeof(long_path) - 1);
+    long_path[sizeof(long_path) - 1] = '\0';
+    snprintf(request, sizeof(request), "GET /%s HTTP/1.1\r\n\r\n", long_path);
+    check(error_for(request) == 414, "request-line maior que HTTP_LINE_MAX: 414");
+    long_path[HTTP_PATH_MAX] = '\0';
+    snprintf(request, sizeof(request), "GET /%s HTTP/1.1\r\n\r\n", long_path);
+    check(error_for(request) == 414, "caminho maior que HTTP_PATH_MAX: 414");
+    snprintf(request, sizeof(request), "GET /?%s HTTP/1.1\r\n\r\n", long_path);
+    check(error_for(request) == 414, "query maior que HTTP_PATH_MAX: 414");
+    long_path[HTTP_PATH_MAX - 2] = '\0';
+    snprintf(request, sizeof(request), "GET /%s HTTP/1.1\r\n\r\n", long_path);
+    check(error_for(request) == 0, "caminho no limite");
+
+    snprintf(request, sizeof(request), "POST /x HTTP/1.1\r\nContent-Length: %d\r\n\r\n", HTTP_BODY_MAX + 1);
+    check(error_for(request) == 413, "corpo maior que HTTP_BODY_MAX: 413");
+    snprintf(request, sizeof(request), "POST /x HTTP/1.1\r\nContent-Length: %d\r\n\r\n", HTTP_BODY_MAX);
+    check(!parse(&parser, request) && parser.state == HTTP_PARSE_BODY, "corpo no limite aguarda os dados");
+
+    // Cabeçalhos curtos mas muitos: o total passa de HTTP_HEADERS_MAX
+    http_parser_reset(&parser);
+    check(http_parser_idle(&parser), "parser novo está ocioso");
+    http_parser_feed(&parser, "GET / HTTP/1.1\r\n", 16);
+    check(!http_parser_idle(&parser), "requisição começada não está ociosa");
+    for (int n = 0; n < HTTP_HEADERS_MAX / 6 + 1 && parser.state == HTTP_PARSE_HEADERS; n++) {
+        http_parser_feed(&parser, "X: y\r\n", 6);
+    }
+    check(parser.state == HTTP_PARSE_ERROR && parser.error_status == 431, "cabeçalhos além de HTTP_HEADERS_MAX: 431");
+
+    // Transfer-Encoding não é suportado: 501 em vez de ler os chunks como requisição
+    check(error_for("POST /x HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n0\r\n\r\n") == 501,
+          "Transfer-Encoding: 501");
+    check(error_for("GET / HTTP/1.1\r\nsem dois pontos\r\n\r\n") == 400, "cabeçalho sem ':': 400");
+
+    if (failures) {
+        fprintf(stderr, "%d falha(s)\n", failures);
+        return 1;
+    }
+    printf("http_parser: ok\n");
+    return 0;
+}
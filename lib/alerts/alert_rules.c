@@ -0,0 +1,76 @@
+#include <string.h>
+#include "alert_rules.h"
+
+void alert_state_reset(struct alert_state *s)
+{
+    memset(s, 0, sizeof(*s));
+    s->active = ALERT_NONE;
+}
+
+// Condição bruta do canal, com a histerese do lado em que ele está
+static bool channel_out(const struct alert_band *band, bool out, int32_t v)
+{
+    if (out) {
+        return v < band->min + band->hysteresis || v > band->max - band->hysteresis;
+    }
+    return v < band->min || v > band->max;
+}
+
+int alert_evaluate(const struct alert_config *c, struct alert_state *s, const int32_t *value,
+                   uint32_t now_ms)
+{
+    for (uint8_t i = 0; i < c->channels; i++) {
+        uint64_t bit = (uint64_t)1 << i;
+        bool out = s->out & bit;
+        if (channel_out(&c->band[i], out, value[i]) == out) {
+            s->pending &= ~bit; // Voltou antes da duração mínima
+            continue;
+        }
+        if (!(s->pending & bit)) {
+            s->pending |= bit;
+            s->since_ms[i] = now_ms;
+        }
+        if (now_ms - s->since_ms[i] >= c->band[i].min_duration_ms) {
+            s->out ^= bit;
+            s->pending &= ~bit;
+        }
+    }
+
+    if (s->matched && s->matched_out == s->out) {
+        return s->active;
+    }
+    int best = ALERT_NONE;
+    for (uint8_t r = 0; r < c->rules; r++) {
+        const struct alert_rule *rule = &c->rule[r];
+        if ((s->out & rule->mask) == rule->mask &&
+            (best == ALERT_NONE || rule->priority > c->rule[best].priority)) {
+            best = r;
+        }
+    }
+    s->matched_out = s->out;
+    s->matched = true;
+    s->active = (int8_t)best;
+    return best;
+}
+
+bool alert_config_valid(const struct alert_config *c)
+{
+    if (c->channels > ALERT_MAX_CHANNELS || c->rules > ALERT_MAX_RULES) {
+        return false;
+    }
+    uint64_t channels = c->channels == ALERT_MAX_CHANNELS ? UINT64_MAX : ((uint64_t)1 << c->channels) - 1;
+    for (uint8_t i = 0; i < c->channels; i++) {
+        const struct alert_band *band = &c->band[i];
+        if (band->min > band->max || band->hysteresis < 0 ||
+            (int64_t)band->hysteresis * 2 > (int64_t)band->max - band->min) {
+            return false; // Faixa de volta vazia: o canal nunca sairia do alerta
+        }
+    }
+    for (uint8_t r = 0; r < c->rules; r++) {
+        const struct alert_rule *rule = &c->rule[r];
+        if (!rule->mask || (rule->mask & ~channels) || rule->led > ALERT_LED_OFF) {
+            return false; // Máscara vazia casaria sempre
+        }
+    }
+    return true;
+}
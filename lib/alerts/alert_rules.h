@@ -0,0 +1,90 @@
+#ifndef ALERT_RULES_H
+#define ALERT_RULES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Motor de regras dos alertas, por tabela.
+//
+// Cada canal de medida (valores inteiros, em geral centésimos) tem uma faixa
+// [min, max] com histerese e duração mínima: o canal passa a "fora da faixa"
+// quando sai de [min, max] e só volta quando entra em
+// [min + histerese, max - histerese]; nos dois sentidos a condição nova
+// precisa durar min_duration_ms antes de valer. Isso impede que uma leitura
+// no limite fique ligando e desligando o alerta.
+//
+// O estado de todos os canais vira uma máscara (bit i = canal i fora da
+// faixa), calculada uma vez por amostra. Uma regra casa quando todos os
+// canais da sua máscara estão fora; vale a regra de maior prioridade (empate:
+// a primeira da tabela). A avaliação é O(canais) comparações inteiras mais
+// O(regras) testes de máscara, sem float.
+//
+// Sem dependência do SDK (medições em tools/bench_alert_rules.c).
+
+#define ALERT_MAX_CHANNELS 64 // Bits da máscara
+#define ALERT_MAX_RULES    16
+#define ALERT_NAME_MAX     24
+#define ALERT_NONE         (-1)
+
+// Indicação do LED RGB enquanto a regra estiver ativa
+enum alert_led {
+    ALERT_LED_GREEN,
+    ALERT_LED_RED,
+    ALERT_LED_BLUE,
+    ALERT_LED_YELLOW,
+    ALERT_LED_OFF,
+};
+
+struct alert_band {
+    int32_t min;
+    int32_t max;
+    int32_t hysteresis;       // Margem para voltar à faixa (mesma unidade)
+    uint32_t min_duration_ms; // Tempo que a condição nova precisa durar
+};
+
+struct alert_rule {
+    uint64_t mask;            // Canais que precisam estar todos fora da faixa
+    uint8_t priority;         // Maior vence
+    uint8_t r, g, b;          // Cor da matriz de LEDs
+    uint8_t led;              // enum alert_led
+    uint16_t beep_hz;         // Bipe repetido enquanto a regra estiver ativa (beep_ms = 0: mudo)
+    uint16_t beep_ms;
+    char name[ALERT_NAME_MAX];
+};
+
+// Configuração completa: faixas dos canais e tabela de regras
+struct alert_config {
+    uint8_t channels;
+    uint8_t rules;
+    struct alert_band band[ALERT_MAX_CHANNELS];
+    struct alert_rule rule[ALERT_MAX_RULES];
+};
+
+// Estado de uma avaliação para a outra. Zerado = todos os canais na faixa.
+struct alert_state {
+    uint64_t out;             // Canais fora da faixa (com histerese e duração)
+    uint64_t pending;         // Canais cuja condição mudou e ainda não durou o bastante
+    uint32_t since_ms[ALERT_MAX_CHANNELS]; // Início da mudança pendente
+    uint64_t matched_out;     // out da última busca nas regras
+    int8_t active;            // Regra ativa, ou ALERT_NONE
+    bool matched;             // matched_out/active valem para a tabela atual
+};
+
+void alert_state_reset(struct alert_state *s);
+
+// Atualiza o estado dos canais com os valores da amostra e retorna a regra
+// ativa (índice em c->rule) ou ALERT_NONE. A busca nas regras só é refeita se
+// a máscara mudou; depois de trocar a tabela, chame alert_state_rules_changed.
+int alert_evaluate(const struct alert_config *c, struct alert_state *s, const int32_t *value,
+                   uint32_t now_ms);
+
+static inline void alert_state_rules_changed(struct alert_state *s)
+{
+    s->matched = false;
+}
+
+// Confere uma configuração recebida (faixas coerentes, máscaras só com
+// canais existentes, LED válido); false: não deve ser aplicada
+bool alert_config_valid(const struct alert_config *c);
+
+#endif // ALERT_RULES_H
@@ -0,0 +1,30 @@
+#ifndef BENCH_CYCLES_H
+#define BENCH_CYCLES_H
+
+#include <stdint.h>
+#include "hardware/structs/systick.h"
+
+// Contagem de ciclos com o SysTick do Cortex-M0+ (não há DWT no RP2040).
+// O contador é decrescente e tem 24 bits: mede trechos de até ~134 ms a 125 MHz.
+// Usado apenas pelos benchmarks (opção ESTACAO_BENCHMARKS do CMake).
+
+#define BENCH_CYCLES_MASK 0x00FFFFFFu
+
+static inline void bench_cycles_init(void)
+{
+    systick_hw->rvr = BENCH_CYCLES_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5; // ENABLE | CLKSOURCE (clock do processador), sem interrupção
+}
+
+static inline uint32_t bench_cycles_now(void)
+{
+    return systick_hw->cvr;
+}
+
+static inline uint32_t bench_cycles_since(uint32_t start)
+{
+    return (start - systick_hw->cvr) & BENCH_CYCLES_MASK;
+}
+
+#endif // BENCH_CYCLES_H
@@ -1,6 +1,7 @@
 #include "buzzer.h"
 #include "hardware/pwm.h"
 #include "hardware/clocks.h"
+#include "hardware/sync.h"
 
 // Inicializa o PWM no pino do buzzer
 int init_buzzer(uint pin, float clk_div)
@@ -29,6 +30,170 @@ void play_tone(uint pin, uint frequency)
 // Desliga o tom no pino do buzzer
 void stop_tone(uint pin)
 {
-    uint slice_num = pwm_gpio_to_slice_num(pin);
     pwm_set_gpio_level(pin, 0); // Desliga o PWM
-}
\ No newline at end of file
+}
+
+// ---- Sequenciador de padrões ----
+//
+// O estado é mexido pelo alarme e pelas chamadas do núcleo dono, que
+// desligam as interrupções (do próprio núcleo, onde o alarme dispara)
+// enquanto alteram a fila.
+static struct {
+    uint pin;
+    alarm_pool_t *pool;
+    alarm_id_t alarm;      // > 0: passo em andamento
+    const struct buzzer_pattern *queue[BUZZER_QUEUE]; // Ordem de prioridade; [0] toca
+    uint8_t queued;
+    uint8_t step;
+    uint8_t round;
+    bool in_pause;         // Na pausa depois do tom do passo atual
+    bool muted;
+} seq;
+
+// Começa o passo atual de queue[0]; retorna a duração do tom em us
+static int64_t seq_sound(void)
+{
+    const struct buzzer_step *s = &seq.queue[0]->steps[seq.step];
+    if (s->freq_hz) {
+        play_tone(seq.pin, s->freq_hz);
+    } else {
+        stop_tone(seq.pin);
+    }
+    seq.in_pause = false;
+    return (int64_t)(s->on_ms ? s->on_ms : 1) * 1000;
+}
+
+static void seq_remove(uint8_t i)
+{
+    seq.queued--;
+    for (; i < seq.queued; i++) {
+        seq.queue[i] = seq.queue[i + 1];
+    }
+}
+
+// Próximo tempo do alarme depois do tom, da pausa ou do fim do padrão (0:
+// fila vazia, alarme encerrado)
+static int64_t seq_advance(void)
+{
+    const struct buzzer_pattern *p = seq.queue[0];
+    const struct buzzer_step *s = &p->steps[seq.step];
+    if (!seq.in_pause && s->off_ms) {
+        stop_tone(seq.pin);
+        seq.in_pause = true;
+        return (int64_t)s->off_ms * 1000;
+    }
+    if (++seq.step < p->count) {
+        return seq_sound();
+    }
+    seq.step = 0;
+    if (p->repeat && ++seq.round >= p->repeat) {
+        seq_remove(0);
+        seq.round = 0;
+        if (!seq.queued) {
+            stop_tone(seq.pin);
+            return 0;
+        }
+    }
+    return seq_sound();
+}
+
+static int64_t seq_alarm(alarm_id_t id, void *user_data)
+{
+    if (id != seq.alarm) {
+        return 0; // Cancelado enquanto já disparava
+    }
+    int64_t next = seq_advance();
+    if (!next) {
+        seq.alarm = 0;
+    }
+    return next; // > 0: conta do prazo anterior, sem acumular atraso
+}
+
+// Com as interrupções desligadas: recomeça por queue[0] (ou silencia)
+static void seq_restart(void)
+{
+    if (seq.alarm > 0) {
+        alarm_pool_cancel_alarm(seq.pool, seq.alarm);
+        seq.alarm = 0;
+    }
+    seq.step = 0;
+    seq.round = 0;
+    if (!seq.queued) {
+        stop_tone(seq.pin);
+        return;
+    }
+    int64_t us = seq_sound();
+    seq.alarm = alarm_pool_add_alarm_in_us(seq.pool, (uint64_t)us, seq_alarm, NULL, true);
+    if (seq.alarm <= 0) {
+        stop_tone(seq.pin); // Pool sem alarmes livres: melhor calado que preso no tom
+        seq.alarm = 0;
+        seq.queued = 0;
+    }
+}
+
+void buzzer_seq_init(uint pin, alarm_pool_t *pool)
+{
+    seq.pin = pin;
+    seq.pool = pool;
+}
+
+bool buzzer_play(const struct buzzer_pattern *pattern)
+{
+    if (!pattern->count) {
+        return false;
+    }
+    uint32_t irq = save_and_disable_interrupts();
+    bool ok = !seq.muted;
+    for (uint8_t i = 0; ok && i < seq.queued; i++) {
+        if (seq.queue[i] == pattern) {
+            restore_interrupts(irq);
+            return true;
+        }
+    }
+    if (ok && seq.queued == BUZZER_QUEUE) {
+        if (seq.queue[BUZZER_QUEUE - 1]->priority >= pattern->priority) {
+            ok = false;
+        } else {
+            seq.queued--; // Sai o de menor prioridade
+        }
+    }
+    if (ok) {
+        uint8_t i = seq.queued;
+        for (; i && seq.queue[i - 1]->priority < pattern->priority; i--) {
+            seq.queue[i] = seq.queue[i - 1];
+        }
+        seq.queue[i] = pattern;
+        seq.queued++;
+        if (i == 0) {
+            seq_restart(); // Fila vazia ou prioridade maior: toca já
+        }
+    }
+    restore_interrupts(irq);
+    return ok;
+}
+
+void buzzer_stop(const struct buzzer_pattern *pattern)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    for (uint8_t i = 0; i < seq.queued; i++) {
+        if (seq.queue[i] == pattern) {
+            seq_remove(i);
+            if (i == 0) {
+                seq_restart();
+            }
+            break;
+        }
+    }
+    restore_interrupts(irq);
+}
+
+void buzzer_mute(bool muted)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    if (muted && !seq.muted) {
+        seq.queued = 0;
+        seq_restart();
+    }
+    seq.muted = muted;
+    restore_interrupts(irq);
+}
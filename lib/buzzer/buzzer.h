@@ -11,4 +11,44 @@ int init_buzzer(uint pin, float clk_div); // Inicializa o PWM no pino do buzzer
 void play_tone(uint pin, uint frequency); // Toca uma nota com a frequência e duração especificadas
 void stop_tone(uint pin);                 // Desliga o tom no pino do buzzer
 
+// ---- Sequenciador de padrões ----
+//
+// Os padrões tocam a partir de um alarme de hardware (pool de alarmes do
+// núcleo dono do buzzer): quem chama só enfileira e volta na hora. Cada
+// passo é um tom (ou silêncio, freq_hz = 0) seguido de uma pausa; o padrão
+// inteiro se repete repeat vezes, ou até buzzer_stop se repeat = 0.
+//
+// Toca o padrão de maior prioridade; um padrão novo com prioridade maior
+// interrompe o atual, que volta a tocar do início quando o novo acabar. Os
+// padrões (e os passos) precisam existir enquanto estiverem na fila.
+// Todas as funções devem ser chamadas no núcleo que chamou buzzer_seq_init.
+
+#define BUZZER_QUEUE 4 // Padrões na fila, incluindo o que está tocando
+
+struct buzzer_step {
+    uint16_t freq_hz; // 0 = silêncio
+    uint16_t on_ms;
+    uint16_t off_ms;  // Pausa depois do tom
+};
+
+struct buzzer_pattern {
+    const struct buzzer_step *steps;
+    uint8_t count;
+    uint8_t repeat;   // 0 = até buzzer_stop
+    uint8_t priority; // Maior interrompe menor
+};
+
+void buzzer_seq_init(uint pin, alarm_pool_t *pool);
+
+// Enfileira o padrão (já na fila: nada muda). Retorna false se ele não
+// entrou: mudo, ou fila cheia de padrões com prioridade igual ou maior.
+bool buzzer_play(const struct buzzer_pattern *pattern);
+
+// Tira o padrão da fila; se estava tocando, passa para o próximo
+void buzzer_stop(const struct buzzer_pattern *pattern);
+
+// Mudo: esvazia a fila e silencia na hora; enquanto durar, buzzer_play
+// descarta os padrões
+void buzzer_mute(bool muted);
+
 #endif // BUZZER_H
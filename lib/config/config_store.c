@@ -0,0 +1,136 @@
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "flash_layout.h"
+#include "config_store.h"
+
+#define CONFIG_STORE_MAGIC      0x31474643 // "CFG1"
+#define CONFIG_STORE_TIMEOUT_MS 100
+
+struct config_record {
+    uint32_t magic;
+    uint32_t seq;
+    struct station_config config;
+    uint32_t crc;                  // CRC-32 dos campos anteriores
+};
+
+static_assert(sizeof(struct config_record) <= FLASH_PAGE_SIZE, "registro maior que uma página");
+static_assert(CONFIG_STORE_FLASH_SIZE == 2 * FLASH_SECTOR_SIZE, "são dois setores");
+
+extern char __flash_binary_end;
+
+static int active_slot = -1; // Setor com o registro válido mais novo
+static volatile bool pending;
+static volatile uint32_t last_change_ms;
+
+static const struct config_record *slot_record(int slot)
+{
+    return (const struct config_record *)(XIP_BASE + CONFIG_STORE_FLASH_OFFSET + slot * FLASH_SECTOR_SIZE);
+}
+
+// CRC-32 (IEEE), bit a bit: o registro tem poucas dezenas de bytes
+static uint32_t crc32(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    uint32_t crc = 0xFFFFFFFF;
+    while (len--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static bool record_valid(const struct config_record *record)
+{
+    return record->magic == CONFIG_STORE_MAGIC &&
+           record->crc == crc32(record, offsetof(struct config_record, crc));
+}
+
+static bool flash_data_ok(void)
+{
+    return (uintptr_t)&__flash_binary_end - XIP_BASE <= CONFIG_STORE_FLASH_OFFSET;
+}
+
+bool config_store_load(struct station_config *config)
+{
+    if (!flash_data_ok()) {
+        return false;
+    }
+    active_slot = -1;
+    for (int slot = 0; slot < 2; slot++) {
+        const struct config_record *record = slot_record(slot);
+        if (record_valid(record) &&
+            (active_slot < 0 || record->seq > slot_record(active_slot)->seq)) {
+            active_slot = slot;
+        }
+    }
+    if (active_slot < 0) {
+        return false;
+    }
+    memcpy(config, &slot_record(active_slot)->config, sizeof(*config));
+    return true;
+}
+
+void config_store_touch(void)
+{
+    last_change_ms = to_ms_since_boot(get_absolute_time());
+    pending = true;
+}
+
+bool config_store_due(uint32_t now_ms)
+{
+    if (!pending || now_ms - last_change_ms < CONFIG_STORE_SAVE_DELAY_MS) {
+        return false;
+    }
+    pending = false; // Alterações depois daqui marcam de novo
+    return true;
+}
+
+struct write_args {
+    uint32_t offset;
+    const uint8_t *page;
+};
+
+static void do_write(void *param)
+{
+    const struct write_args *args = param;
+    flash_range_erase(args->offset, FLASH_SECTOR_SIZE);
+    flash_range_program(args->offset, args->page, FLASH_PAGE_SIZE);
+}
+
+bool config_store_save(const struct station_config *config)
+{
+    if (!flash_data_ok()) {
+        printf("Erro: firmware invade a regiao de configuracao na flash\n");
+        return false;
+    }
+    const struct config_record *current = active_slot >= 0 ? slot_record(active_slot) : NULL;
+    if (current && memcmp(&current->config, config, sizeof(*config)) == 0) {
+        return true; // Voltou ao que já está gravado
+    }
+
+    uint8_t page[FLASH_PAGE_SIZE];
+    memset(page, 0xFF, sizeof(page));
+    struct config_record record = {
+        .magic = CONFIG_STORE_MAGIC,
+        .seq = current ? current->seq + 1 : 1,
+        .config = *config,
+    };
+    record.crc = crc32(&record, offsetof(struct config_record, crc));
+    memcpy(page, &record, sizeof(record));
+
+    int slot = active_slot == 0 ? 1 : 0;
+    struct write_args args = {CONFIG_STORE_FLASH_OFFSET + slot * FLASH_SECTOR_SIZE, page};
+    if (flash_safe_execute(do_write, &args, CONFIG_STORE_TIMEOUT_MS) != PICO_OK ||
+        !record_valid(slot_record(slot))) {
+        return false;
+    }
+    active_slot = slot;
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Limites, offsets e estado dos alertas guardados na flash.
+//
+// Dois setores alternados (flash_layout.h), cada um com um registro
+// {magic, sequência, configuração, CRC-32}. Uma gravação sempre vai para o
+// setor que NÃO tem o registro válido mais novo, então faltar energia no meio
+// dela deixa a configuração anterior intacta. Na leitura vale o registro
+// válido de maior sequência.
+//
+// Alterações são agrupadas: config_store_touch só marca a pendência, e o
+// laço principal grava uma vez depois de CONFIG_STORE_SAVE_DELAY_MS sem
+// novas alterações. Assim uma sequência de edições na interface vira um
+// único apagamento + programação, e a pausa do XIP acontece uma vez só.
+
+#define CONFIG_STORE_SAVE_DELAY_MS 3000
+
+// Layout fixo, sem padding (comparado e gravado byte a byte)
+struct station_config {
+    float temp_min_limit;
+    float temp_max_limit;
+    float humidity_min_limit;
+    float humidity_max_limit;
+    float pressure_min_limit;
+    float pressure_max_limit;
+    float temp_offset;
+    float humidity_offset;
+    float pressure_offset;
+    uint32_t alerts_enabled;
+};
+
+// Lê o registro válido mais novo; false se não houver (mantenha os padrões)
+bool config_store_load(struct station_config *config);
+
+// Marca a configuração como alterada. Pode ser chamada de interrupções.
+void config_store_touch(void);
+
+// true (uma vez) quando há alteração pendente e o período de silêncio passou
+bool config_store_due(uint32_t now_ms);
+
+// Grava se diferente do registro atual. Pausa a flash (XIP) por dezenas de ms
+// com as interrupções desligadas: chamar do laço principal, sem o lwIP travado.
+bool config_store_save(const struct station_config *config);
+
+#endif // CONFIG_STORE_H
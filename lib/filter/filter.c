@@ -0,0 +1,134 @@
+#include "filter.h"
+
+static void stage_init(struct filter_stage *stage, const struct filter_stage_config *config)
+{
+    *stage = (struct filter_stage){.kind = config->kind};
+    switch (config->kind) {
+    case FILTER_MEDIAN: {
+        uint8_t n = config->param < 3 ? 3 : config->param;
+        n = n > FILTER_MEDIAN_MAX ? FILTER_MEDIAN_MAX : n;
+        stage->median.n = n | 1; // Sempre ímpar (FILTER_MEDIAN_MAX também é)
+        break;
+    }
+    case FILTER_EMA:
+        stage->ema.shift = config->param > 8 ? 8 : config->param;
+        break;
+    case FILTER_KALMAN:
+        stage->kalman.q = config->q ? config->q : 1;
+        stage->kalman.r = config->r ? config->r : 1;
+        break;
+    default:
+        stage->kind = FILTER_NONE;
+        break;
+    }
+}
+
+void filter_chain_init(struct filter_chain *chain, const struct filter_stage_config *config, int count)
+{
+    chain->count = 0;
+    for (int i = 0; i < count && i < FILTER_MAX_STAGES && config[i].kind != FILTER_NONE; i++) {
+        stage_init(&chain->stage[chain->count++], &config[i]);
+    }
+}
+
+void filter_chain_reset(struct filter_chain *chain)
+{
+    for (int i = 0; i < chain->count; i++) {
+        chain->stage[i].primed = false;
+    }
+}
+
+static int32_t median_apply(struct filter_stage *stage, int32_t value)
+{
+    uint8_t n = stage->median.n;
+    if (!stage->primed) { // Janela cheia com o primeiro valor
+        for (int i = 0; i < n; i++) {
+            stage->median.window[i] = value;
+        }
+        stage->median.next = 0;
+        stage->primed = true;
+    }
+    stage->median.window[stage->median.next] = value;
+    stage->median.next = stage->median.next + 1 == n ? 0 : stage->median.next + 1;
+
+    // Ordenação por inserção de uma cópia: com N <= 9 são poucas comparações
+    int32_t sorted[FILTER_MEDIAN_MAX];
+    for (int i = 0; i < n; i++) {
+        int32_t v = stage->median.window[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    return sorted[n / 2];
+}
+
+static int32_t ema_apply(struct filter_stage *stage, int32_t value)
+{
+    int32_t scaled = value * (1 << FILTER_EMA_FRAC_BITS);
+    if (!stage->primed) {
+        stage->ema.state = scaled;
+        stage->primed = true;
+    }
+    stage->ema.state += (scaled - stage->ema.state) >> stage->ema.shift;
+    // Arredonda para o inteiro mais próximo (deslocamento aritmético)
+    return (stage->ema.state + (1 << (FILTER_EMA_FRAC_BITS - 1))) >> FILTER_EMA_FRAC_BITS;
+}
+
+// Ganho em Q16: k = p / (p + r); x += k (z - x); p = (1 - k) p.
+// A divisão é de 32 bits (o RP2040 tem divisor em hardware para ela):
+// p e r são reduzidos juntos até caberem em 16 bits, o que não muda a razão
+// além da precisão do próprio Q16.
+static int32_t kalman_apply(struct filter_stage *stage, int32_t value)
+{
+    if (!stage->primed) {
+        stage->kalman.x = value;
+        stage->kalman.p = stage->kalman.r;
+        stage->primed = true;
+        return value;
+    }
+    uint32_t p = stage->kalman.p + stage->kalman.q;
+    if (p < stage->kalman.q) {
+        p = UINT32_MAX; // Saturação em vez de dar a volta
+    }
+    uint32_t ps = p, rs = stage->kalman.r;
+    while ((ps | rs) >= (1u << 15)) {
+        ps >>= 1;
+        rs >>= 1;
+    }
+    uint32_t k = ps + rs ? (ps << 16) / (ps + rs) : 0;
+    int32_t innovation = value - stage->kalman.x;
+    stage->kalman.x += (int32_t)(((int64_t)innovation * k + (1 << 15)) >> 16);
+    stage->kalman.p = (uint32_t)(((uint64_t)p * (65536 - k)) >> 16);
+    return stage->kalman.x;
+}
+
+int32_t filter_stage_apply(struct filter_stage *stage, int32_t value)
+{
+    switch (stage->kind) {
+    case FILTER_MEDIAN: return median_apply(stage, value);
+    case FILTER_EMA:    return ema_apply(stage, value);
+    case FILTER_KALMAN: return kalman_apply(stage, value);
+    default:            return value;
+    }
+}
+
+int32_t filter_chain_apply(struct filter_chain *chain, int32_t value)
+{
+    for (int i = 0; i < chain->count; i++) {
+        value = filter_stage_apply(&chain->stage[i], value);
+    }
+    return value;
+}
+
+const char *filter_kind_name(uint8_t kind)
+{
+    switch (kind) {
+    case FILTER_MEDIAN: return "mediana";
+    case FILTER_EMA:    return "ema";
+    case FILTER_KALMAN: return "kalman";
+    default:            return "nenhum";
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Filtros em ponto fixo para um canal de medida (valores inteiros, em geral
+// centésimos), aplicados em sequência: a saída de um estágio é a entrada do
+// próximo. Todo o estado fica dentro de struct filter_chain (sem alocação).
+//
+//   - Mediana de N (N ímpar, até FILTER_MEDIAN_MAX): descarta leituras
+//     isoladas fora da curva; atrasa (N - 1) / 2 amostras.
+//   - Média móvel exponencial: y += (x - y) / 2^shift, com
+//     FILTER_EMA_FRAC_BITS bits de fração no estado para não perder resolução.
+//   - Kalman escalar (passeio aleatório): q = variância do processo por
+//     amostra, r = variância do ruído de medida, ambas em unidades² do canal.
+//     O ganho converge para um valor fixo e a suavização se ajusta sozinha.
+//
+// O primeiro valor que passa por um estágio inicializa seu estado (sem
+// transitório a partir de zero). Sem dependência do SDK (testes em tools/).
+
+#define FILTER_MAX_STAGES     3
+#define FILTER_MEDIAN_MAX     9
+#define FILTER_EMA_FRAC_BITS  4 // Pressão em 0,01 Pa (~1e7) << 4 ainda cabe em int32
+
+enum filter_kind {
+    FILTER_NONE,
+    FILTER_MEDIAN,
+    FILTER_EMA,
+    FILTER_KALMAN,
+};
+
+struct filter_stage_config {
+    uint8_t kind;           // enum filter_kind
+    uint8_t param;          // Mediana: N; EMA: shift
+    uint32_t q, r;          // Kalman
+};
+
+struct filter_stage {
+    uint8_t kind;
+    bool primed;
+    union {
+        struct {
+            uint8_t n, next;
+            int32_t window[FILTER_MEDIAN_MAX];
+        } median;
+        struct {
+            uint8_t shift;
+            int32_t state;  // Valor << FILTER_EMA_FRAC_BITS
+        } ema;
+        struct {
+            int32_t x;
+            uint32_t p, q, r;
+        } kalman;
+    };
+};
+
+struct filter_chain {
+    uint8_t count;
+    struct filter_stage stage[FILTER_MAX_STAGES];
+};
+
+// Monta a cadeia a partir de até FILTER_MAX_STAGES estágios (FILTER_NONE
+// encerra a lista antes). Parâmetros fora da faixa são ajustados.
+void filter_chain_init(struct filter_chain *chain, const struct filter_stage_config *config, int count);
+
+// Volta todos os estágios ao estado inicial, mantendo a configuração
+void filter_chain_reset(struct filter_chain *chain);
+
+// Passa uma amostra por todos os estágios e retorna a saída
+int32_t filter_chain_apply(struct filter_chain *chain, int32_t value);
+
+// Um estágio isolado (para medir o custo de cada um)
+int32_t filter_stage_apply(struct filter_stage *stage, int32_t value);
+
+const char *filter_kind_name(uint8_t kind);
+
+#endif // FILTER_H
@@ -0,0 +1,21 @@
+#ifndef FLASH_LAYOUT_H
+#define FLASH_LAYOUT_H
+
+// Mapa da flash: o firmware ocupa o início e os dados persistentes ficam no
+// fim, de cima para baixo. Cada módulo confere no boot que o binário
+// (__flash_binary_end) não chega à sua região.
+//
+//   PICO_FLASH_SIZE_BYTES
+//   | log em flash (lib/tslog)         512 KB
+//   | configuração (lib/config)        2 setores
+//   | ... livre ...
+//   | firmware
+//   0
+
+#define TSLOG_FLASH_SIZE          (512 * 1024)
+#define TSLOG_FLASH_OFFSET        (PICO_FLASH_SIZE_BYTES - TSLOG_FLASH_SIZE)
+
+#define CONFIG_STORE_FLASH_SIZE   (2 * 4096)
+#define CONFIG_STORE_FLASH_OFFSET (TSLOG_FLASH_OFFSET - CONFIG_STORE_FLASH_SIZE)
+
+#endif // FLASH_LAYOUT_H
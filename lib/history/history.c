@@ -0,0 +1,35 @@
+#include "history.h"
+
+#define HISTORY_MASK (HISTORY_CAPACITY - 1)
+
+// Buffer circular: a sequência identifica a posição (seq & HISTORY_MASK),
+// então as amostras não guardam o próprio número
+static struct history_sample history_ring[HISTORY_CAPACITY];
+static uint32_t history_next_seq = 1;
+
+uint32_t history_push(const struct history_sample *sample)
+{
+    uint32_t seq = history_next_seq++;
+    history_ring[seq & HISTORY_MASK] = *sample;
+    return seq;
+}
+
+uint32_t history_last_seq(void)
+{
+    return history_next_seq - 1;
+}
+
+uint32_t history_first_seq(void)
+{
+    uint32_t last = history_last_seq();
+    return last >= HISTORY_CAPACITY ? last - HISTORY_CAPACITY + 1 : 1;
+}
+
+bool history_get(uint32_t seq, struct history_sample *out)
+{
+    if (seq == 0 || seq > history_last_seq() || seq < history_first_seq()) {
+        return false;
+    }
+    *out = history_ring[seq & HISTORY_MASK];
+    return true;
+}
@@ -0,0 +1,32 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HISTORY_CAPACITY 1024 // Potência de 2; ~17 min a 1 amostra/s, 16 KB de RAM
+
+// Amostra guardada no histórico: ponto fixo, 16 bytes, sem float.
+// Também é o formato dos registros enviados por /history (little-endian).
+struct history_sample {
+    uint32_t time_ms;      // ms desde o boot
+    uint32_t pressure;     // 0,01 Pa
+    int16_t temp_aht;      // 0,01 °C
+    uint16_t humidity_aht; // 0,01 %
+    int16_t temp_bmp;      // 0,01 °C
+    uint16_t reserved;
+};
+
+// Acrescenta uma amostra, sobrescrevendo a mais antiga quando cheio.
+// Retorna o número de sequência atribuído (1, 2, 3...).
+// Escrita e leituras devem acontecer no mesmo contexto (aqui: com o lwIP travado).
+uint32_t history_push(const struct history_sample *sample);
+
+// Sequência da amostra mais recente (0 se vazio) e da mais antiga ainda guardada
+uint32_t history_last_seq(void);
+uint32_t history_first_seq(void);
+
+// Copia a amostra de sequência seq; false se ela já foi sobrescrita ou não existe
+bool history_get(uint32_t seq, struct history_sample *out);
+
+#endif // HISTORY_H
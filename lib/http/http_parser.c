@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include "lwip/def.h"
+#include "http_parser.h"
+
+void http_parser_reset(struct http_parser *parser)
+{
+    parser->state = HTTP_PARSE_REQUEST_LINE;
+    parser->error_status = 0;
+    parser->line_len = 0;
+    parser->header_bytes = 0;
+    parser->line_truncated = false;
+    memset(&parser->req, 0, sizeof(parser->req));
+    parser->req.accepts_gzip = true; // Sem Accept-Encoding, qualquer codificação serve
+}
+
+bool http_parser_idle(const struct http_parser *parser)
+{
+    return parser->state == HTTP_PARSE_REQUEST_LINE && parser->line_len == 0 && parser->header_bytes == 0;
+}
+
+const char *http_method_name(http_method_t method)
+{
+    switch (method) {
+        case HTTP_METHOD_GET:  return "GET";
+        case HTTP_METHOD_POST: return "POST";
+        default:               return "?";
+    }
+}
+
+static http_method_t parse_method(const char *token, size_t len)
+{
+    if (len == 3 && memcmp(token, "GET", 3) == 0) {
+        return HTTP_METHOD_GET;
+    }
+    if (len == 4 && memcmp(token, "POST", 4) == 0) {
+        return HTTP_METHOD_POST;
+    }
+    return HTTP_METHOD_OTHER;
+}
+
+bool http_query_u32(const char *query, const char *name, u32_t *value)
+{
+    size_t name_len = strlen(name);
+    const char *p = query;
+    while (*p) {
+        if (strncmp(p, name, name_len) == 0 && p[name_len] == '=') {
+            const char *digits = p + name_len + 1;
+            char *end;
+            unsigned long v = strtoul(digits, &end, 10);
+            if (end == digits || (*end != '\0' && *end != '&')) {
+                return false;
+            }
+            *value = (u32_t)v;
+            return true;
+        }
+        p = strchr(p, '&');
+        if (!p) {
+            break;
+        }
+        p++;
+    }
+    return false;
+}
+
+static void http_parser_fail(struct http_parser *parser, int status)
+{
+    parser->state = HTTP_PARSE_ERROR;
+    parser->error_status = status;
+}
+
+// Copia src para dst (tamanho size) até o delimitador ou o fim; false se não couber
+static bool copy_token(char *dst, size_t size, const char *src, size_t len)
+{
+    if (len >= size) {
+        return false;
+    }
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+    return true;
+}
+
+// "GET /caminho?query HTTP/1.1"
+static void parse_request_line(struct http_parser *parser)
+{
+    struct http_request *req = &parser->req;
+    if (parser->line_truncated) {
+        http_parser_fail(parser, 414);
+        return;
+    }
+    char *line = parser->line;
+    char *sp1 = strchr(line, ' ');
+    char *sp2 = sp1 ? strchr(sp1 + 1, ' ') : NULL;
+    if (!sp1 || !sp2 || sp1 == line) {
+        http_parser_fail(parser, 400);
+        return;
+    }
+    req->method = parse_method(line, sp1 - line);
+
+    char *target = sp1 + 1;
+    size_t target_len = sp2 - target;
+    char *query = memchr(target, '?', target_len);
+    size_t path_len = query ? (size_t)(query - target) : target_len;
+    if (!copy_token(req->path, sizeof(req->path), target, path_len)) {
+        http_parser_fail(parser, 414);
+        return;
+    }
+    if (query && !copy_token(req->query, sizeof(req->query), query + 1, target_len - path_len - 1)) {
+        http_parser_fail(parser, 414);
+        return;
+    }
+
+    const char *version = sp2 + 1;
+    if (strncmp(version, "HTTP/1.", 7) != 0) {
+        http_parser_fail(parser, 400);
+        return;
+    }
+    // HTTP/1.1 mantém a conexão por padrão; HTTP/1.0 fecha após a resposta
+    req->keep_alive = (version[7] == '1');
+    parser->state = HTTP_PARSE_HEADERS;
+}
+
+// Valor de q ("0", "0.0", "0.000"...) que recusa a codificação
+static bool q_is_zero(const char *q, const char *end)
+{
+    if (q == end || *q != '0') {
+        return false;
+    }
+    for (q++; q < end && *q != ' ' && *q != '\t' && *q != ';'; q++) {
+        if (*q != '.' && *q != '0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Accept-Encoding (RFC 9110, 12.5.3): gzip/x-gzip explícito vale mais que "*".
+// Só chega aqui com o cabeçalho presente; a ausência dele aceita qualquer uma.
+static bool accepts_gzip(const char *value)
+{
+    int gzip = -1; // -1: não citado
+    int any = -1;
+    while (*value) {
+        while (*value == ' ' || *value == '\t' || *value == ',') {
+            value++;
+        }
+        const char *name = value;
+        while (*value && *value != ',' && *value != ';' && *value != ' ' && *value != '\t') {
+            value++;
+        }
+        size_t len = (size_t)(value - name);
+        const char *end = strchr(value, ',');
+        if (!end) {
+            end = value + strlen(value);
+        }
+        bool accepted = true;
+        for (const char *p = value; p + 2 <= end; p++) {
+            if ((p[0] == 'q' || p[0] == 'Q') && p[1] == '=') {
+                accepted = !q_is_zero(p + 2, end);
+                break;
+            }
+        }
+        if ((len == 4 && strncasecmp(name, "gzip", 4) == 0) || (len == 6 && strncasecmp(name, "x-gzip", 6) == 0)) {
+            gzip = accepted;
+        } else if (len == 1 && *name == '*') {
+            any = accepted;
+        }
+        value = end;
+    }
+    return gzip >= 0 ? gzip : any == 1;
+}
+
+// Interpreta um cabeçalho; os que a aplicação não usa são ignorados
+static void parse_header_line(struct http_parser *parser)
+{
+    struct http_request *req = &parser->req;
+    char *colon = strchr(parser->line, ':');
+    if (!colon) {
+        http_parser_fail(parser, 400);
+        return;
+    }
+    *colon = '\0';
+    char *value = colon + 1;
+    while (*value == ' ' || *value == '\t') {
+        value++;
+    }
+
+    if (strcasecmp(parser->line, "Content-Length") == 0) {
+        char *end;
+        unsigned long length = strtoul(value, &end, 10);
+        if (end == value || parser->line_truncated) {
+            http_parser_fail(parser, 400);
+        } else if (length > HTTP_BODY_MAX) {
+            http_parser_fail(parser, 413);
+        } else {
+            req->content_length = length;
+        }
+    } else if (strcasecmp(parser->line, "Transfer-Encoding") == 0) {
+        // Corpo em chunks não é suportado: ignorá-lo faria os chunks serem
+        // lidos como a próxima requisição da conexão (desync/smuggling)
+        http_parser_fail(parser, 501);
+    } else if (strcasecmp(parser->line, "Connection") == 0) {
+        if (strncasecmp(value, "close", 5) == 0) {
+            req->keep_alive = false;
+        } else if (strncasecmp(value, "keep-alive", 10) == 0) {
+            req->keep_alive = true;
+        }
+    } else if (strcasecmp(parser->line, "If-None-Match") == 0 && !parser->line_truncated) {
+        // Listas que não cabem são ignoradas (resposta 200 completa)
+        copy_token(req->if_none_match, sizeof(req->if_none_match), value, strlen(value));
+    } else if (strcasecmp(parser->line, "Accept-Encoding") == 0) {
+        req->accepts_gzip = accepts_gzip(value); // Linha cortada: vale o que coube
+    } else if (strcasecmp(parser->line, "Upgrade") == 0) {
+        req->upgrade_websocket = (strncasecmp(value, "websocket", 9) == 0);
+    } else if (strcasecmp(parser->line, "Sec-WebSocket-Key") == 0 && !parser->line_truncated) {
+        copy_token(req->ws_key, sizeof(req->ws_key), value, strlen(value));
+    }
+}
+
+// Linha completa (sem CRLF) no buffer
+static void parse_line(struct http_parser *parser)
+{
+    if (parser->state == HTTP_PARSE_REQUEST_LINE) {
+        if (parser->line_len == 0) {
+            return; // CRLF extra entre requisições é tolerado (RFC 9112, 2.2)
+        }
+        parse_request_line(parser);
+    } else if (parser->line_len == 0) {
+        // Linha vazia: fim dos cabeçalhos
+        parser->state = parser->req.content_length ? HTTP_PARSE_BODY : HTTP_PARSE_DONE;
+    } else {
+        parse_header_line(parser);
+    }
+}
+
+u16_t http_parser_feed(struct http_parser *parser, const char *data, u16_t len)
+{
+    u16_t i = 0;
+    while (i < len && parser->state != HTTP_PARSE_DONE && parser->state != HTTP_PARSE_ERROR) {
+        if (parser->state == HTTP_PARSE_BODY) {
+            struct http_request *req = &parser->req;
+            u16_t n = LWIP_MIN((u32_t)(len - i), req->content_length - req->body_len);
+            memcpy(req->body + req->body_len, data + i, n);
+            req->body_len += n;
+            i += n;
+            if (req->body_len == req->content_length) {
+                req->body[req->body_len] = '\0';
+                parser->state = HTTP_PARSE_DONE;
+            }
+            continue;
+        }
+
+        // Sem teto, um cliente mandando cabeçalhos aos poucos nunca terminaria
+        if (++parser->header_bytes > HTTP_HEADERS_MAX) {
+            http_parser_fail(parser, 431);
+            break;
+        }
+        char c = data[i++];
+        if (c == '\n') {
+            if (parser->line_len && parser->line[parser->line_len - 1] == '\r') {
+                parser->line_len--;
+            }
+            parser->line[parser->line_len] = '\0';
+            parse_line(parser);
+            parser->line_len = 0;
+            parser->line_truncated = false;
+        } else if (parser->line_len < HTTP_LINE_MAX - 1) {
+            parser->line[parser->line_len++] = c;
+        } else {
+            parser->line_truncated = true; // Excesso descartado; só o início importa
+        }
+    }
+    return i;
+}
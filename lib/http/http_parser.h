@@ -0,0 +1,73 @@
+#ifndef HTTP_PARSER_H
+#define HTTP_PARSER_H
+
+#include <stdbool.h>
+#include "lwip/arch.h"
+
+#define HTTP_LINE_MAX       128 // Maior linha (request-line ou cabeçalho) guardada por inteiro
+#define HTTP_HEADERS_MAX    1024 // Request-line + cabeçalhos de uma requisição; acima disso, 431
+#define HTTP_PATH_MAX       64  // Caminho da URL, sem a query string
+#define HTTP_ETAG_MAX       112 // Valor do If-None-Match: lista que caiba numa linha (5 ETags de 18 caracteres)
+#define HTTP_BODY_MAX       256 // Maior corpo aceito em POST (JSON de limites/offsets)
+#define HTTP_WS_KEY_MAX     32  // Sec-WebSocket-Key (16 bytes em base64 = 24 caracteres)
+
+// Métodos reconhecidos; os demais chegam como HTTP_METHOD_OTHER (405 no roteador)
+typedef enum {
+    HTTP_METHOD_GET,
+    HTTP_METHOD_POST,
+    HTTP_METHOD_OTHER
+} http_method_t;
+
+// Requisição já interpretada, entregue ao handler da aplicação
+struct http_request {
+    http_method_t method;
+    char path[HTTP_PATH_MAX];
+    char query[HTTP_PATH_MAX];        // Tudo após '?', sem o '?'
+    char if_none_match[HTTP_ETAG_MAX]; // Vazio se ausente ou maior que o buffer
+    char ws_key[HTTP_WS_KEY_MAX];     // Sec-WebSocket-Key, vazio se ausente
+    char body[HTTP_BODY_MAX + 1];     // Terminado em '\0' para facilitar o sscanf
+    u16_t body_len;
+    u32_t content_length;
+    bool keep_alive;                  // HTTP/1.1 sem "Connection: close"
+    bool upgrade_websocket;           // "Upgrade: websocket"
+    bool accepts_gzip;                // Sem Accept-Encoding, ou com gzip (ou *) e q diferente de 0
+};
+
+typedef enum {
+    HTTP_PARSE_REQUEST_LINE,
+    HTTP_PARSE_HEADERS,
+    HTTP_PARSE_BODY,
+    HTTP_PARSE_DONE,
+    HTTP_PARSE_ERROR
+} http_parse_state_t;
+
+// Parser incremental: recebe os bytes conforme chegam, em qualquer fragmentação
+struct http_parser {
+    http_parse_state_t state;
+    int error_status;        // Status HTTP a responder em HTTP_PARSE_ERROR (400, 413, 414, 431, 501...)
+    u16_t line_len;
+    u16_t header_bytes;      // Bytes da request-line e dos cabeçalhos até aqui
+    bool line_truncated;
+    char line[HTTP_LINE_MAX];
+    struct http_request req;
+};
+
+// Nome do método para logs
+const char *http_method_name(http_method_t method);
+
+// Lê o parâmetro numérico name da query string ("since=42&x=1");
+// false se ausente ou inválido
+bool http_query_u32(const char *query, const char *name, u32_t *value);
+
+// Prepara o parser para a próxima requisição da conexão
+void http_parser_reset(struct http_parser *parser);
+
+// true entre requisições: nenhum byte da próxima chegou ainda
+bool http_parser_idle(const struct http_parser *parser);
+
+// Consome bytes até completar uma requisição (HTTP_PARSE_DONE), detectar um
+// erro (HTTP_PARSE_ERROR) ou esgotar os dados. Retorna quantos bytes foram
+// consumidos; bytes de uma requisição seguinte (pipelining) ficam de fora.
+u16_t http_parser_feed(struct http_parser *parser, const char *data, u16_t len);
+
+#endif // HTTP_PARSER_H
@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <string.h>
+#include "http_router.h"
+#include "log/dlog.h"
+
+static const struct http_route *http_route_find(const struct http_router *router, const char *path)
+{
+    u16_t lo = 0;
+    u16_t hi = router->count;
+    while (lo < hi) {
+        u16_t mid = (lo + hi) / 2;
+        int cmp = strcmp(path, router->routes[mid].path);
+        if (cmp == 0) {
+            return &router->routes[mid];
+        }
+        if (cmp < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+bool http_router_check(const struct http_router *router)
+{
+    for (u16_t i = 1; i < router->count; i++) {
+        if (strcmp(router->routes[i - 1].path, router->routes[i].path) >= 0) {
+            printf("Erro: rotas fora de ordem em %s\n", router->routes[i].path);
+            return false;
+        }
+    }
+    return true;
+}
+
+void http_router_stats_init(const struct http_router *router)
+{
+    for (u16_t i = 0; router->stats && i <= router->count; i++) {
+        router->stats[i].duration.buckets = &metrics_buckets_http;
+    }
+}
+
+// "Allow: GET, POST\r\n" para a resposta 405
+static void http_allow_header(u8_t methods, char *buf, size_t size)
+{
+    int len = snprintf(buf, size, "Allow: ");
+    for (int m = 0; m < HTTP_METHOD_OTHER; m++) {
+        if (methods & (1u << m)) {
+            len += snprintf(buf + len, size - len, "%s%s", len > 7 ? ", " : "", http_method_name(m));
+        }
+    }
+    snprintf(buf + len, size - len, "\r\n");
+}
+
+err_t http_router_dispatch(const struct http_router *router, struct tcp_pcb *tpcb,
+                           struct http_state *hs, const struct http_request *req)
+{
+    const struct http_route *route = http_route_find(router, req->path);
+    // O log guarda só o ponteiro: o caminho da tabela vive para sempre, o
+    // da requisição não
+    DLOG_DEBUG("DEBUG: Requisição recebida: %s %s\n", http_method_name(req->method),
+               route ? route->path : "(fora da tabela)");
+    if (router->stats) {
+        hs->route_stats = &router->stats[route ? route - router->routes : router->count];
+        metrics_inc(&hs->route_stats->requests);
+    }
+    if (!route) {
+        if (router->fallback) {
+            return router->fallback(tpcb, hs, req);
+        }
+        return http_send_error(tpcb, hs, 404, NULL);
+    }
+    if (!(route->methods & (1u << req->method))) {
+        char allow[32];
+        http_allow_header(route->methods, allow, sizeof(allow));
+        return http_send_error(tpcb, hs, 405, allow);
+    }
+    return route->handler(tpcb, hs, req);
+}
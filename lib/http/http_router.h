@@ -0,0 +1,50 @@
+#ifndef HTTP_ROUTER_H
+#define HTTP_ROUTER_H
+
+#include "http_server.h"
+#include "metrics/metrics.h"
+
+// Máscara de métodos aceitos por uma rota
+#define HTTP_ALLOW_GET  (1u << HTTP_METHOD_GET)
+#define HTTP_ALLOW_POST (1u << HTTP_METHOD_POST)
+
+// Uma rota por caminho exato. A escolha depende só do caminho e do método
+// já interpretados na request-line; cabeçalhos e corpo não são examinados.
+struct http_route {
+    const char *path;
+    u8_t methods;            // HTTP_ALLOW_*
+    http_handler_fn handler;
+};
+
+// Contadores de uma rota para /metrics, atualizados no contexto do lwIP
+struct http_route_stats {
+    struct metrics_counter requests;
+    // Da requisição completa ao último byte da resposta confirmado pelo
+    // cliente; streams (SSE, WebSocket) ficam de fora
+    struct metrics_histogram duration;
+};
+
+// Tabela de rotas em tempo de compilação, ORDENADA por path (strcmp):
+// a busca é binária, então novas rotas não deixam as existentes mais lentas.
+// Caminhos fora da tabela vão para o fallback (arquivos estáticos), que
+// responde 404 quando também não os conhece.
+struct http_router {
+    const struct http_route *routes;
+    u16_t count;
+    http_handler_fn fallback;
+    // count + 1 contadores em RAM, o último para o fallback; NULL: sem métricas
+    struct http_route_stats *stats;
+};
+
+// Confere a ordenação da tabela; false (e log) se estiver fora de ordem
+bool http_router_check(const struct http_router *router);
+
+// Prepara os contadores das rotas (chamada por http_server_start)
+void http_router_stats_init(const struct http_router *router);
+
+// Encontra a rota e chama o handler; responde 405 (com Allow) se o caminho
+// existe mas não aceita o método. Retorna ERR_ABRT se a conexão foi abortada.
+err_t http_router_dispatch(const struct http_router *router, struct tcp_pcb *tpcb,
+                           struct http_state *hs, const struct http_request *req);
+
+#endif // HTTP_ROUTER_H
@@ -0,0 +1,527 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/time.h"
+#include "http_server.h"
+#include "http_router.h"
+#include "http_sse.h"
+#include "http_ws.h"
+#include "trace/trace.h"
+#include "log/dlog.h"
+
+#define HTTP_HEADER_MAX 256 // Cabeçalho montado na pilha e copiado para o lwIP
+#define HTTP_POLL_INTERVAL 2 // tcp_poll em unidades de 500 ms: 1 chamada por segundo
+// Espaço mínimo no buffer de envio para despachar a próxima requisição
+// (cabeçalho + maior corpo copiado); abaixo disso espera pelo próximo ACK
+#define HTTP_DISPATCH_MIN_SNDBUF 1024
+#define HTTP_FILL_CHUNK 512 // Buffer na pilha para corpos gerados por http_body_fill_fn
+#define HTTP_REJECT_POLL_INTERVAL 4 // Conexão recusada é abortada após 2 s se o cliente não fechar
+
+static const struct http_router *http_router;
+
+// Pool estático de estados: a pilha de índices livres dá alocação e
+// liberação O(1) e o uso de RAM fica fixo desde o boot
+static struct http_state http_pool[HTTP_MAX_CONNECTIONS];
+static u8_t http_free_stack[HTTP_MAX_CONNECTIONS];
+static u8_t http_free_top;
+static struct http_server_stats http_stats;
+
+// Resposta enviada quando o pool está vazio: vive na flash, nenhum estado é criado
+static const char http_503_response[] =
+    "HTTP/1.1 503 Service Unavailable\r\n"
+    "Retry-After: 2\r\n"
+    "Content-Length: 0\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+static void http_pool_init(void)
+{
+    for (u8_t i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        http_free_stack[i] = HTTP_MAX_CONNECTIONS - 1 - i;
+    }
+    http_free_top = HTTP_MAX_CONNECTIONS;
+}
+
+static struct http_state *http_state_alloc(void)
+{
+    if (http_free_top == 0) {
+        return NULL;
+    }
+    struct http_state *hs = &http_pool[http_free_stack[--http_free_top]];
+    memset(hs, 0, sizeof(*hs));
+    http_stats.active++;
+    if (http_stats.active > http_stats.high_water) {
+        http_stats.high_water = http_stats.active;
+    }
+    http_stats.accepted++;
+    return hs;
+}
+
+static const char *http_status_text(int status)
+{
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 414: return "URI Too Long";
+        case 431: return "Request Header Fields Too Large";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default:  return "Internal Server Error";
+    }
+}
+
+static void http_state_free(struct http_state *hs)
+{
+    if (hs->mode == HTTP_MODE_SSE) {
+        http_sse_unsubscribe(hs);
+    } else if (hs->mode == HTTP_MODE_WEBSOCKET) {
+        http_ws_unsubscribe(hs);
+    }
+    if (hs->rx) {
+        pbuf_free(hs->rx);
+    }
+    hs->pcb = NULL;
+    hs->rx = NULL;
+    http_free_stack[http_free_top++] = (u8_t)(hs - http_pool);
+    http_stats.active--;
+}
+
+static void http_detach(struct tcp_pcb *tpcb)
+{
+    tcp_arg(tpcb, NULL);
+    tcp_sent(tpcb, NULL);
+    tcp_recv(tpcb, NULL);
+    tcp_err(tpcb, NULL);
+    tcp_poll(tpcb, NULL, 0);
+}
+
+// Encerra a conexão e libera o estado. Retorna ERR_ABRT se o pcb foi abortado.
+static err_t http_close(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    http_detach(tpcb);
+    http_state_free(hs);
+    if (tcp_close(tpcb) != ERR_OK) {
+        tcp_abort(tpcb); // Sem memória para o FIN: descarta a conexão
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+static err_t http_abort(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    http_detach(tpcb);
+    http_state_free(hs);
+    tcp_abort(tpcb);
+    return ERR_ABRT;
+}
+
+// Entrega ao lwIP o próximo pedaço do corpo, limitado pelo espaço livre no
+// buffer de envio. O restante segue quando chegarem ACKs (http_sent).
+static void http_send_more(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    while (hs->body_queued < hs->body_len) {
+        u32_t chunk = LWIP_MIN(hs->body_len - hs->body_queued, (u32_t)tcp_sndbuf(tpcb));
+        chunk = LWIP_MIN(chunk, 0xFFFFu); // tcp_write recebe u16_t
+        if (chunk == 0) {
+            break; // Buffer cheio: aguarda ACK
+        }
+        u8_t flags = (hs->body_queued + chunk < hs->body_len) ? TCP_WRITE_FLAG_MORE : 0;
+        const void *data = hs->body + hs->body_queued;
+        u8_t fill_buf[HTTP_FILL_CHUNK];
+        if (hs->fill) {
+            // Corpo gerado: copiado para o lwIP, pois fill_buf é temporário
+            chunk = hs->fill(hs->fill_arg, hs->body_queued, fill_buf, (u16_t)LWIP_MIN(chunk, sizeof(fill_buf)));
+            if (chunk == 0) {
+                // Dados sumiram no meio da resposta: encerra com o corpo incompleto
+                hs->body_len = hs->body_queued;
+                hs->close_after = true;
+                break;
+            }
+            data = fill_buf;
+            flags = TCP_WRITE_FLAG_COPY | ((hs->body_queued + chunk < hs->body_len) ? TCP_WRITE_FLAG_MORE : 0);
+        }
+        err_t err = tcp_write(tpcb, data, (u16_t)chunk, flags);
+        if (err == ERR_MEM) {
+            http_stats.write_mem++;
+            break; // Fila de segmentos cheia: tenta de novo no próximo ACK ou poll
+        }
+        if (err != ERR_OK) {
+            DLOG_DEBUG("DEBUG: tcp_write falhou (%d)\n", err);
+            break;
+        }
+        hs->body_queued += chunk;
+        hs->unacked += chunk;
+    }
+    tcp_output(tpcb);
+}
+
+static bool http_response_pending(const struct http_state *hs)
+{
+    return hs->body_queued < hs->body_len;
+}
+
+// Fecha a medida da requisição na rota (/metrics): quando a resposta foi toda
+// confirmada, ou antes de despachar a seguinte (pipelining: a anterior já
+// saiu inteira para o lwIP). Streams só contam a requisição.
+static void http_request_finish(struct http_state *hs)
+{
+    if (hs->route_stats && hs->mode == HTTP_MODE_REQUEST) {
+        metrics_observe(&hs->route_stats->duration, time_us_32() - hs->request_start_us);
+    }
+    hs->route_stats = NULL;
+}
+
+// Interpreta as requisições acumuladas em hs->rx, uma por vez: a próxima só é
+// despachada depois que o corpo da resposta anterior foi todo enfileirado.
+static err_t http_process(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    while (!http_response_pending(hs)) {
+        if (hs->remote_closed && hs->mode != HTTP_MODE_REQUEST) {
+            return http_close(tpcb, hs); // Cliente saiu do stream: nada mais a entregar
+        }
+        if (hs->close_after || (hs->remote_closed && !hs->rx)) {
+            // Fecha quando o último byte for confirmado (ou já, se nada está pendente)
+            return hs->unacked ? ERR_OK : http_close(tpcb, hs);
+        }
+        if (!hs->rx) {
+            return ERR_OK;
+        }
+        if (hs->mode == HTTP_MODE_WEBSOCKET) {
+            // Consome os frames completos; um frame de close marca close_after
+            http_ws_process(tpcb, hs);
+            if (!hs->close_after) {
+                return ERR_OK;
+            }
+            continue;
+        }
+        if (hs->mode != HTTP_MODE_REQUEST) {
+            // Streams só enviam: o que o cliente mandar depois é descartado
+            tcp_recved(tpcb, hs->rx->tot_len);
+            pbuf_free(hs->rx);
+            hs->rx = NULL;
+            return ERR_OK;
+        }
+        if (tcp_sndbuf(tpcb) < HTTP_DISPATCH_MIN_SNDBUF || tcp_sndqueuelen(tpcb) + 4 > TCP_SND_QUEUELEN) {
+            return ERR_OK; // Respostas anteriores ainda ocupam o buffer: continua em http_sent
+        }
+
+        struct pbuf *seg = hs->rx;
+        u16_t used = http_parser_feed(&hs->parser, (const char *)seg->payload, seg->len);
+        if (used == seg->len) {
+            // Segmento inteiro consumido (inclusive de tamanho zero): sai da cadeia
+            hs->rx = seg->next;
+            seg->next = NULL;
+            pbuf_free(seg);
+        } else {
+            hs->rx = pbuf_free_header(seg, used);
+        }
+        if (used) {
+            tcp_recved(tpcb, used);
+        }
+
+        struct http_parser *parser = &hs->parser;
+        err_t err = ERR_OK;
+        if (parser->state == HTTP_PARSE_DONE || parser->state == HTTP_PARSE_ERROR) {
+            hs->request_ticks = 0; // O prazo da próxima conta do primeiro byte dela
+        }
+        if (parser->state == HTTP_PARSE_DONE) {
+            http_request_finish(hs);
+            hs->request_start_us = time_us_32();
+            hs->close_after = !parser->req.keep_alive;
+            err = http_router_dispatch(http_router, tpcb, hs, &parser->req);
+            http_parser_reset(parser);
+        } else if (parser->state == HTTP_PARSE_ERROR) {
+            // Após um erro de sintaxe não dá para achar o início da próxima requisição
+            int status = parser->error_status;
+            hs->close_after = true;
+            http_parser_reset(parser);
+            err = http_send_error(tpcb, hs, status, NULL);
+        }
+        if (err == ERR_ABRT) {
+            return ERR_ABRT;
+        }
+    }
+    return ERR_OK;
+}
+
+// Função de callback chamada quando o cliente confirma dados enviados
+static err_t http_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
+{
+    struct http_state *hs = (struct http_state *)arg;
+    if (!hs) {
+        return ERR_OK;
+    }
+    TRACE_BEGIN(HTTP_SENT, len);
+    hs->unacked -= LWIP_MIN(len, hs->unacked);
+    hs->idle_ticks = 0;
+    http_stats.bytes_acked += len;
+    if (http_response_pending(hs)) {
+        http_send_more(tpcb, hs);
+        if (http_response_pending(hs)) {
+            TRACE_END(HTTP_SENT, len);
+            return ERR_OK;
+        }
+    }
+    if (!hs->unacked) {
+        http_request_finish(hs);
+    }
+    err_t ret = http_process(tpcb, hs);
+    TRACE_END(HTTP_SENT, len);
+    return ret;
+}
+
+// Função de recebimento HTTP: os pbufs entram na fila e são interpretados aos poucos
+static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
+{
+    struct http_state *hs = (struct http_state *)arg;
+    if (!hs) {
+        // Conexão recusada com 503: descarta o pedido e fecha quando o cliente fechar
+        if (p) {
+            tcp_recved(tpcb, p->tot_len);
+            pbuf_free(p);
+        } else if (tcp_close(tpcb) != ERR_OK) {
+            tcp_abort(tpcb);
+            return ERR_ABRT;
+        }
+        return ERR_OK;
+    }
+    u16_t rx_len = p ? p->tot_len : 0;
+    TRACE_BEGIN(HTTP_RECV, rx_len);
+    if (!p) { // Se não há pbuf, a conexão foi fechada pelo cliente
+        hs->remote_closed = true;
+    } else if (hs->rx) {
+        pbuf_cat(hs->rx, p);
+    } else {
+        hs->rx = p;
+    }
+    hs->idle_ticks = 0;
+    err_t ret = http_process(tpcb, hs);
+    TRACE_END(HTTP_RECV, rx_len);
+    return ret;
+}
+
+// Chamado a cada segundo: fecha conexões ociosas e retoma envios travados por ERR_MEM
+static err_t http_poll(void *arg, struct tcp_pcb *tpcb)
+{
+    struct http_state *hs = (struct http_state *)arg;
+    if (!hs) {
+        tcp_abort(tpcb); // Conexão recusada que o cliente não fechou a tempo
+        return ERR_ABRT;
+    }
+    if (http_response_pending(hs)) {
+        http_send_more(tpcb, hs);
+        return ERR_OK;
+    }
+    if (hs->mode == HTTP_MODE_SSE) {
+        http_sse_poll(tpcb, hs);
+        return ERR_OK;
+    }
+    if (hs->mode == HTTP_MODE_WEBSOCKET) {
+        return http_ws_poll(tpcb, hs) ? http_close(tpcb, hs) : ERR_OK;
+    }
+    if (http_parser_idle(&hs->parser)) {
+        hs->request_ticks = 0;
+    } else if (++hs->request_ticks >= HTTP_REQUEST_TIMEOUT_S) {
+        DLOG_DEBUG("DEBUG: Requisicao incompleta apos %d s, fechando a conexao.\n", HTTP_REQUEST_TIMEOUT_S);
+        return http_close(tpcb, hs);
+    }
+    if (++hs->idle_ticks >= HTTP_IDLE_TIMEOUT_S && hs->unacked == 0) {
+        return http_close(tpcb, hs);
+    }
+    return ERR_OK;
+}
+
+// Conexão abortada pelo lwIP (RST, timeout): o pcb já foi liberado
+static void http_err(void *arg, err_t err)
+{
+    if (arg) {
+        http_state_free((struct http_state *)arg);
+    }
+}
+
+// Pool vazio: responde 503 direto da flash, sem estado, e encerra o envio.
+// O que o cliente mandar é descartado em http_recv até ele fechar.
+static err_t http_reject(struct tcp_pcb *newpcb)
+{
+    http_stats.rejected++;
+    DLOG_DEBUG("DEBUG: Pool de conexoes cheio, respondendo 503 (%lu recusadas).\n",
+           (unsigned long)http_stats.rejected);
+    tcp_arg(newpcb, NULL);
+    tcp_recv(newpcb, http_recv);
+    tcp_poll(newpcb, http_poll, HTTP_REJECT_POLL_INTERVAL);
+    if (tcp_write(newpcb, http_503_response, sizeof(http_503_response) - 1, 0) != ERR_OK) {
+        tcp_abort(newpcb);
+        return ERR_ABRT;
+    }
+    tcp_shutdown(newpcb, 0, 1); // FIN logo após a resposta
+    tcp_output(newpcb);
+    return ERR_OK;
+}
+
+// Função de callback para aceitar conexões TCP
+static err_t http_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+    if (err != ERR_OK || !newpcb) {
+        return ERR_VAL;
+    }
+    struct http_state *hs = http_state_alloc();
+    if (!hs) {
+        return http_reject(newpcb);
+    }
+    hs->pcb = newpcb;
+    http_parser_reset(&hs->parser);
+
+    tcp_arg(newpcb, hs);
+    tcp_recv(newpcb, http_recv);
+    tcp_sent(newpcb, http_sent);
+    tcp_err(newpcb, http_err);
+    tcp_poll(newpcb, http_poll, HTTP_POLL_INTERVAL);
+    tcp_nagle_disable(newpcb); // Respostas já são escritas em blocos grandes
+    return ERR_OK;
+}
+
+bool http_server_start(u16_t port, const struct http_router *router)
+{
+    if (!http_router_check(router)) {
+        return false;
+    }
+    struct tcp_pcb *pcb = tcp_new();
+    if (!pcb)
+    {
+        printf("Erro ao criar PCB TCP\n");
+        return false;
+    }
+    if (tcp_bind(pcb, IP_ADDR_ANY, port) != ERR_OK)
+    {
+        printf("Erro ao ligar o servidor na porta %u\n", port);
+        tcp_close(pcb);
+        return false;
+    }
+    http_router = router;
+    http_router_stats_init(router);
+    http_pool_init();
+    pcb = tcp_listen(pcb);
+    tcp_accept(pcb, http_accept);
+    printf("Servidor HTTP rodando na porta %u...\n", port);
+    return true;
+}
+
+const struct http_server_stats *http_server_get_stats(void)
+{
+    return &http_stats;
+}
+
+void http_server_reset_high_water(void)
+{
+    http_stats.high_water = http_stats.active;
+}
+
+static err_t http_send_response_ex(struct tcp_pcb *tpcb, struct http_state *hs,
+                                   int status, const char *content_type, const char *extra_headers,
+                                   const char *body, u32_t body_len, http_body_mode_t mode,
+                                   http_body_fill_fn fill, u32_t fill_arg)
+{
+    char header[HTTP_HEADER_MAX];
+    int header_len = snprintf(header, sizeof(header),
+                              "HTTP/1.1 %d %s\r\n"
+                              "Content-Type: %s\r\n"
+                              "Content-Length: %lu\r\n"
+                              "%s"
+                              "Connection: %s\r\n"
+                              "\r\n",
+                              status, http_status_text(status), content_type,
+                              (unsigned long)body_len,
+                              extra_headers ? extra_headers : "",
+                              hs->close_after ? "close" : "keep-alive");
+    if (header_len < 0 || (size_t)header_len >= sizeof(header)) {
+        // extra_headers grande demais: um 500 sem eles sempre cabe
+        DLOG_ERROR("Erro: cabecalho de %d bytes excede HTTP_HEADER_MAX (%d)\n", header_len, HTTP_HEADER_MAX);
+        return http_send_response_ex(tpcb, hs, 500, "text/plain", NULL, NULL, 0, HTTP_BODY_STATIC, NULL, 0);
+    }
+
+    hs->body = NULL;
+    hs->body_len = 0;
+    hs->body_queued = 0;
+    hs->fill = NULL;
+
+    u8_t flags = TCP_WRITE_FLAG_COPY | (body_len ? TCP_WRITE_FLAG_MORE : 0);
+    err_t err = tcp_write(tpcb, header, (u16_t)header_len, flags);
+    if (err != ERR_OK) {
+        http_stats.write_mem += err == ERR_MEM;
+        return http_abort(tpcb, hs);
+    }
+    hs->unacked += header_len;
+
+    if (body_len && mode == HTTP_BODY_COPY) {
+        // Corpos dinâmicos são pequenos (JSON, mensagens) e cabem no buffer de envio
+        err = tcp_write(tpcb, body, (u16_t)body_len, TCP_WRITE_FLAG_COPY);
+        if (err != ERR_OK) {
+            http_stats.write_mem += err == ERR_MEM;
+            return http_abort(tpcb, hs);
+        }
+        hs->unacked += body_len;
+        tcp_output(tpcb);
+        return ERR_OK;
+    }
+
+    hs->body = body;
+    hs->body_len = body_len;
+    hs->fill = fill;
+    hs->fill_arg = fill_arg;
+    http_send_more(tpcb, hs);
+    return ERR_OK;
+}
+
+bool http_stream_write(struct http_state *hs, const void *data, u16_t len)
+{
+    struct tcp_pcb *tpcb = hs->pcb;
+    if (http_response_pending(hs) || tcp_sndbuf(tpcb) < len || tcp_sndqueuelen(tpcb) + 2 > TCP_SND_QUEUELEN) {
+        http_stats.stream_drops++; // Cabeçalho do stream ainda saindo, ou cliente lento
+        return false;
+    }
+    err_t err = tcp_write(tpcb, data, len, TCP_WRITE_FLAG_COPY);
+    if (err != ERR_OK) {
+        http_stats.write_mem += err == ERR_MEM;
+        http_stats.stream_drops++;
+        return false;
+    }
+    hs->unacked += len;
+    tcp_output(tpcb);
+    return true;
+}
+
+err_t http_send_response(struct tcp_pcb *tpcb, struct http_state *hs,
+                         int status, const char *content_type,
+                         const char *body, u32_t body_len, http_body_mode_t mode)
+{
+    return http_send_response_ex(tpcb, hs, status, content_type, NULL, body, body_len, mode, NULL, 0);
+}
+
+err_t http_send_generated(struct tcp_pcb *tpcb, struct http_state *hs,
+                          int status, const char *content_type, const char *extra_headers,
+                          u32_t body_len, http_body_fill_fn fill, u32_t fill_arg)
+{
+    return http_send_response_ex(tpcb, hs, status, content_type, extra_headers,
+                                 NULL, body_len, HTTP_BODY_STATIC, fill, fill_arg);
+}
+
+err_t http_send_error(struct tcp_pcb *tpcb, struct http_state *hs, int status,
+                      const char *extra_headers)
+{
+    const char *msg = http_status_text(status); // Constante na flash: enviada sem cópia
+    return http_send_response_ex(tpcb, hs, status, "text/plain", extra_headers,
+                                 msg, strlen(msg), HTTP_BODY_STATIC, NULL, 0);
+}
+
+err_t http_send_static(struct tcp_pcb *tpcb, struct http_state *hs,
+                       const char *response, u32_t response_len)
+{
+    hs->body = response;
+    hs->body_len = response_len;
+    hs->body_queued = 0;
+    hs->fill = NULL;
+    http_send_more(tpcb, hs);
+    return ERR_OK;
+}
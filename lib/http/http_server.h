@@ -0,0 +1,116 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <stdbool.h>
+#include "lwip/tcp.h"
+#include "http_parser.h"
+
+#define HTTP_IDLE_TIMEOUT_S 15 // Conexão persistente ociosa é fechada após este tempo
+// Prazo para uma requisição chegar inteira (request-line, cabeçalhos e corpo),
+// contado do primeiro byte e não renovado por dados recebidos: um cliente que
+// manda um cabeçalho a cada poucos segundos não segura o estado para sempre
+#define HTTP_REQUEST_TIMEOUT_S 10
+// Estados de conexão alocados estaticamente; acima disso o servidor responde
+// 503 sem alocar nada. MEMP_NUM_TCP_PCB (lwipopts.h) deve ser maior, para
+// sobrar pcb para as respostas 503 e conexões em TIME_WAIT.
+#define HTTP_MAX_CONNECTIONS 12
+
+// Modo da conexão: requisição/resposta ou stream aberto pelo handler
+typedef enum {
+    HTTP_MODE_REQUEST,
+    HTTP_MODE_SSE,     // text/event-stream (http_sse.h)
+    HTTP_MODE_WEBSOCKET // Frames WebSocket nos dois sentidos (http_ws.h)
+} http_mode_t;
+
+struct http_route_stats; // http_router.h
+
+// Gera o corpo sob demanda: escreve até max bytes a partir de offset em buf
+// e retorna quantos escreveu (0 = dados não estão mais disponíveis)
+typedef u16_t (*http_body_fill_fn)(u32_t arg, u32_t offset, u8_t *buf, u16_t max);
+
+// Estado de uma conexão HTTP persistente. Não guarda cópia da resposta: o
+// cabeçalho é copiado para o lwIP no momento do envio e o corpo é apontado
+// diretamente (dados const em flash), sendo entregue ao tcp_write aos poucos.
+struct http_state
+{
+    struct tcp_pcb *pcb;
+    struct pbuf *rx;       // Bytes recebidos ainda não interpretados (pipelining)
+    const char *body;      // Corpo ainda a transmitir (sem cópia)
+    u32_t body_len;        // Tamanho total do corpo
+    u32_t body_queued;     // Bytes do corpo já entregues ao tcp_write
+    u32_t unacked;         // Bytes entregues ao lwIP aguardando ACK
+    http_body_fill_fn fill; // Corpo gerado em pedaços (em vez de body), ou NULL
+    u32_t fill_arg;
+    u8_t idle_ticks;       // Chamadas de tcp_poll (1 s) sem atividade
+    u8_t request_ticks;    // Chamadas de tcp_poll desde o início da requisição incompleta
+    u8_t mode;             // http_mode_t
+    bool close_after;      // Fecha a conexão quando a resposta atual terminar
+    bool remote_closed;    // Cliente enviou FIN
+    struct http_route_stats *route_stats; // Rota da resposta em andamento (/metrics), ou NULL
+    u32_t request_start_us; // Requisição completa recebida (time_us_32)
+    struct http_parser parser;
+};
+
+// Contadores do pool de conexões
+struct http_server_stats {
+    u16_t active;      // Estados em uso agora
+    u16_t high_water;  // Maior valor de active desde o boot (ou o último reset)
+    u32_t accepted;    // Conexões aceitas com estado alocado
+    u32_t rejected;    // Conexões recusadas com 503 (pool vazio)
+    u32_t bytes_acked; // Bytes de resposta confirmados pelos clientes
+    u32_t write_mem;   // tcp_write sem memória (ERR_MEM): envio adiado ou conexão abortada
+    u32_t stream_drops; // Mensagens de SSE/WebSocket descartadas (buffer cheio)
+};
+
+// Forma de entrega do corpo da resposta
+typedef enum {
+    HTTP_BODY_STATIC, // Ponteiro para dados que vivem até o fim do envio (flash): sem cópia
+    HTTP_BODY_COPY    // Buffer temporário (pilha): copiado pelo lwIP na hora
+} http_body_mode_t;
+
+// Handler da aplicação: chamado uma vez por requisição completa, deve responder
+// com http_send_response ou http_send_static e devolver o retorno delas.
+typedef err_t (*http_handler_fn)(struct tcp_pcb *tpcb, struct http_state *hs,
+                                 const struct http_request *req);
+
+struct http_router; // http_router.h
+
+// Cria o pcb de escuta na porta indicada e passa a despachar as requisições
+// pela tabela de rotas (que deve viver até o fim do programa)
+bool http_server_start(u16_t port, const struct http_router *router);
+
+// Contadores atualizados no contexto do lwIP; leitura apenas informativa
+const struct http_server_stats *http_server_get_stats(void);
+
+// Recomeça o high_water do valor atual de active (início de um benchmark)
+void http_server_reset_high_water(void);
+
+// Envia cabeçalho + corpo. Corpos estáticos são enviados em pedaços do
+// tamanho de tcp_sndbuf() e continuados a partir de http_sent.
+// Retorna ERR_ABRT se a conexão precisou ser abortada (hs deixa de existir).
+err_t http_send_response(struct tcp_pcb *tpcb, struct http_state *hs,
+                         int status, const char *content_type,
+                         const char *body, u32_t body_len, http_body_mode_t mode);
+
+// Envia cabeçalho e um corpo de body_len bytes produzido por fill conforme
+// houver espaço no buffer de envio (dados que mudam, como o histórico).
+// extra_headers: linhas adicionais terminadas em "\r\n", ou NULL.
+err_t http_send_generated(struct tcp_pcb *tpcb, struct http_state *hs,
+                          int status, const char *content_type, const char *extra_headers,
+                          u32_t body_len, http_body_fill_fn fill, u32_t fill_arg);
+
+// Resposta de erro com o texto do status como corpo (400, 404, 405...).
+// extra_headers: linhas adicionais terminadas em "\r\n" (ex.: Allow), ou NULL.
+err_t http_send_error(struct tcp_pcb *tpcb, struct http_state *hs, int status,
+                      const char *extra_headers);
+
+// Envia uma resposta pronta (cabeçalho incluso) que vive na flash, sem cópia
+err_t http_send_static(struct tcp_pcb *tpcb, struct http_state *hs,
+                       const char *response, u32_t response_len);
+
+// Escrita em conexões de stream (SSE, WebSocket): copia os bytes para o lwIP
+// só se houver espaço no buffer e na fila de envio; caso contrário descarta e
+// retorna false. Nada é enfileirado na aplicação para clientes lentos.
+bool http_stream_write(struct http_state *hs, const void *data, u16_t len);
+
+#endif // HTTP_SERVER_H
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <string.h>
+#include "http_sse.h"
+#include "log/dlog.h"
+
+static const char sse_header[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n"
+    "retry: 3000\n\n"; // Reconexão do EventSource após 3 s
+
+static const char sse_ping[] = ": ping\n\n";
+
+static struct http_state *sse_clients[HTTP_SSE_MAX_CLIENTS];
+static u8_t sse_client_count;
+
+err_t http_sse_subscribe(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    if (sse_client_count >= HTTP_SSE_MAX_CLIENTS) {
+        static const char msg[] = "Limite de clientes /events atingido.";
+        hs->close_after = true;
+        return http_send_response(tpcb, hs, 503, "text/plain", msg, sizeof(msg) - 1, HTTP_BODY_STATIC);
+    }
+    for (u8_t i = 0; i < HTTP_SSE_MAX_CLIENTS; i++) {
+        if (!sse_clients[i]) {
+            sse_clients[i] = hs;
+            break;
+        }
+    }
+    sse_client_count++;
+    hs->mode = HTTP_MODE_SSE;
+    hs->close_after = false;
+    hs->idle_ticks = 0;
+    DLOG_DEBUG("DEBUG: Cliente /events conectado (%u ativos).\n", sse_client_count);
+    return http_send_static(tpcb, hs, sse_header, sizeof(sse_header) - 1);
+}
+
+void http_sse_unsubscribe(struct http_state *hs)
+{
+    for (u8_t i = 0; i < HTTP_SSE_MAX_CLIENTS; i++) {
+        if (sse_clients[i] == hs) {
+            sse_clients[i] = NULL;
+            sse_client_count--;
+            return;
+        }
+    }
+}
+
+void http_sse_broadcast(const char *frame, u16_t len)
+{
+    for (u8_t i = 0; i < HTTP_SSE_MAX_CLIENTS; i++) {
+        struct http_state *hs = sse_clients[i];
+        if (hs && http_stream_write(hs, frame, len)) {
+            hs->idle_ticks = 0;
+        }
+    }
+}
+
+u8_t http_sse_client_count(void)
+{
+    return sse_client_count;
+}
+
+void http_sse_poll(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    // Sem eventos há algum tempo (amostragem parada, cliente lento): mantém a conexão viva
+    if (++hs->idle_ticks >= HTTP_SSE_PING_S) {
+        hs->idle_ticks = 0;
+        http_stream_write(hs, sse_ping, sizeof(sse_ping) - 1);
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef HTTP_SSE_H
+#define HTTP_SSE_H
+
+#include "http_server.h"
+
+#define HTTP_SSE_MAX_CLIENTS 6  // Conexões /events simultâneas (somadas às do /ws, abaixo de HTTP_MAX_CONNECTIONS)
+#define HTTP_SSE_PING_S      15 // Comentário periódico para manter a conexão viva
+
+// Transforma a conexão em um stream text/event-stream. Retorna ERR_ABRT se a
+// conexão foi abortada; responde 503 se não houver vaga para mais clientes.
+err_t http_sse_subscribe(struct tcp_pcb *tpcb, struct http_state *hs);
+
+// Envia o mesmo evento já serializado ("data: ...\n\n") a todos os inscritos.
+// Clientes sem espaço no buffer de envio perdem este evento e recebem o próximo.
+// Fora dos callbacks do lwIP deve ser chamado entre cyw43_arch_lwip_begin/end.
+void http_sse_broadcast(const char *frame, u16_t len);
+
+// Quantidade de clientes inscritos (evita serializar quando não há ninguém)
+u8_t http_sse_client_count(void);
+
+// Usados pelo http_server: remoção ao fechar a conexão e ping no tcp_poll
+void http_sse_unsubscribe(struct http_state *hs);
+void http_sse_poll(struct tcp_pcb *tpcb, struct http_state *hs);
+
+#endif // HTTP_SSE_H
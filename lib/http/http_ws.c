@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <string.h>
+#include "http_ws.h"
+#include "sha1.h"
+#include "log/dlog.h"
+
+#define WS_OP_TEXT   0x1
+#define WS_OP_BINARY 0x2
+#define WS_OP_CLOSE  0x8
+#define WS_OP_PING   0x9
+#define WS_OP_PONG   0xA
+
+#define WS_CLOSE_PROTOCOL_ERROR 1002
+#define WS_CLOSE_UNSUPPORTED    1003
+#define WS_CLOSE_TOO_BIG        1009
+
+#define WS_HEADER_LEN 2 // Payload <= 125: sem tamanho estendido
+#define WS_MASK_LEN   4 // Frames do cliente sempre têm máscara
+
+static const char ws_guid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+struct ws_client {
+    struct http_state *hs;
+    http_ws_message_fn on_message;
+};
+
+static struct ws_client ws_clients[HTTP_WS_MAX_CLIENTS];
+static u8_t ws_client_count;
+
+static void base64_encode(const u8_t *in, size_t len, char *out)
+{
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        u32_t v = (u32_t)in[i] << 16;
+        if (i + 1 < len) v |= (u32_t)in[i + 1] << 8;
+        if (i + 2 < len) v |= in[i + 2];
+        out[o++] = table[(v >> 18) & 0x3F];
+        out[o++] = table[(v >> 12) & 0x3F];
+        out[o++] = (i + 1 < len) ? table[(v >> 6) & 0x3F] : '=';
+        out[o++] = (i + 2 < len) ? table[v & 0x3F] : '=';
+    }
+    out[o] = '\0';
+}
+
+static struct ws_client *ws_find(const struct http_state *hs)
+{
+    for (u8_t i = 0; i < HTTP_WS_MAX_CLIENTS; i++) {
+        if (ws_clients[i].hs == hs) {
+            return &ws_clients[i];
+        }
+    }
+    return NULL;
+}
+
+// Monta um frame do servidor (FIN + opcode, sem máscara) em buf; retorna o tamanho
+static u16_t ws_frame(u8_t *buf, u8_t opcode, const void *data, u16_t len)
+{
+    buf[0] = 0x80 | opcode;
+    buf[1] = (u8_t)len;
+    memcpy(buf + WS_HEADER_LEN, data, len);
+    return WS_HEADER_LEN + len;
+}
+
+static bool ws_send_frame(struct http_state *hs, u8_t opcode, const void *data, u16_t len)
+{
+    u8_t frame[WS_HEADER_LEN + HTTP_WS_PAYLOAD_MAX];
+    if (len > HTTP_WS_PAYLOAD_MAX) {
+        return false;
+    }
+    return http_stream_write(hs, frame, ws_frame(frame, opcode, data, len));
+}
+
+// Envia o frame de close e descarta o que o cliente mandar depois dele
+static void ws_close(struct http_state *hs, u16_t code)
+{
+    u8_t payload[2] = {(u8_t)(code >> 8), (u8_t)code};
+    ws_send_frame(hs, WS_OP_CLOSE, payload, sizeof(payload));
+    hs->close_after = true;
+}
+
+err_t http_ws_upgrade(struct tcp_pcb *tpcb, struct http_state *hs,
+                      const struct http_request *req, http_ws_message_fn on_message)
+{
+    if (!req->upgrade_websocket || req->ws_key[0] == '\0') {
+        static const char msg[] = "Upgrade WebSocket esperado.";
+        return http_send_response(tpcb, hs, 400, "text/plain", msg, sizeof(msg) - 1, HTTP_BODY_STATIC);
+    }
+    if (ws_client_count >= HTTP_WS_MAX_CLIENTS) {
+        static const char msg[] = "Limite de clientes /ws atingido.";
+        hs->close_after = true;
+        return http_send_response(tpcb, hs, 503, "text/plain", msg, sizeof(msg) - 1, HTTP_BODY_STATIC);
+    }
+
+    // Sec-WebSocket-Accept = base64(SHA-1(chave + GUID))
+    char key[HTTP_WS_KEY_MAX + sizeof(ws_guid)];
+    size_t key_len = strlen(req->ws_key);
+    memcpy(key, req->ws_key, key_len);
+    memcpy(key + key_len, ws_guid, sizeof(ws_guid) - 1);
+    u8_t digest[SHA1_DIGEST_LEN];
+    sha1(key, key_len + sizeof(ws_guid) - 1, digest);
+    char accept[32];
+    base64_encode(digest, sizeof(digest), accept);
+
+    char header[160];
+    int header_len = snprintf(header, sizeof(header),
+                              "HTTP/1.1 101 Switching Protocols\r\n"
+                              "Upgrade: websocket\r\n"
+                              "Connection: Upgrade\r\n"
+                              "Sec-WebSocket-Accept: %s\r\n"
+                              "\r\n",
+                              accept);
+    if (!http_stream_write(hs, header, (u16_t)header_len)) {
+        hs->close_after = true; // Sem espaço para o handshake: encerra normalmente
+        return ERR_OK;
+    }
+
+    for (u8_t i = 0; i < HTTP_WS_MAX_CLIENTS; i++) {
+        if (!ws_clients[i].hs) {
+            ws_clients[i].hs = hs;
+            ws_clients[i].on_message = on_message;
+            break;
+        }
+    }
+    ws_client_count++;
+    hs->mode = HTTP_MODE_WEBSOCKET;
+    hs->close_after = false;
+    hs->idle_ticks = 0;
+    DLOG_DEBUG("DEBUG: Cliente /ws conectado (%u ativos).\n", ws_client_count);
+    return ERR_OK;
+}
+
+void http_ws_unsubscribe(struct http_state *hs)
+{
+    struct ws_client *client = ws_find(hs);
+    if (client) {
+        client->hs = NULL;
+        client->on_message = NULL;
+        ws_client_count--;
+    }
+}
+
+bool http_ws_send(struct http_state *hs, const void *data, u16_t len)
+{
+    return ws_send_frame(hs, WS_OP_BINARY, data, len);
+}
+
+void http_ws_broadcast(const void *data, u16_t len)
+{
+    u8_t frame[WS_HEADER_LEN + HTTP_WS_PAYLOAD_MAX];
+    if (len > HTTP_WS_PAYLOAD_MAX) {
+        return;
+    }
+    u16_t frame_len = ws_frame(frame, WS_OP_BINARY, data, len);
+    for (u8_t i = 0; i < HTTP_WS_MAX_CLIENTS; i++) {
+        struct http_state *hs = ws_clients[i].hs;
+        if (hs && !hs->close_after) {
+            http_stream_write(hs, frame, frame_len);
+        }
+    }
+}
+
+u8_t http_ws_client_count(void)
+{
+    return ws_client_count;
+}
+
+// Interpreta os frames completos acumulados em hs->rx. Frames incompletos
+// ficam na fila até chegar o restante; como o payload é limitado a
+// HTTP_WS_PAYLOAD_MAX, a fila nunca passa de um frame parcial.
+void http_ws_process(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    while (hs->rx && !hs->close_after) {
+        struct pbuf *rx = hs->rx;
+        if (rx->tot_len < WS_HEADER_LEN) {
+            return;
+        }
+        u8_t b0 = pbuf_get_at(rx, 0);
+        u8_t b1 = pbuf_get_at(rx, 1);
+        u8_t opcode = b0 & 0x0F;
+        u16_t len = b1 & 0x7F;
+        if ((b0 & 0x70) || !(b1 & 0x80)) {
+            ws_close(hs, WS_CLOSE_PROTOCOL_ERROR); // Bits reservados ou frame sem máscara
+            break;
+        }
+        if (!(b0 & 0x80) || opcode == 0x0) {
+            ws_close(hs, WS_CLOSE_UNSUPPORTED); // Mensagens fragmentadas não são usadas
+            break;
+        }
+        if (len > HTTP_WS_PAYLOAD_MAX) {
+            ws_close(hs, WS_CLOSE_TOO_BIG);
+            break;
+        }
+        u16_t frame_len = WS_HEADER_LEN + WS_MASK_LEN + len;
+        if (rx->tot_len < frame_len) {
+            return;
+        }
+
+        u8_t mask[WS_MASK_LEN];
+        u8_t payload[HTTP_WS_PAYLOAD_MAX];
+        pbuf_copy_partial(rx, mask, WS_MASK_LEN, WS_HEADER_LEN);
+        pbuf_copy_partial(rx, payload, len, WS_HEADER_LEN + WS_MASK_LEN);
+        hs->rx = pbuf_free_header(rx, frame_len);
+        tcp_recved(tpcb, frame_len);
+        for (u16_t i = 0; i < len; i++) {
+            payload[i] ^= mask[i & 3];
+        }
+
+        switch (opcode) {
+            case WS_OP_BINARY: {
+                struct ws_client *client = ws_find(hs);
+                if (client && client->on_message) {
+                    client->on_message(hs, payload, len);
+                }
+                break;
+            }
+            case WS_OP_PING:
+                ws_send_frame(hs, WS_OP_PONG, payload, len);
+                break;
+            case WS_OP_PONG:
+                break;
+            case WS_OP_CLOSE:
+                // Ecoa o código recebido e fecha depois que o frame for confirmado
+                ws_send_frame(hs, WS_OP_CLOSE, payload, LWIP_MIN(len, 2));
+                hs->close_after = true;
+                break;
+            default: // Texto e opcodes desconhecidos: o protocolo é só binário
+                ws_close(hs, WS_CLOSE_UNSUPPORTED);
+                break;
+        }
+    }
+
+    if (hs->close_after && hs->rx) {
+        tcp_recved(tpcb, hs->rx->tot_len);
+        pbuf_free(hs->rx);
+        hs->rx = NULL;
+    }
+}
+
+bool http_ws_poll(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    // idle_ticks é zerado a cada ACK ou dado recebido: um cliente que sumiu
+    // deixa de confirmar as amostras e é descartado após HTTP_WS_TIMEOUT_S
+    hs->idle_ticks++;
+    if (hs->idle_ticks >= HTTP_WS_TIMEOUT_S) {
+        DLOG_DEBUG("DEBUG: Cliente /ws sem resposta, fechando.\n");
+        return true;
+    }
+    if (hs->idle_ticks == HTTP_WS_PING_S) {
+        ws_send_frame(hs, WS_OP_PING, "", 0);
+    }
+    return false;
+}
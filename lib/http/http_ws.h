@@ -0,0 +1,39 @@
+#ifndef HTTP_WS_H
+#define HTTP_WS_H
+
+#include "http_server.h"
+
+#define HTTP_WS_MAX_CLIENTS  4   // Conexões /ws simultâneas
+#define HTTP_WS_PAYLOAD_MAX  125 // Maior mensagem aceita/enviada (cabeçalho de 2 bytes)
+#define HTTP_WS_PING_S       15  // Sem tráfego por este tempo: envia ping
+#define HTTP_WS_TIMEOUT_S    30  // Sem ACK nem dados por este tempo: fecha
+
+// Mensagem binária recebida de um cliente (payload já sem máscara).
+// Roda no contexto do lwIP; pode responder com http_ws_send/broadcast.
+typedef void (*http_ws_message_fn)(struct http_state *hs, const u8_t *data, u16_t len);
+
+// Responde ao pedido de upgrade (101 + Sec-WebSocket-Accept) e passa a
+// conexão para frames WebSocket. Responde 400 se o pedido não for um upgrade
+// válido e 503 se não houver vaga. Retorna ERR_ABRT se a conexão foi abortada.
+err_t http_ws_upgrade(struct tcp_pcb *tpcb, struct http_state *hs,
+                      const struct http_request *req, http_ws_message_fn on_message);
+
+// Envia uma mensagem binária a um cliente. Retorna false (mensagem perdida)
+// se não houver espaço no buffer de envio.
+bool http_ws_send(struct http_state *hs, const void *data, u16_t len);
+
+// Envia a mesma mensagem binária a todos os clientes, montando o frame uma
+// única vez (frames do servidor não têm máscara). Fora dos callbacks do lwIP
+// deve ser chamado entre cyw43_arch_lwip_begin/end.
+void http_ws_broadcast(const void *data, u16_t len);
+
+// Quantidade de clientes conectados (evita montar amostras sem ninguém ouvindo)
+u8_t http_ws_client_count(void);
+
+// Usados pelo http_server: frames recebidos, remoção ao fechar e tcp_poll.
+// http_ws_poll retorna true quando a conexão deve ser fechada.
+void http_ws_process(struct tcp_pcb *tpcb, struct http_state *hs);
+void http_ws_unsubscribe(struct http_state *hs);
+bool http_ws_poll(struct tcp_pcb *tpcb, struct http_state *hs);
+
+#endif // HTTP_WS_H
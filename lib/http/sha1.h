@@ -0,0 +1,13 @@
+#ifndef SHA1_H
+#define SHA1_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA1_DIGEST_LEN 20
+
+// SHA-1 de um bloco contíguo. Usado apenas no handshake WebSocket
+// (Sec-WebSocket-Accept, RFC 6455), onde não há requisito de segurança.
+void sha1(const void *data, size_t len, uint8_t digest[SHA1_DIGEST_LEN]);
+
+#endif // SHA1_H
@@ -0,0 +1,73 @@
+#include <string.h>
+#include "lwip/apps/fs.h"
+#include "web_assets.h"
+
+static const char not_acceptable[] =
+    "HTTP/1.1 406 Not Acceptable\r\n"
+    "Content-Type: text/plain\r\n"
+    "Content-Length: 48\r\n"
+    "Vary: Accept-Encoding\r\n"
+    "\r\n"
+    "Use Accept-Encoding: gzip (ou curl --compressed)";
+
+// If-None-Match (RFC 9110, 13.1.2): "*" ou uma lista de ETags separados por
+// vírgula, comparados sem o prefixo fraco W/
+static bool etag_matches(const char *etag, const char *value, size_t value_len)
+{
+    size_t etag_len = strlen(etag);
+    const char *end = value + value_len;
+    while (value < end) {
+        while (value < end && (*value == ' ' || *value == '\t' || *value == ',')) {
+            value++;
+        }
+        const char *item = value;
+        while (value < end && *value != ',') {
+            value++;
+        }
+        const char *item_end = value;
+        while (item_end > item && (item_end[-1] == ' ' || item_end[-1] == '\t')) {
+            item_end--;
+        }
+        if (item_end - item == 1 && *item == '*') {
+            return true;
+        }
+        if (item_end - item > 2 && item[0] == 'W' && item[1] == '/') {
+            item += 2;
+        }
+        if ((size_t)(item_end - item) == etag_len && memcmp(item, etag, etag_len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool web_asset_lookup(const char *path, bool accepts_gzip, const char *if_none_match, size_t if_none_match_len,
+                      const char **response, u32_t *response_len)
+{
+    for (u16_t i = 0; i < web_assets_count; i++) {
+        const struct web_asset *asset = &web_assets[i];
+        if (strcmp(asset->path, path) != 0) {
+            continue;
+        }
+        if (!accepts_gzip) {
+            *response = not_acceptable;
+            *response_len = sizeof(not_acceptable) - 1;
+            return true;
+        }
+        if (if_none_match && etag_matches(asset->etag, if_none_match, if_none_match_len)) {
+            *response = asset->not_modified;
+            *response_len = asset->not_modified_len;
+            return true;
+        }
+        struct fs_file file;
+        if (fs_open(&file, path) != ERR_OK) {
+            return false;
+        }
+        // Arquivos gerados com o cabeçalho HTTP embutido: a resposta inteira está na flash
+        *response = file.data;
+        *response_len = (u32_t)file.len;
+        fs_close(&file);
+        return true;
+    }
+    return false;
+}
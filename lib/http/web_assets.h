@@ -0,0 +1,29 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwip/arch.h"
+
+// Metadados de cada arquivo web gerado em build (tools/gerar_fsdata.py).
+// O conteúdo (resposta 200 com gzip) fica no fs do lwIP; aqui ficam o ETag
+// e a resposta 304 pronta, ambos na flash.
+struct web_asset {
+    const char *path;         // Caminho da URL, ex.: "/index.html"
+    const char *etag;         // ETag forte, com aspas
+    const char *not_modified; // Resposta 304 completa
+    u16_t not_modified_len;
+};
+
+extern const struct web_asset web_assets[];
+extern const u16_t web_assets_count;
+
+// Resolve o caminho para a resposta pronta na flash. Se o If-None-Match do
+// cliente (valor do cabeçalho, pode ser NULL) for "*" ou uma lista com o ETag
+// atual, devolve o 304; caso contrário, a resposta 200 completa. Só existe a
+// versão gzip (não há espaço na flash para outra cópia do Chart.js): sem
+// gzip no Accept-Encoding a resposta é 406. Retorna false se não existe.
+bool web_asset_lookup(const char *path, bool accepts_gzip, const char *if_none_match, size_t if_none_match_len,
+                      const char **response, u32_t *response_len);
+
+#endif // WEB_ASSETS_H
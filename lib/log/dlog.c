@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include "hardware/sync.h"
+#include "dlog.h"
+
+// Um anel por núcleo, com um produtor (o núcleo; as interrupções dele
+// disputam o mesmo anel) e um consumidor (dlog_drain no núcleo 0). O M0+
+// não tem LDREX/STREX: o registro é gravado com as interrupções do núcleo
+// desligadas por poucos ciclos, e entre os núcleos não há trava nenhuma.
+// head só avança com o registro completo; tail só avança depois da cópia.
+struct dlog_ring {
+    struct dlog_record record[DLOG_RECORDS];
+    volatile uint32_t head;   // Escrito pelo produtor
+    volatile uint32_t tail;   // Escrito pelo consumidor
+    volatile uint32_t dropped; // Anel cheio (escrito pelo produtor)
+    uint32_t dropped_seen;    // Já avisado pelo consumidor
+};
+
+static struct dlog_ring rings[2];
+
+void dlog_put(uint8_t level, const char *fmt, const uintptr_t *arg, uint8_t argc)
+{
+    uint32_t now = time_us_32();
+    struct dlog_ring *ring = &rings[get_core_num()];
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t head = ring->head;
+    if (head - ring->tail >= DLOG_RECORDS) {
+        ring->dropped++;
+    } else {
+        struct dlog_record *r = &ring->record[head & (DLOG_RECORDS - 1)];
+        r->fmt = fmt;
+        r->time_us = now;
+        r->level = level;
+        r->argc = argc;
+        for (uint8_t i = 0; i < argc; i++) {
+            r->arg[i] = arg[i];
+        }
+        __dmb();
+        ring->head = head + 1;
+    }
+    restore_interrupts(irq);
+}
+
+#ifdef ESTACAO_LOG_BINARY
+
+// "#dlog " e o registro em hexadecimal: formato, tempo, nível, argc e os
+// argumentos, em palavras de 32 bits little-endian. Só o PC formata,
+// procurando as strings no ELF do firmware (tools/dlog_decode.py); as
+// linhas comuns do printf continuam legíveis no meio.
+int dlog_format(char *out, size_t size, const struct dlog_record *r)
+{
+    static const char hex[] = "0123456789abcdef";
+    uint32_t word[3 + DLOG_MAX_ARGS] = {
+        (uint32_t)(uintptr_t)r->fmt, r->time_us, (uint32_t)r->level | (uint32_t)r->argc << 8,
+    };
+    for (uint8_t i = 0; i < r->argc; i++) {
+        word[3 + i] = (uint32_t)r->arg[i];
+    }
+    size_t len = (size_t)snprintf(out, size, "#dlog ");
+    for (unsigned i = 0; i < 3u + r->argc && len + 9 < size; i++) {
+        for (unsigned b = 0; b < 4; b++) {
+            uint8_t byte = (uint8_t)(word[i] >> (8 * b));
+            out[len++] = hex[byte >> 4];
+            out[len++] = hex[byte & 0xF];
+        }
+    }
+    out[len++] = '\n';
+    out[len] = '\0';
+    return (int)len;
+}
+
+#else
+
+static double dlog_float(uintptr_t bits)
+{
+    uint32_t word = (uint32_t)bits;
+    float f;
+    memcpy(&f, &word, sizeof(f));
+    return f;
+}
+
+// O formato é percorrido como o printf faria; cada conversão é repassada ao
+// snprintf com o tipo certo, sem os modificadores de tamanho (todo
+// argumento tem 32 bits)
+int dlog_format(char *out, size_t size, const struct dlog_record *r)
+{
+    size_t len = 0;
+    uint8_t next = 0;
+    const char *p = r->fmt;
+    while (*p && len + 1 < size) {
+        if (*p != '%') {
+            out[len++] = *p++;
+            continue;
+        }
+        char spec[16];
+        size_t n = 0;
+        spec[n++] = *p++;
+        while (*p && strchr("-+ #0123456789.", *p) && n < sizeof(spec) - 2) {
+            spec[n++] = *p++;
+        }
+        while (*p && strchr("hlzjtL", *p)) {
+            p++;
+        }
+        char conv = *p ? *p++ : '\0';
+        spec[n++] = conv;
+        spec[n] = '\0';
+        if (conv == '%') {
+            out[len++] = '%';
+            continue;
+        }
+        if (!conv || next >= r->argc) {
+            break; // Formato cortado ou argumento faltando
+        }
+        uintptr_t arg = r->arg[next++];
+        int w;
+        switch (conv) {
+        case 'd': case 'i':
+            w = snprintf(out + len, size - len, spec, (int)arg);
+            break;
+        case 's':
+            w = snprintf(out + len, size - len, spec, arg ? (const char *)arg : "(null)");
+            break;
+        case 'p':
+            w = snprintf(out + len, size - len, spec, (void *)arg);
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            w = snprintf(out + len, size - len, spec, dlog_float(arg));
+            break;
+        default: // u, x, X, o, c
+            w = snprintf(out + len, size - len, spec, (unsigned)arg);
+            break;
+        }
+        if (w < 0) {
+            break;
+        }
+        len += (size_t)w < size - len ? (size_t)w : size - len - 1;
+    }
+    out[len] = '\0';
+    return (int)len;
+}
+
+#endif // ESTACAO_LOG_BINARY
+
+bool dlog_drain(unsigned max)
+{
+    char line[192];
+    for (unsigned core = 0; core < count_of(rings); core++) {
+        struct dlog_ring *ring = &rings[core];
+        uint32_t dropped = ring->dropped;
+        if (dropped != ring->dropped_seen) {
+            printf("Log: %lu mensagens descartadas no nucleo %u (anel cheio)\n",
+                   (unsigned long)(dropped - ring->dropped_seen), core);
+            ring->dropped_seen = dropped;
+        }
+        while (max && ring->tail != ring->head) {
+            __dmb();
+            struct dlog_record r = ring->record[ring->tail & (DLOG_RECORDS - 1)];
+            __dmb();
+            ring->tail++; // A posição pode ser reusada: o registro já foi copiado
+            dlog_format(line, sizeof(line), &r);
+            fputs(line, stdout);
+            max--;
+        }
+    }
+    return rings[0].tail != rings[0].head || rings[1].tail != rings[1].head;
+}
@@ -0,0 +1,129 @@
+#ifndef DLOG_H
+#define DLOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "pico/stdlib.h"
+
+// Log adiado: quem chama só guarda o ponteiro do formato (a string fica na
+// flash e serve de identificador) e os argumentos crus num anel em RAM; a
+// formatação e a saída pela USB/UART ficam para dlog_drain, chamada no
+// núcleo 0 quando o laço de eventos não tem mais trabalho. Um printf no
+// callback do lwIP ou no laço de leitura trava quando o host USB está lento
+// ou ausente; aqui a chamada custa poucas centenas de ns e nunca espera.
+//
+//   DLOG_INFO("Sensor %s: %d.%02d C", s->label, v / 100, v % 100);
+//
+// Restrições dos argumentos (no máximo DLOG_MAX_ARGS):
+//  - inteiros de até 32 bits; modificadores de tamanho (l, h, z) são
+//    ignorados e "%ll" não é suportado
+//  - float/double viram float (32 bits), o bastante para "%.2f"
+//  - "%s" guarda só o ponteiro: a string precisa existir até o drain
+//    (literais e rótulos const, nunca buffers na pilha)
+//
+// Níveis abaixo de DLOG_LEVEL (definido pelo CMake, ESTACAO_LOG_LEVEL) somem
+// na compilação, com argumentos e string.
+
+#define DLOG_LEVEL_NONE  0
+#define DLOG_LEVEL_ERROR 1
+#define DLOG_LEVEL_WARN  2
+#define DLOG_LEVEL_INFO  3
+#define DLOG_LEVEL_DEBUG 4
+
+#ifndef DLOG_LEVEL
+#define DLOG_LEVEL DLOG_LEVEL_DEBUG
+#endif
+
+#define DLOG_MAX_ARGS 7
+#define DLOG_RECORDS  64 // Por núcleo (potência de 2)
+
+struct dlog_record {
+    const char *fmt;
+    uint32_t time_us;           // time_us_32 da chamada
+    uint8_t level;
+    uint8_t argc;
+    uintptr_t arg[DLOG_MAX_ARGS];
+};
+
+// Grava um registro no anel do núcleo atual; anel cheio descarta o registro
+// (contado e avisado no drain). Use as macros abaixo.
+void dlog_put(uint8_t level, const char *fmt, const uintptr_t *arg, uint8_t argc);
+
+// Formata e envia até max registros pendentes (dos dois núcleos), em ordem
+// de chegada em cada anel. Só no núcleo 0. Retorna true se ainda sobrou.
+bool dlog_drain(unsigned max);
+
+// Formata um registro como o printf faria (ou em hexadecimal, com
+// ESTACAO_LOG_BINARY, para tools/dlog_decode.py). Retorna o tamanho.
+int dlog_format(char *out, size_t size, const struct dlog_record *r);
+
+// ---- Conversão dos argumentos (sem avaliar nada duas vezes) ----
+
+static inline uintptr_t dlog_arg_int(uintptr_t v) { return v; }
+static inline uintptr_t dlog_arg_ptr(const void *p) { return (uintptr_t)p; }
+static inline uintptr_t dlog_arg_float(double d)
+{
+    float f = (float)d;
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+#define dlog_arg(x) _Generic((x),          \
+    float: dlog_arg_float,                  \
+    double: dlog_arg_float,                 \
+    char *: dlog_arg_ptr,                   \
+    const char *: dlog_arg_ptr,             \
+    void *: dlog_arg_ptr,                   \
+    const void *: dlog_arg_ptr,             \
+    default: dlog_arg_int)(x)
+
+#define DLOG_NARGS(...) DLOG_NARGS_(0, ##__VA_ARGS__, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, n, ...) n
+#define DLOG_CAT(a, b) DLOG_CAT_(a, b)
+#define DLOG_CAT_(a, b) a##b
+#define DLOG_ARGS(...) DLOG_CAT(DLOG_ARGS_, DLOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+#define DLOG_ARGS_0()
+#define DLOG_ARGS_1(a) dlog_arg(a)
+#define DLOG_ARGS_2(a, ...) dlog_arg(a), DLOG_ARGS_1(__VA_ARGS__)
+#define DLOG_ARGS_3(a, ...) dlog_arg(a), DLOG_ARGS_2(__VA_ARGS__)
+#define DLOG_ARGS_4(a, ...) dlog_arg(a), DLOG_ARGS_3(__VA_ARGS__)
+#define DLOG_ARGS_5(a, ...) dlog_arg(a), DLOG_ARGS_4(__VA_ARGS__)
+#define DLOG_ARGS_6(a, ...) dlog_arg(a), DLOG_ARGS_5(__VA_ARGS__)
+#define DLOG_ARGS_7(a, ...) dlog_arg(a), DLOG_ARGS_6(__VA_ARGS__)
+
+// O 0 inicial só evita o vetor vazio quando não há argumentos
+#define DLOG_AT(level, fmt, ...)                                                 \
+    do {                                                                         \
+        const uintptr_t dlog_args_[] = {0, DLOG_ARGS(__VA_ARGS__)};              \
+        dlog_put(level, fmt, dlog_args_ + 1, (uint8_t)(count_of(dlog_args_) - 1)); \
+    } while (0)
+
+#define DLOG_OFF(fmt, ...) ((void)0)
+
+#if DLOG_LEVEL >= DLOG_LEVEL_ERROR
+#define DLOG_ERROR(fmt, ...) DLOG_AT(DLOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define DLOG_ERROR DLOG_OFF
+#endif
+
+#if DLOG_LEVEL >= DLOG_LEVEL_WARN
+#define DLOG_WARN(fmt, ...) DLOG_AT(DLOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define DLOG_WARN DLOG_OFF
+#endif
+
+#if DLOG_LEVEL >= DLOG_LEVEL_INFO
+#define DLOG_INFO(fmt, ...) DLOG_AT(DLOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define DLOG_INFO DLOG_OFF
+#endif
+
+#if DLOG_LEVEL >= DLOG_LEVEL_DEBUG
+#define DLOG_DEBUG(fmt, ...) DLOG_AT(DLOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define DLOG_DEBUG DLOG_OFF
+#endif
+
+#endif // DLOG_H
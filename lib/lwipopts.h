@@ -7,4 +7,26 @@
 // This example uses a common include to avoid repetition
 #include "lwipopts_examples_common.h"
 
+// Imagem do fs do lwIP gerada em build a partir de web/ (tools/gerar_fsdata.py)
+#define HTTPD_FSDATA_FILE           "fsdata_web.c"
+// HTTP_MAX_CONNECTIONS (lib/http/http_server.h) + folga para respostas 503 e TIME_WAIT
+#define MEMP_NUM_TCP_PCB            16
+
+// Estatísticas do heap, dos pools e do TCP para GET /metrics (lwip_stats).
+// Só incrementos dentro do lwIP; contadores de 32 bits para não virarem
+// entre duas coletas.
+#undef MEM_STATS
+#undef MEMP_STATS
+#define MEM_STATS                   1
+#define MEMP_STATS                  1
+#define TCP_STATS                   1
+#define LWIP_STATS                  1
+#define LWIP_STATS_LARGE            1
+
+// SNTP: horário real para o log em flash (lib/util/wall_clock.h)
+#include "util/wall_clock.h"
+#define SNTP_SERVER_DNS             1
+#define SNTP_SET_SYSTEM_TIME(sec)   wall_clock_set_unix(sec)
+#define MEMP_NUM_SYS_TIMEOUT        (LWIP_NUM_SYS_TIMEOUT_INTERNAL + 1)
+
 #endif
@@ -1,5 +1,6 @@
 #include "hardware/pio.h"        // Biblioteca para controle do Bloco Pio em uso
 #include "matriz.h"
+#include "trace/trace.h"
 
 
 bool matriz_preenchida[LED_COUNT] = {
@@ -26,6 +27,7 @@ void set_one_led(uint8_t r, uint8_t g, uint8_t b, bool desenho[])
 {
     // Define a cor com base nos parâmetros fornecidos
     uint32_t color = urgb_u32(r, g, b);
+    TRACE_BEGIN(SET_ONE_LED, color);
 
     // Define todos os LEDs com a cor especificada
     for (int i = 0; i < LED_COUNT; i++)
@@ -39,6 +41,7 @@ void set_one_led(uint8_t r, uint8_t g, uint8_t b, bool desenho[])
             put_pixel(0);  // Desliga os LEDs com zero no buffer
         }
     }
+    TRACE_END(SET_ONE_LED, color);
 }
 
 // Bloco Pio e state machine usadas na matriz de leds
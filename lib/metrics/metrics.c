@@ -0,0 +1,129 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include "metrics.h"
+
+const struct metrics_buckets metrics_buckets_fast = {
+    {25, 100, 250, 1000, 5000, 20000},
+};
+
+const struct metrics_buckets metrics_buckets_http = {
+    {1000, 5000, 25000, 100000, 500000, 2000000},
+};
+
+void metrics_observe(struct metrics_histogram *h, uint32_t us)
+{
+    unsigned core = get_core_num();
+    unsigned i = 0;
+    while (i < METRICS_BUCKETS && us > h->buckets->le_us[i]) {
+        i++;
+    }
+    h->count[core][i]++;
+    h->sum_us[core] += us;
+}
+
+uint32_t metrics_counter_value(const struct metrics_counter *c)
+{
+    uint32_t total = 0;
+    for (int core = 0; core < METRICS_CORES; core++) {
+        total += c->core[core];
+    }
+    return total;
+}
+
+uint32_t metrics_histogram_count(const struct metrics_histogram *h)
+{
+    uint32_t total = 0;
+    for (int core = 0; core < METRICS_CORES; core++) {
+        for (int i = 0; i <= METRICS_BUCKETS; i++) {
+            total += h->count[core][i];
+        }
+    }
+    return total;
+}
+
+void metrics_writer_init(struct metrics_writer *w, char *buf, size_t size)
+{
+    *w = (struct metrics_writer){.buf = buf, .size = size};
+}
+
+static void metrics_printf(struct metrics_writer *w, const char *fmt, ...)
+{
+    if (w->overflow) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(w->buf + w->len, w->size - w->len, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= w->size - w->len) {
+        w->overflow = true; // Corta na última linha completa
+        return;
+    }
+    w->len += (size_t)n;
+}
+
+void metrics_family(struct metrics_writer *w, const char *name, const char *type, const char *help)
+{
+    metrics_printf(w, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+void metrics_sample(struct metrics_writer *w, const char *name, const char *labels, uint64_t value)
+{
+    if (labels) {
+        metrics_printf(w, "%s{%s} %llu\n", name, labels, (unsigned long long)value);
+    } else {
+        metrics_printf(w, "%s %llu\n", name, (unsigned long long)value);
+    }
+}
+
+// Microssegundos como segundos ("0.0025"), sem float e sem zeros à direita
+static void metrics_seconds(char *out, size_t size, uint64_t us)
+{
+    int n = snprintf(out, size, "%llu.%06lu", (unsigned long long)(us / 1000000u), (unsigned long)(us % 1000000u));
+    while (n > 0 && (size_t)n < size && out[n - 1] == '0') {
+        out[--n] = '\0';
+    }
+    if (n > 0 && (size_t)n < size && out[n - 1] == '.') {
+        out[--n] = '\0';
+    }
+}
+
+void metrics_histogram_write(struct metrics_writer *w, const char *name, const char *labels,
+                             const struct metrics_histogram *h, int core)
+{
+    if (!h->buckets) {
+        return; // Nunca inicializado (ex.: barramento sem DMA)
+    }
+    const char *sep = labels ? "," : "";
+    labels = labels ? labels : "";
+    uint64_t cumulative = 0;
+    uint64_t sum_us = 0;
+    char le[24];
+    for (int i = 0; i <= METRICS_BUCKETS; i++) {
+        for (int c = 0; c < METRICS_CORES; c++) {
+            if (core < 0 || core == c) {
+                cumulative += h->count[c][i];
+            }
+        }
+        if (i < METRICS_BUCKETS) {
+            metrics_seconds(le, sizeof(le), h->buckets->le_us[i]);
+            metrics_printf(w, "%s_bucket{%s%sle=\"%s\"} %llu\n", name, labels, sep, le,
+                           (unsigned long long)cumulative);
+        } else {
+            metrics_printf(w, "%s_bucket{%s%sle=\"+Inf\"} %llu\n", name, labels, sep,
+                           (unsigned long long)cumulative);
+        }
+    }
+    for (int c = 0; c < METRICS_CORES; c++) {
+        if (core < 0 || core == c) {
+            sum_us += h->sum_us[c];
+        }
+    }
+    metrics_seconds(le, sizeof(le), sum_us);
+    if (*labels) {
+        metrics_printf(w, "%s_sum{%s} %s\n%s_count{%s} %llu\n", name, labels, le, name, labels,
+                       (unsigned long long)cumulative);
+    } else {
+        metrics_printf(w, "%s_sum %s\n%s_count %llu\n", name, le, name, (unsigned long long)cumulative);
+    }
+}
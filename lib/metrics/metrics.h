@@ -0,0 +1,86 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+// Contadores e histogramas de latência para GET /metrics (formato de texto
+// do Prometheus).
+//
+// Cada núcleo só escreve na sua fatia (get_core_num()): o incremento é um
+// load/add/store comum, sem trava, atômico ou barreira, e os dois núcleos
+// nunca disputam a mesma palavra. Quem exporta soma as fatias; a leitura de
+// uma palavra de 32 bits que o outro núcleo está escrevendo vê o valor velho
+// ou o novo, o que basta para métricas.
+//
+// Dentro de um núcleo a fatia tem um único escritor: um contador é
+// incrementado pelo laço de eventos ou por uma interrupção, nunca pelos
+// dois (uma interrupção no meio do load/store perderia a contagem).
+
+#define METRICS_CORES   2
+#define METRICS_BUCKETS 6 // Baldes com limite; o +Inf é implícito
+
+struct metrics_counter {
+    uint32_t core[METRICS_CORES];
+};
+
+// Limites superiores (us, crescentes) dos baldes de um histograma
+struct metrics_buckets {
+    uint32_t le_us[METRICS_BUCKETS];
+};
+
+struct metrics_histogram {
+    const struct metrics_buckets *buckets;
+    uint32_t count[METRICS_CORES][METRICS_BUCKETS + 1]; // Não cumulativos; o último é o +Inf
+    uint64_t sum_us[METRICS_CORES];
+};
+
+// Baldes comuns: transações I2C e trabalhos do laço (25 us a 20 ms) e
+// requisições HTTP (1 ms a 2 s)
+extern const struct metrics_buckets metrics_buckets_fast;
+extern const struct metrics_buckets metrics_buckets_http;
+
+static inline void metrics_add(struct metrics_counter *c, uint32_t n)
+{
+    c->core[get_core_num()] += n;
+}
+
+static inline void metrics_inc(struct metrics_counter *c)
+{
+    metrics_add(c, 1);
+}
+
+// Registra uma duração; a busca do balde é linear (METRICS_BUCKETS comparações)
+void metrics_observe(struct metrics_histogram *h, uint32_t us);
+
+// Soma das fatias de todos os núcleos
+uint32_t metrics_counter_value(const struct metrics_counter *c);
+
+// Observações registradas, somadas em todos os núcleos
+uint32_t metrics_histogram_count(const struct metrics_histogram *h);
+
+// Texto de exposição montado num buffer; o que não couber é cortado e
+// overflow fica true (a resposta sai sem as últimas linhas)
+struct metrics_writer {
+    char *buf;
+    size_t size;
+    size_t len;
+    bool overflow;
+};
+
+void metrics_writer_init(struct metrics_writer *w, char *buf, size_t size);
+
+// "# HELP" e "# TYPE" de uma família; type: "counter", "gauge" ou "histogram"
+void metrics_family(struct metrics_writer *w, const char *name, const char *type, const char *help);
+
+// Uma amostra: labels sem as chaves (ex.: "bus=\"0\""), ou NULL
+void metrics_sample(struct metrics_writer *w, const char *name, const char *labels, uint64_t value);
+
+// Histograma em segundos (_bucket cumulativos, _sum e _count). core < 0
+// soma os núcleos; senão só a fatia daquele núcleo.
+void metrics_histogram_write(struct metrics_writer *w, const char *name, const char *labels,
+                             const struct metrics_histogram *h, int core);
+
+#endif // METRICS_H
@@ -1,7 +1,7 @@
-#include <stdio.h>
-#include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "aht20.h"
+#include "compensation.h"
+#include "trace/trace.h"
 
 #define AHT20_I2C_ADDR      0x38
 #define AHT20_CMD_INIT      0xBE
@@ -10,70 +10,105 @@
 #define AHT20_STATUS_BUSY   0x80  // Bit de status ocupado
 #define AHT20_STATUS_CALIBRATED 0x08  // Bit de calibração
 
-bool aht20_init(i2c_inst_t *i2c) {
-    uint8_t init_cmd[3] = {AHT20_CMD_INIT, 0x08, 0x00};
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, init_cmd, 3, false);
-    sleep_ms(50);  // Aguarda o sensor inicializar
-
-    // Verifica status até que o sensor esteja pronto
+bool aht20_check(i2c_inst_t *i2c) {
     uint8_t status;
-    for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if ((status & AHT20_STATUS_CALIBRATED) == AHT20_STATUS_CALIBRATED) {
-            return true;  // Sensor calibrado e pronto
-        }
-        sleep_ms(10);
-    }
-
-    return false;  // Falhou na calibração
+    return i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false) == 1;
 }
 
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
-    uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
-    uint8_t buffer[6];
+// ---- Driver do registro de sensores (sensor_bus.h) ----
 
-    // Envia comando de medição
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false);
-    
-    // Aguarda até o sensor estar pronto
-    uint8_t status;
-    for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if (!(status & AHT20_STATUS_BUSY)) {
-            break;
-        }
-        sleep_ms(10);
-    }
-    
-    // Se ainda estiver ocupado, falha na leitura
-    if (status & AHT20_STATUS_BUSY) {
-        return false;
-    }
+#define AHT20_RESET_US    20000   // Após o soft reset
+#define AHT20_INIT_US     10000   // Após o comando de inicialização
+#define AHT20_MEASURE_US  80000   // Tempo de conversão do datasheet
+#define AHT20_RETRY_US    10000   // Ainda ocupado: lê de novo
 
-    // Lê os 6 bytes de dados
-    if (i2c_read_blocking(i2c, AHT20_I2C_ADDR, buffer, 6, false) != 6) {
-        return false;
-    }
+// Fases de uma rodada (sensor.aht20.phase): o comando que acabou de sair
+enum {
+    AHT20_PHASE_RESET,   // Soft reset: a seguir, inicialização
+    AHT20_PHASE_INIT,    // Inicialização: a seguir, disparo da medição
+    AHT20_PHASE_MEASURE, // Disparo: a seguir, leitura do status + dados
+};
 
-    // Processa os dados de umidade (20 bits)
-    uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
-    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
-
-    // Processa os dados de temperatura (20 bits)
-    uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
-    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+static void aht20_command(struct sensor_xfer *x, uint8_t cmd, uint8_t arg) {
+    x->tx[0] = cmd;
+    x->tx[1] = arg;
+    x->tx[2] = 0x00;
+    x->tx_len = 3;
+}
 
+// No boot só confirma que o sensor responde; reset e inicialização vão na
+// primeira rodada do escalonador, sem sleep_ms no núcleo 1
+static bool aht20_driver_init(struct sensor *s) {
+    if (!aht20_check(i2c_get_instance(s->bus))) {
+        return false;
+    }
+    s->aht20.reset_pending = true;
+    s->aht20.calibrated = false;
     return true;
 }
 
-void aht20_reset(i2c_inst_t *i2c) {
-    uint8_t reset_cmd = AHT20_CMD_RESET;
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, &reset_cmd, 1, false);
-    sleep_ms(20);
-    aht20_init(i2c);
+// Rodada normal: só o disparo. Depois do boot (reset) ou sem calibração (o
+// sensor reiniciou) os comandos que faltam saem pelas releituras da mesma
+// rodada (compensate > 0), e a medição não perde a rodada.
+static uint32_t aht20_driver_start(struct sensor *s, struct sensor_xfer *x) {
+    if (s->aht20.reset_pending) {
+        s->aht20.reset_pending = false;
+        s->aht20.phase = AHT20_PHASE_RESET;
+        x->tx[0] = AHT20_CMD_RESET;
+        x->tx_len = 1;
+        return AHT20_RESET_US;
+    }
+    if (!s->aht20.calibrated) {
+        s->aht20.phase = AHT20_PHASE_INIT;
+        aht20_command(x, AHT20_CMD_INIT, 0x08);
+        return AHT20_INIT_US;
+    }
+    s->aht20.phase = AHT20_PHASE_MEASURE;
+    aht20_command(x, AHT20_CMD_TRIGGER, 0x33);
+    return AHT20_MEASURE_US;
 }
 
-bool aht20_check(i2c_inst_t *i2c) {
-    uint8_t status;
-    return i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false) == 1;
+static void aht20_driver_collect(struct sensor *s, struct sensor_xfer *x) {
+    if (s->aht20.phase == AHT20_PHASE_RESET) {
+        aht20_command(x, AHT20_CMD_INIT, 0x08);
+    } else if (s->aht20.phase == AHT20_PHASE_INIT) {
+        aht20_command(x, AHT20_CMD_TRIGGER, 0x33);
+    } else {
+        x->rx_len = 6;
+        TRACE_BEGIN(AHT20_READ, sensor_trace_id(s));
+    }
 }
+
+static int32_t aht20_driver_compensate(struct sensor *s, int32_t *value) {
+    if (s->aht20.phase == AHT20_PHASE_RESET) {
+        s->aht20.phase = AHT20_PHASE_INIT;
+        return AHT20_INIT_US;
+    }
+    if (s->aht20.phase == AHT20_PHASE_INIT) {
+        s->aht20.phase = AHT20_PHASE_MEASURE;
+        return AHT20_MEASURE_US;
+    }
+    TRACE_END(AHT20_READ, sensor_trace_id(s));
+    uint8_t status = s->raw[0];
+    s->aht20.calibrated = status & AHT20_STATUS_CALIBRATED;
+    if (!s->aht20.calibrated) {
+        return -1; // A próxima rodada começa pela inicialização
+    }
+    if (status & AHT20_STATUS_BUSY) {
+        return AHT20_RETRY_US;
+    }
+    TRACE_BEGIN(AHT20_COMPENSATE, status);
+    aht20_compensate(s->raw, &value[0], &value[1]);
+    TRACE_END(AHT20_COMPENSATE, value[1]);
+    return 0;
+}
+
+const struct sensor_driver aht20_sensor_driver = {
+    .name = "aht20",
+    .channels = 2,
+    .quantity = {SENSOR_TEMPERATURE, SENSOR_HUMIDITY},
+    .init = aht20_driver_init,
+    .start = aht20_driver_start,
+    .collect = aht20_driver_collect,
+    .compensate = aht20_driver_compensate,
+};
@@ -1,6 +1,10 @@
 #ifndef AHT20_H
 #define AHT20_H
 
+#include <stdbool.h>
+#include <stdint.h>
+#include "hardware/i2c.h"
+#include "sensor_bus.h"
 
 // Endereço I2C do AHT20
 #define AHT20_I2C_ADDR  0x38
@@ -10,21 +14,12 @@
 #define AHT20_CMD_TRIGGER   0xAC
 #define AHT20_CMD_RESET     0xBA
 
-// Estrutura para armazenar os valores de temperatura e umidade
-typedef struct {
-    float temperature;
-    float humidity;
-} AHT20_Data;
-
-// Inicializa o sensor AHT20
-bool aht20_init(i2c_inst_t *i2c);
-
-// Faz a leitura de temperatura e umidade do AHT20
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data);
-
-// Reseta o sensor AHT20
-void aht20_reset(i2c_inst_t *i2c);
-
+// true se o sensor responde no barramento (leitura de 1 byte, bloqueante)
 bool aht20_check(i2c_inst_t *i2c);
 
+// Driver para o registro de sensores (sensor_bus.h): canais temperatura e
+// umidade, em ponto fixo (compensation.h). O endereço é fixo (0x38); mais de
+// um AHT20 só atrás de um mux. Reset e inicialização sem bloquear.
+extern const struct sensor_driver aht20_sensor_driver;
+
 #endif // AHT20_H
@@ -1,28 +1,93 @@
 #include "bmp280.h"
 #include "hardware/i2c.h"
+#include "trace/trace.h"
+
+// Tempo máximo de conversão (datasheet, apêndice B): 1,25 ms + 2,3 ms por
+// amostra de temperatura + 2,3 ms por amostra de pressão + 0,575 ms
+#define CONVERSION_US(osrs_t, osrs_p) (1250u + (2300u << ((osrs_t) - 1)) + (2300u << ((osrs_p) - 1)) + 575u)
+
+// No modo normal uma conversão a cada conversão + t_sb; no forçado a taxa é
+// limitada só pela conversão (um pedido por vez, sem contar o I2C)
+#define PROFILE(name, mode, osrs_t, osrs_p, filter, standby, standby_us) \
+    {name, mode, osrs_t, osrs_p, filter, standby, CONVERSION_US(osrs_t, osrs_p), \
+     (uint32_t)(1000000000ull / (CONVERSION_US(osrs_t, osrs_p) + (standby_us)))}
+
+// Códigos de sobreamostragem: 1 = x1, 2 = x2, 3 = x4, 4 = x8, 5 = x16
+// Filtro IIR: 0 = desligado, 2 = coeficiente 4, 4 = coeficiente 16
+// t_sb: 0 = 0,5 ms, 1 = 62,5 ms, 4 = 500 ms
+static const struct bmp280_profile_info profiles[BMP280_PROFILE_COUNT] = {
+    [BMP280_PROFILE_ULTRA_LOW_POWER] = PROFILE("ultra-baixo-consumo", BMP280_MODE_FORCED, 1, 1, 0, 0, 0),
+    [BMP280_PROFILE_STANDARD]        = PROFILE("padrao",              BMP280_MODE_NORMAL, 1, 3, 4, 4, 500000),
+    [BMP280_PROFILE_HIGH_RESOLUTION] = PROFILE("alta-resolucao",      BMP280_MODE_NORMAL, 2, 5, 2, 1, 62500),
+    [BMP280_PROFILE_HIGH_RATE]       = PROFILE("alta-taxa",           BMP280_MODE_NORMAL, 1, 3, 2, 0, 500),
+};
+
+const struct bmp280_profile_info *bmp280_profile_info(enum bmp280_profile profile) {
+    return profile < BMP280_PROFILE_COUNT ? &profiles[profile] : NULL;
+}
+
+static void write_reg(i2c_inst_t *i2c, uint8_t addr, uint8_t reg, uint8_t value) {
+    uint8_t buf[2] = {reg, value};
+    i2c_write_blocking(i2c, addr, buf, 2, false);
+}
+
+static uint8_t ctrl_meas_value(const struct bmp280_profile_info *p, uint8_t mode) {
+    return (p->osrs_t << 5) | (p->osrs_p << 2) | mode;
+}
+
+void bmp280_set_profile(i2c_inst_t *i2c, uint8_t addr, enum bmp280_profile profile) {
+    const struct bmp280_profile_info *p = &profiles[profile];
+    // No modo normal o sensor pode ignorar escritas em REG_CONFIG: dorme antes
+    write_reg(i2c, addr, REG_CTRL_MEAS, ctrl_meas_value(p, BMP280_MODE_SLEEP));
+    write_reg(i2c, addr, REG_CONFIG, (p->standby << 5) | (p->filter << 2));
+    // No modo forçado fica dormindo até bmp280_start_forced
+    write_reg(i2c, addr, REG_CTRL_MEAS, ctrl_meas_value(p, p->mode == BMP280_MODE_NORMAL ? BMP280_MODE_NORMAL : BMP280_MODE_SLEEP));
+}
+
+void bmp280_start_forced(i2c_inst_t *i2c, uint8_t addr, enum bmp280_profile profile) {
+    write_reg(i2c, addr, REG_CTRL_MEAS, ctrl_meas_value(&profiles[profile], BMP280_MODE_FORCED));
+}
 
-#define ADDR _u(0x76)
+bool bmp280_parse_frame(const uint8_t *buf, struct bmp280_frame *frame) {
+    // F3 status, F4 ctrl_meas, F5 config, F6, F7..F9 pressão, FA..FC temperatura
+    frame->status = buf[0];
+    frame->ctrl_meas = buf[1];
+    frame->pressure = (buf[4] << 12) | (buf[5] << 4) | (buf[6] >> 4);
+    frame->temp = (buf[7] << 12) | (buf[8] << 4) | (buf[9] >> 4);
 
-void bmp280_init(i2c_inst_t *i2c) {
-    uint8_t buf[2];
-    const uint8_t reg_config_val = ((0x04 << 5) | (0x05 << 2)) & 0xFC;
-    buf[0] = REG_CONFIG;
-    buf[1] = reg_config_val;
-   
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+    if ((buf[1] & 0x03) == BMP280_MODE_NORMAL) {
+        return true;
+    }
+    // Forçado: pronto quando voltou a dormir e não está convertendo
+    return (buf[1] & 0x03) == BMP280_MODE_SLEEP && !(buf[0] & BMP280_STATUS_MEASURING);
+}
+
+bool bmp280_read_frame(i2c_inst_t *i2c, uint8_t addr, struct bmp280_frame *frame) {
+    uint8_t buf[10];
+    uint8_t reg = REG_STATUS;
+    if (i2c_write_blocking(i2c, addr, &reg, 1, true) != 1 ||
+        i2c_read_blocking(i2c, addr, buf, sizeof(buf), false) != (int)sizeof(buf)) {
+        return false;
+    }
+    return bmp280_parse_frame(buf, frame);
+}
 
-    const uint8_t reg_ctrl_meas_val = (0x01 << 5) | (0x03 << 2) | (0x03);
-    buf[0] = REG_CTRL_MEAS;
-    buf[1] = reg_ctrl_meas_val;
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
- //   printf("Ctrl_meas register value: %x\n", reg_ctrl_meas_val);
+bool bmp280_probe(i2c_inst_t *i2c, uint8_t addr) {
+    uint8_t reg = REG_ID;
+    uint8_t id = 0;
+    return i2c_write_blocking(i2c, addr, &reg, 1, true) == 1 &&
+           i2c_read_blocking(i2c, addr, &id, 1, false) == 1 && id == BMP280_CHIP_ID;
 }
 
-void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
+void bmp280_init(i2c_inst_t *i2c, uint8_t addr) {
+    bmp280_set_profile(i2c, addr, BMP280_PROFILE_STANDARD);
+}
+
+void bmp280_read_raw(i2c_inst_t *i2c, uint8_t addr, int32_t* temp, int32_t* pressure) {
     uint8_t buf[6];
     uint8_t reg = REG_PRESSURE_MSB;
-    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c, ADDR, buf, 6, false);
+    i2c_write_blocking(i2c, addr, &reg, 1, true);
+    i2c_read_blocking(i2c, addr, buf, 6, false);
 
     *pressure = (buf[0] << 12) | (buf[1] << 4) | (buf[2] >> 4);
     *temp = (buf[3] << 12) | (buf[4] << 4) | (buf[5] >> 4);
@@ -30,21 +95,19 @@ void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
 
 }
 
-void bmp280_reset(i2c_inst_t *i2c) {
+void bmp280_reset(i2c_inst_t *i2c, uint8_t addr) {
     uint8_t buf[2] = { REG_RESET, 0xB6 };
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+    i2c_write_blocking(i2c, addr, buf, 2, false);
 }
 
 // função intermediária que calcula a temperatura de resolução fina
 // usada tanto para conversões de pressão quanto de temperatura
 int32_t bmp280_convert(int32_t temp, struct bmp280_calib_param* params) {
-    // usa os 32 bits de compensação de ponto fixo implementados no datasheet
-    int32_t var1, var2;
-    var1 = ((((temp >> 3) - ((int32_t)params->dig_t1 << 1))) * ((int32_t)params->dig_t2)) >> 11;
-    var2 = (((((temp >> 4) - ((int32_t)params->dig_t1)) * ((temp >> 4) - ((int32_t)params->dig_t1))) >> 12) * ((int32_t)params->dig_t3)) >> 14;
-    return var1 + var2;
+    return bmp280_t_fine(temp, params);
 }
 
+// As duas abaixo calculam t_fine cada uma: para um quadro completo use
+// bmp280_compensate (compensation.h), que o calcula uma vez
 int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params) {
     // Utiliza os parâmetros de calibração do BMP280 para compensar o valor de temperatura lido de seus registradores
     int32_t t_fine = bmp280_convert(temp, params);
@@ -54,37 +117,14 @@ int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params) {
 
 int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params) {
     // Utiliza os parâmetros de calibração do BMP280 para compensar o valor de pressão lido de seus registradores
-
-    int32_t t_fine = bmp280_convert(temp, params);
-
-    int32_t var1, var2;
-    uint32_t converted = 0.0;
-    var1 = (((int32_t)t_fine) >> 1) - (int32_t)64000;
-    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)params->dig_p6);
-    var2 += ((var1 * ((int32_t)params->dig_p5)) << 1);
-    var2 = (var2 >> 2) + (((int32_t)params->dig_p4) << 16);
-    var1 = (((params->dig_p3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((((int32_t)params->dig_p2) * var1) >> 1)) >> 18;
-    var1 = ((((32768 + var1)) * ((int32_t)params->dig_p1)) >> 15);
-    if (var1 == 0) {
-        return 0;  // avoid exception caused by division by zero
-    }
-    converted = (((uint32_t)(((int32_t)1048576) - pressure) - (var2 >> 12))) * 3125;
-    if (converted < 0x80000000) {
-        converted = (converted << 1) / ((uint32_t)var1);
-    } else {
-        converted = (converted / (uint32_t)var1) * 2;
-    }
-    var1 = (((int32_t)params->dig_p9) * ((int32_t)(((converted >> 3) * (converted >> 3)) >> 13))) >> 12;
-    var2 = (((int32_t)(converted >> 2)) * ((int32_t)params->dig_p8)) >> 13;
-    converted = (uint32_t)((int32_t)converted + ((var1 + var2 + params->dig_p7) >> 4));
-    return converted;
+    return (int32_t)bmp280_pressure_from_t_fine(pressure, bmp280_convert(temp, params), params);
 }
 
-void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params) {
+void bmp280_get_calib_params(i2c_inst_t *i2c, uint8_t addr, struct bmp280_calib_param* params) {
     uint8_t buf[NUM_CALIB_PARAMS] = { 0 };
     uint8_t reg = REG_DIG_T1_LSB;
-    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c, ADDR, buf, NUM_CALIB_PARAMS, false);
+    i2c_write_blocking(i2c, addr, &reg, 1, true);
+    i2c_read_blocking(i2c, addr, buf, NUM_CALIB_PARAMS, false);
 
     params->dig_t1 = (uint16_t)(buf[1] << 8) | buf[0];
     params->dig_t2 = (int16_t)(buf[3] << 8) | buf[2];
@@ -102,3 +142,79 @@ void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params)
 
 
 }
+
+// ---- Driver do registro de sensores (sensor_bus.h) ----
+
+#define BMP280_RETRY_US  1000     // Conversão forçada ainda em andamento
+#define BMP280_RAW_SKIP  0x80000  // Valor dos registradores sem conversão (após reset)
+
+static bool bmp280_driver_init(struct sensor *s) {
+    i2c_inst_t *i2c = i2c_get_instance(s->bus);
+    if (!s->addr) {
+        s->addr = bmp280_probe(i2c, BMP280_ADDR_PRIMARY)     ? BMP280_ADDR_PRIMARY
+                : bmp280_probe(i2c, BMP280_ADDR_SECONDARY) ? BMP280_ADDR_SECONDARY
+                                                             : 0;
+        if (!s->addr) {
+            return false;
+        }
+    } else if (!bmp280_probe(i2c, s->addr)) {
+        return false;
+    }
+    bmp280_set_profile(i2c, s->addr, s->bmp280.profile);
+    bmp280_get_calib_params(i2c, s->addr, &s->bmp280.calib);
+    return true;
+}
+
+// Forçado: dispara uma conversão por rodada. Normal: nada a disparar, a não
+// ser que o sensor tenha reiniciado e voltado a dormir.
+static uint32_t bmp280_driver_start(struct sensor *s, struct sensor_xfer *x) {
+    const struct bmp280_profile_info *p = &profiles[s->bmp280.profile];
+    if (p->mode != BMP280_MODE_FORCED && !s->bmp280.reprogram) {
+        return 0;
+    }
+    x->tx[0] = REG_CTRL_MEAS;
+    x->tx[1] = ctrl_meas_value(p, p->mode);
+    x->tx_len = 2;
+    s->bmp280.reprogram = false;
+    return p->conversion_us;
+}
+
+static void bmp280_driver_collect(struct sensor *s, struct sensor_xfer *x) {
+    x->tx[0] = REG_STATUS;
+    x->tx_len = 1;
+    x->rx_len = 10;
+    TRACE_BEGIN(BMP280_READ, sensor_trace_id(s));
+}
+
+static int32_t bmp280_driver_compensate(struct sensor *s, int32_t *value) {
+    const struct bmp280_profile_info *p = &profiles[s->bmp280.profile];
+    TRACE_END(BMP280_READ, sensor_trace_id(s));
+    struct bmp280_frame frame;
+    bool ready = bmp280_parse_frame(s->raw, &frame);
+    if ((frame.ctrl_meas & 0x03) == BMP280_MODE_SLEEP && p->mode == BMP280_MODE_NORMAL) {
+        s->bmp280.reprogram = true; // Reiniciou: volta ao modo normal na próxima rodada
+        return -1;
+    }
+    if (!ready) {
+        return BMP280_RETRY_US;
+    }
+    if (frame.temp == BMP280_RAW_SKIP || frame.pressure == BMP280_RAW_SKIP) {
+        return -1;
+    }
+    uint32_t pressure_pa;
+    TRACE_BEGIN(BMP280_COMPENSATE, frame.temp);
+    bmp280_compensate(frame.temp, frame.pressure, &s->bmp280.calib, &value[0], &pressure_pa);
+    TRACE_END(BMP280_COMPENSATE, pressure_pa);
+    value[1] = (int32_t)pressure_pa * 100;
+    return 0;
+}
+
+const struct sensor_driver bmp280_sensor_driver = {
+    .name = "bmp280",
+    .channels = 2,
+    .quantity = {SENSOR_TEMPERATURE, SENSOR_PRESSURE},
+    .init = bmp280_driver_init,
+    .start = bmp280_driver_start,
+    .collect = bmp280_driver_collect,
+    .compensate = bmp280_driver_compensate,
+};
@@ -2,14 +2,27 @@
 #define BMP280_H
 
 #include "hardware/i2c.h"
+#include "compensation.h" // struct bmp280_calib_param e a compensação de um quadro
+#include "sensor_bus.h"
 
-// Defina os endereços e registros conforme o código original
-#define ADDR _u(0x76)
+// Endereço conforme o pino SDO
+#define BMP280_ADDR_PRIMARY   _u(0x76) // SDO no GND
+#define BMP280_ADDR_SECONDARY _u(0x77) // SDO no VDDIO
+#define BMP280_CHIP_ID        _u(0x58)
 
+#define REG_ID _u(0xD0)
 #define REG_CONFIG _u(0xF5)
 #define REG_CTRL_MEAS _u(0xF4)
+#define REG_STATUS _u(0xF3)
 #define REG_RESET _u(0xE0)
 
+#define BMP280_STATUS_MEASURING _u(0x08) // Conversão em andamento
+#define BMP280_STATUS_IM_UPDATE _u(0x01) // Copiando calibração da NVM
+
+#define BMP280_MODE_SLEEP  _u(0x00)
+#define BMP280_MODE_FORCED _u(0x01)
+#define BMP280_MODE_NORMAL _u(0x03)
+
 #define REG_TEMP_XLSB _u(0xFC)
 #define REG_TEMP_LSB _u(0xFB)
 #define REG_TEMP_MSB _u(0xFA)
@@ -45,28 +58,68 @@
 
 #define NUM_CALIB_PARAMS 24
 
-struct bmp280_calib_param {
-    uint16_t dig_t1;
-    int16_t dig_t2;
-    int16_t dig_t3;
-
-    uint16_t dig_p1;
-    int16_t dig_p2;
-    int16_t dig_p3;
-    int16_t dig_p4;
-    int16_t dig_p5;
-    int16_t dig_p6;
-    int16_t dig_p7;
-    int16_t dig_p8;
-    int16_t dig_p9;
+// Perfis de medição (tabelas 14 e 15 do datasheet). Sobreamostragem e
+// filtro IIR reduzem o ruído e custam tempo de conversão; o tempo de
+// espera (t_sb) define a taxa no modo normal.
+enum bmp280_profile {
+    BMP280_PROFILE_ULTRA_LOW_POWER, // Forçado, x1/x1, sem IIR: uma conversão por pedido
+    BMP280_PROFILE_STANDARD,        // Normal, T x1 / P x4, IIR 16, t_sb 500 ms (padrão)
+    BMP280_PROFILE_HIGH_RESOLUTION, // Normal, T x2 / P x16, IIR 4, t_sb 62,5 ms
+    BMP280_PROFILE_HIGH_RATE,       // Normal, T x1 / P x4, IIR 4, t_sb 0,5 ms
+    BMP280_PROFILE_COUNT,
+};
+
+struct bmp280_profile_info {
+    const char *name;
+    uint8_t mode;            // BMP280_MODE_FORCED ou BMP280_MODE_NORMAL
+    uint8_t osrs_t;          // Códigos dos registradores
+    uint8_t osrs_p;
+    uint8_t filter;
+    uint8_t standby;
+    uint32_t conversion_us;  // Tempo máximo de uma conversão
+    uint32_t rate_mhz;       // Taxa de amostragem alcançável, em mHz
+};
+
+// Quadro lido de uma vez (0xF3..0xFC): status, controle e dados
+struct bmp280_frame {
+    uint8_t status;
+    uint8_t ctrl_meas;
+    int32_t temp;            // Brutos, 20 bits
+    int32_t pressure;
 };
 
-//void bmp280_init(void);
-void bmp280_init(i2c_inst_t *i2c);
-void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure);
-void bmp280_reset(i2c_inst_t *i2c);
+// addr: BMP280_ADDR_PRIMARY ou BMP280_ADDR_SECONDARY
+void bmp280_init(i2c_inst_t *i2c, uint8_t addr);
+void bmp280_read_raw(i2c_inst_t *i2c, uint8_t addr, int32_t* temp, int32_t* pressure);
+void bmp280_reset(i2c_inst_t *i2c, uint8_t addr);
 int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params);
 int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params);
-void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params);
+void bmp280_get_calib_params(i2c_inst_t *i2c, uint8_t addr, struct bmp280_calib_param* params);
+
+// true se há um BMP280 respondendo no endereço (registrador de ID)
+bool bmp280_probe(i2c_inst_t *i2c, uint8_t addr);
+
+// Perfis: bmp280_init usa BMP280_PROFILE_STANDARD
+const struct bmp280_profile_info *bmp280_profile_info(enum bmp280_profile profile);
+void bmp280_set_profile(i2c_inst_t *i2c, uint8_t addr, enum bmp280_profile profile);
+
+// Modo forçado: dispara uma conversão com a sobreamostragem do perfil; o
+// resultado fica pronto em conversion_us e o sensor volta a dormir
+void bmp280_start_forced(i2c_inst_t *i2c, uint8_t addr, enum bmp280_profile profile);
+
+// Lê status e dados numa só transação. Retorna true se o quadro é de uma
+// conversão concluída: no modo forçado, só depois que o sensor volta a
+// dormir; no modo normal os registradores de dados são sempre a última
+// conversão completa (o sensor não os altera no meio de uma leitura).
+// false também em erro de I2C (frame inalterado nesse caso).
+bool bmp280_read_frame(i2c_inst_t *i2c, uint8_t addr, struct bmp280_frame *frame);
+
+// Interpreta os 10 bytes lidos a partir de REG_STATUS (mesmo retorno de
+// bmp280_read_frame), para quem faz a leitura por outro caminho
+bool bmp280_parse_frame(const uint8_t *buf, struct bmp280_frame *frame);
+
+// Driver para o registro de sensores (sensor_bus.h): canais temperatura e
+// pressão. Perfil em sensor.bmp280.profile; addr 0 procura em 0x76 e 0x77.
+extern const struct sensor_driver bmp280_sensor_driver;
 
 #endif
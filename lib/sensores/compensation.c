@@ -0,0 +1,51 @@
+#include "compensation.h"
+
+int32_t bmp280_t_fine(int32_t raw_temp, const struct bmp280_calib_param *params) {
+    // usa os 32 bits de compensação de ponto fixo implementados no datasheet
+    int32_t var1, var2;
+    var1 = ((((raw_temp >> 3) - ((int32_t)params->dig_t1 << 1))) * ((int32_t)params->dig_t2)) >> 11;
+    var2 = (((((raw_temp >> 4) - ((int32_t)params->dig_t1)) * ((raw_temp >> 4) - ((int32_t)params->dig_t1))) >> 12) * ((int32_t)params->dig_t3)) >> 14;
+    return var1 + var2;
+}
+
+uint32_t bmp280_pressure_from_t_fine(int32_t raw_pressure, int32_t t_fine, const struct bmp280_calib_param *params) {
+    int32_t var1, var2;
+    uint32_t converted;
+    var1 = (((int32_t)t_fine) >> 1) - (int32_t)64000;
+    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)params->dig_p6);
+    var2 += ((var1 * ((int32_t)params->dig_p5)) << 1);
+    var2 = (var2 >> 2) + (((int32_t)params->dig_p4) << 16);
+    var1 = (((params->dig_p3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((((int32_t)params->dig_p2) * var1) >> 1)) >> 18;
+    var1 = ((((32768 + var1)) * ((int32_t)params->dig_p1)) >> 15);
+    if (var1 == 0) {
+        return 0;  // avoid exception caused by division by zero
+    }
+    converted = (((uint32_t)(((int32_t)1048576) - raw_pressure) - (var2 >> 12))) * 3125;
+    if (converted < 0x80000000) {
+        converted = (converted << 1) / ((uint32_t)var1);
+    } else {
+        converted = (converted / (uint32_t)var1) * 2;
+    }
+    var1 = (((int32_t)params->dig_p9) * ((int32_t)(((converted >> 3) * (converted >> 3)) >> 13))) >> 12;
+    var2 = (((int32_t)(converted >> 2)) * ((int32_t)params->dig_p8)) >> 13;
+    converted = (uint32_t)((int32_t)converted + ((var1 + var2 + params->dig_p7) >> 4));
+    return converted;
+}
+
+void bmp280_compensate(int32_t raw_temp, int32_t raw_pressure, const struct bmp280_calib_param *params,
+                       int32_t *temp_centi, uint32_t *pressure_pa) {
+    int32_t t_fine = bmp280_t_fine(raw_temp, params);
+    *temp_centi = (t_fine * 5 + 128) >> 8;
+    *pressure_pa = bmp280_pressure_from_t_fine(raw_pressure, t_fine, params);
+}
+
+void aht20_compensate(const uint8_t *frame, int32_t *temp_centi, int32_t *humidity_centi) {
+    uint32_t raw_humidity = ((uint32_t)frame[1] << 12) | ((uint32_t)frame[2] << 4) | (frame[3] >> 4);
+    uint32_t raw_temp = ((uint32_t)(frame[3] & 0x0F) << 16) | ((uint32_t)frame[4] << 8) | frame[5];
+
+    // UR = raw * 100 / 2^20 -> centésimos: raw * 10000 / 2^20 = raw * 625 / 2^16
+    // T = raw * 200 / 2^20 - 50 -> centésimos: raw * 1250 / 2^16 - 5000
+    // raw < 2^20, então os produtos cabem em 32 bits sem sinal
+    *humidity_centi = (int32_t)((raw_humidity * 625u + 0x8000u) >> 16);
+    *temp_centi = (int32_t)((raw_temp * 1250u + 0x8000u) >> 16) - 5000;
+}
@@ -0,0 +1,42 @@
+#ifndef COMPENSATION_H
+#define COMPENSATION_H
+
+#include <stdint.h>
+
+// Compensação dos sensores só com inteiros (o M0+ não tem FPU: float e
+// double viram chamadas de biblioteca). Resultados em ponto fixo:
+// temperatura e umidade em centésimos (0,01 °C, 0,01 %), pressão em Pa.
+//
+// Sem dependência do SDK, para os testes de bancada em tools/.
+
+struct bmp280_calib_param {
+    uint16_t dig_t1;
+    int16_t dig_t2;
+    int16_t dig_t3;
+
+    uint16_t dig_p1;
+    int16_t dig_p2;
+    int16_t dig_p3;
+    int16_t dig_p4;
+    int16_t dig_p5;
+    int16_t dig_p6;
+    int16_t dig_p7;
+    int16_t dig_p8;
+    int16_t dig_p9;
+};
+
+// Temperatura de resolução fina (datasheet, compensação de 32 bits)
+int32_t bmp280_t_fine(int32_t raw_temp, const struct bmp280_calib_param *params);
+
+// Pressão em Pa a partir de t_fine; 0 com calibração inválida
+uint32_t bmp280_pressure_from_t_fine(int32_t raw_pressure, int32_t t_fine, const struct bmp280_calib_param *params);
+
+// Quadro bruto completo numa passada: t_fine é calculado uma vez só
+void bmp280_compensate(int32_t raw_temp, int32_t raw_pressure, const struct bmp280_calib_param *params,
+                       int32_t *temp_centi, uint32_t *pressure_pa);
+
+// Os 6 bytes lidos do AHT20 (status + 20 bits de umidade + 20 de temperatura),
+// arredondados para o centésimo mais próximo
+void aht20_compensate(const uint8_t *frame, int32_t *temp_centi, int32_t *humidity_centi);
+
+#endif // COMPENSATION_H
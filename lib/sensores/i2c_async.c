@@ -0,0 +1,179 @@
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "i2c_async.h"
+
+#define I2C_ASYNC_TIMEOUT_US 5000 // Sensor segurando o clock
+
+struct i2c_async_bus {
+    i2c_inst_t *i2c;
+    alarm_pool_t *alarm_pool;
+    int dma_tx;
+    int dma_rx;
+    volatile bool busy;
+    uint8_t rx_len;
+    uint32_t start_us;
+    alarm_id_t alarm;
+    volatile bool armed;
+    i2c_async_done_fn done;
+    void *ctx;
+    uint16_t cmd[I2C_ASYNC_MAX_BYTES]; // Palavras para IC_DATA_CMD
+    struct i2c_async_stats stats;
+};
+
+static struct i2c_async_bus buses[2];
+
+static void i2c_async_finish(struct i2c_async_bus *b, bool ok) {
+    b->armed = false;
+    if (b->alarm > 0) {
+        if (b->alarm_pool) {
+            alarm_pool_cancel_alarm(b->alarm_pool, b->alarm);
+        } else {
+            cancel_alarm(b->alarm);
+        }
+    }
+    b->alarm = 0;
+    b->busy = false;
+    metrics_observe(&b->stats.duration, time_us_32() - b->start_us);
+    b->done(i2c_hw_index(b->i2c), ok, b->ctx);
+}
+
+static void i2c_async_abort(struct i2c_async_bus *b) {
+    dma_channel_abort(b->dma_tx);
+    dma_channel_abort(b->dma_rx);
+    (void)i2c_get_hw(b->i2c)->clr_tx_abrt; // Libera a FIFO de TX
+}
+
+static int64_t i2c_async_timeout(alarm_id_t id, void *user_data) {
+    struct i2c_async_bus *b = user_data;
+    if (b->armed) { // Cancelado enquanto já disparava: ignora
+        b->armed = false;
+        b->alarm = 0;
+        i2c_async_abort(b);
+        metrics_inc(&b->stats.timeouts);
+        i2c_async_finish(b, false);
+    }
+    return 0;
+}
+
+static void i2c_async_irq(struct i2c_async_bus *b) {
+    i2c_hw_t *hw = i2c_get_hw(b->i2c);
+    uint32_t status = hw->intr_stat;
+    if (!(status & (I2C_IC_INTR_STAT_R_STOP_DET_BITS | I2C_IC_INTR_STAT_R_TX_ABRT_BITS))) {
+        return;
+    }
+    bool ok = !(status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS);
+    if (!ok) {
+        i2c_async_abort(b); // NACK: o controlador já mandou o STOP
+    }
+    (void)hw->clr_stop_det;
+    if (!b->busy) {
+        return; // STOP atrasado de uma transação abortada
+    }
+    if (ok && b->rx_len) {
+        while (dma_channel_is_busy(b->dma_rx)) { // No máximo o último byte, ainda a caminho
+            tight_loop_contents();
+        }
+    }
+    metrics_inc(ok ? &b->stats.completed : &b->stats.nacks);
+    i2c_async_finish(b, ok);
+}
+
+static void i2c0_async_irq(void) {
+    i2c_async_irq(&buses[0]);
+}
+
+static void i2c1_async_irq(void) {
+    i2c_async_irq(&buses[1]);
+}
+
+bool i2c_async_init(i2c_inst_t *i2c, alarm_pool_t *alarm_pool, i2c_async_done_fn done, void *ctx) {
+    struct i2c_async_bus *b = &buses[i2c_hw_index(i2c)];
+    int tx = dma_claim_unused_channel(false);
+    int rx = dma_claim_unused_channel(false);
+    if (tx < 0 || rx < 0) {
+        if (tx >= 0) dma_channel_unclaim(tx);
+        if (rx >= 0) dma_channel_unclaim(rx);
+        return false;
+    }
+    *b = (struct i2c_async_bus){
+        .i2c = i2c,
+        .alarm_pool = alarm_pool,
+        .dma_tx = tx,
+        .dma_rx = rx,
+        .done = done,
+        .ctx = ctx,
+        .stats.duration.buckets = &metrics_buckets_fast,
+    };
+
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    (void)hw->clr_intr;
+    uint irq = I2C0_IRQ + i2c_hw_index(i2c);
+    irq_set_exclusive_handler(irq, i2c_hw_index(i2c) ? i2c1_async_irq : i2c0_async_irq);
+    irq_set_enabled(irq, true);
+    return true;
+}
+
+bool i2c_async_transfer(i2c_inst_t *i2c, uint8_t addr, const uint8_t *tx, uint8_t tx_len,
+                        uint8_t *rx, uint8_t rx_len) {
+    struct i2c_async_bus *b = &buses[i2c_hw_index(i2c)];
+    uint len = tx_len + rx_len;
+    if (!b->i2c || b->busy || len == 0 || len > I2C_ASYNC_MAX_BYTES) {
+        if (b->i2c && b->busy) {
+            metrics_inc(&b->stats.rejected);
+        }
+        return false;
+    }
+    for (uint i = 0; i < tx_len; i++) {
+        b->cmd[i] = tx[i];
+    }
+    for (uint i = tx_len; i < len; i++) {
+        b->cmd[i] = I2C_IC_DATA_CMD_CMD_BITS | (i == tx_len && tx_len ? I2C_IC_DATA_CMD_RESTART_BITS : 0);
+    }
+    b->cmd[len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    b->rx_len = rx_len;
+    b->busy = true;
+    b->start_us = time_us_32();
+
+    // O endereço só muda com o controlador desligado; entre transações o
+    // barramento está parado (a anterior terminou no STOP)
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    hw->enable = 0;
+    hw->tar = addr;
+    hw->enable = 1;
+    (void)hw->clr_intr; // Sobras da transação anterior
+
+    b->armed = true; // Antes: com o prazo já vencido o callback roda aqui dentro
+    alarm_id_t id = b->alarm_pool
+                        ? alarm_pool_add_alarm_in_us(b->alarm_pool, I2C_ASYNC_TIMEOUT_US, i2c_async_timeout, b, true)
+                        : add_alarm_in_us(I2C_ASYNC_TIMEOUT_US, i2c_async_timeout, b, true);
+    if (b->armed) {
+        b->alarm = id;
+    }
+
+    if (rx_len) {
+        dma_channel_config c = dma_channel_get_default_config(b->dma_rx);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, i2c_get_dreq(i2c, false));
+        dma_channel_configure(b->dma_rx, &c, rx, &hw->data_cmd, rx_len, true);
+    }
+    dma_channel_config c = dma_channel_get_default_config(b->dma_tx);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+    dma_channel_configure(b->dma_tx, &c, &hw->data_cmd, b->cmd, len, true);
+    return true;
+}
+
+bool i2c_async_busy(i2c_inst_t *i2c) {
+    return buses[i2c_hw_index(i2c)].busy;
+}
+
+const struct i2c_async_stats *i2c_async_get_stats(i2c_inst_t *i2c) {
+    return &buses[i2c_hw_index(i2c)].stats;
+}
@@ -0,0 +1,48 @@
+#ifndef I2C_ASYNC_H
+#define I2C_ASYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hardware/i2c.h"
+#include "pico/time.h"
+#include "metrics/metrics.h"
+
+// Transações I2C sem bloquear: a DMA alimenta a FIFO de comandos do
+// controlador (e esvazia a de recepção) e o fim vem pela interrupção do
+// próprio I2C (STOP detectado, ou abort por NACK). A CPU só monta a
+// transação; cada barramento tem os seus canais de DMA, então i2c0 e i2c1
+// trabalham ao mesmo tempo. Um alarme cobre o barramento travado.
+//
+// O callback roda em interrupção, no núcleo que chamou i2c_async_init.
+// Durante o uso assíncrono o barramento não deve receber chamadas
+// bloqueantes do SDK.
+
+#define I2C_ASYNC_MAX_BYTES 16 // Escrita + leitura numa transação
+
+typedef void (*i2c_async_done_fn)(uint bus, bool ok, void *ctx);
+
+// Contadores de um barramento para /metrics. O fim das transações é contado
+// na interrupção; rejected, em quem chama i2c_async_transfer.
+struct i2c_async_stats {
+    struct metrics_counter completed; // Terminadas com STOP
+    struct metrics_counter nacks;     // Abortadas pelo controlador (NACK)
+    struct metrics_counter timeouts;  // Barramento travado
+    struct metrics_counter rejected;  // Pedido com o barramento ocupado
+    struct metrics_histogram duration; // Do disparo ao fim, de qualquer desfecho
+};
+
+// Reserva os canais de DMA e liga a interrupção do barramento. alarm_pool
+// NULL usa o pool padrão. false sem canais de DMA livres.
+bool i2c_async_init(i2c_inst_t *i2c, alarm_pool_t *alarm_pool, i2c_async_done_fn done, void *ctx);
+
+// Escreve tx_len bytes e, se rx_len > 0, lê rx_len bytes em rx (repeated
+// start entre as duas partes; STOP no fim). false se o barramento ainda
+// tem uma transação em andamento ou os tamanhos não cabem.
+bool i2c_async_transfer(i2c_inst_t *i2c, uint8_t addr, const uint8_t *tx, uint8_t tx_len,
+                        uint8_t *rx, uint8_t rx_len);
+
+bool i2c_async_busy(i2c_inst_t *i2c);
+
+const struct i2c_async_stats *i2c_async_get_stats(i2c_inst_t *i2c);
+
+#endif // I2C_ASYNC_H
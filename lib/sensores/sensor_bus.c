@@ -0,0 +1,275 @@
+#include <string.h>
+#include "sensor_bus.h"
+
+enum sensor_step {
+    SENSOR_IDLE,        // Fora da rodada
+    SENSOR_START,       // Falta disparar
+    SENSOR_STARTING,    // Disparo em andamento
+    SENSOR_WAIT,        // Convertendo até ready_us
+    SENSOR_COLLECTING,  // Leitura em andamento
+    SENSOR_DONE,
+};
+
+void sensor_bus_init(struct sensor_bus *b, const struct sensor_bus_ops *ops, void *ctx) {
+    memset(b, 0, sizeof(*b));
+    b->ops = ops;
+    b->ctx = ctx;
+}
+
+static bool mux_write(struct sensor_bus *b, uint8_t bus, uint8_t mux_addr, uint8_t mask) {
+    return b->ops->write_blocking(b->ctx, bus, mux_addr, &mask, 1);
+}
+
+// Dois sensores que responderiam juntos: mesmo barramento e endereço, e
+// nenhum canal de mux que os separe
+static bool addr_conflict(const struct sensor_bus *b, const struct sensor *s) {
+    for (int i = 0; i < b->count; i++) {
+        const struct sensor *o = b->sensor[i];
+        if (o->bus == s->bus && o->addr == s->addr &&
+            (!o->mux_addr || !s->mux_addr || (o->mux_addr == s->mux_addr && o->mux_channel == s->mux_channel))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool sensor_bus_add(struct sensor_bus *b, struct sensor *s) {
+    if (b->count == SENSOR_MAX || s->bus >= SENSOR_BUSES) {
+        return false;
+    }
+    struct sensor_lane *lane = &b->lane[s->bus];
+    bool reachable = true;
+    if (lane->mux_addr && lane->mux_addr != s->mux_addr) {
+        reachable = mux_write(b, s->bus, lane->mux_addr, 0); // Outro mux não pode ficar aberto
+        lane->mux_addr = 0;
+    }
+    if (reachable && s->mux_addr) {
+        reachable = mux_write(b, s->bus, s->mux_addr, 1u << s->mux_channel);
+        lane->mux_addr = reachable ? s->mux_addr : 0;
+        lane->mux_channel = s->mux_channel;
+    }
+    s->online = reachable && (!s->driver->init || s->driver->init(s));
+    s->step = SENSOR_IDLE;
+    if (s->online && addr_conflict(b, s)) {
+        s->online = false; // Endereço auto (0) só é conhecido depois do init
+        return false;
+    }
+    b->sensor[b->count++] = s;
+    return true;
+}
+
+bool sensor_bus_start_round(struct sensor_bus *b, uint64_t now_us) {
+    if (b->running) {
+        b->stats.overruns++;
+        return false;
+    }
+    for (int i = 0; i < b->count; i++) {
+        struct sensor *s = b->sensor[i];
+        bool due = s->online && (s->decimation <= 1 || b->round % s->decimation == 0);
+        s->step = due ? SENSOR_START : SENSOR_IDLE;
+        s->retries = 0;
+        if (due) {
+            s->fresh = false;
+        }
+    }
+    b->running = true;
+    b->round_start_us = now_us;
+    return true;
+}
+
+void sensor_bus_xfer_done(struct sensor_bus *b, uint8_t bus, bool ok) {
+    b->lane[bus].result = ok ? 1 : -1;
+}
+
+bool sensor_bus_running(const struct sensor_bus *b) {
+    return b->running;
+}
+
+bool sensor_failed(const struct sensor *s) {
+    return s->step == SENSOR_DONE && !s->fresh;
+}
+
+static void submit(struct sensor_bus *b, uint8_t bus, uint8_t addr, uint8_t *rx) {
+    struct sensor_lane *lane = &b->lane[bus];
+    lane->busy = true;
+    lane->result = 0;
+    b->stats.transfers++;
+    if (!b->ops->submit(b->ctx, bus, addr, lane->xfer.tx, lane->xfer.tx_len, rx, lane->xfer.rx_len)) {
+        lane->result = -1; // Tratada em seguida, como qualquer falha
+    }
+}
+
+// Escreve a máscara de canais no mux a caminho de target; a transação é do
+// barramento (owner NULL)
+static void submit_mux(struct sensor_bus *b, struct sensor *target, uint8_t mux_addr, uint8_t mask) {
+    struct sensor_lane *lane = &b->lane[target->bus];
+    lane->owner = NULL;
+    lane->mux_target = target;
+    lane->mux_pending_addr = mux_addr;
+    lane->mux_pending = mask;
+    lane->xfer = (struct sensor_xfer){.tx = {mask}, .tx_len = 1};
+    b->stats.mux_switches++;
+    submit(b, target->bus, mux_addr, NULL);
+}
+
+// Prepara o caminho até o sensor. false: saiu antes uma escrita no mux.
+static bool route_to(struct sensor_bus *b, struct sensor *s) {
+    struct sensor_lane *lane = &b->lane[s->bus];
+    if (!s->mux_addr || (lane->mux_addr == s->mux_addr && lane->mux_channel == s->mux_channel)) {
+        return true;
+    }
+    if (lane->mux_addr && lane->mux_addr != s->mux_addr) {
+        submit_mux(b, s, lane->mux_addr, 0); // Dois muxes abertos podem conflitar
+        return false;
+    }
+    submit_mux(b, s, s->mux_addr, 1u << s->mux_channel);
+    return false;
+}
+
+static void finish_sensor(struct sensor *s, bool ok) {
+    s->step = SENSOR_DONE;
+    s->fresh = ok;
+    if (ok) {
+        s->samples++;
+    } else {
+        s->errors++;
+    }
+}
+
+static void start_sensor(struct sensor_bus *b, struct sensor *s, uint64_t now_us) {
+    struct sensor_lane *lane = &b->lane[s->bus];
+    lane->xfer = (struct sensor_xfer){0};
+    s->wait_us = s->driver->start(s, &lane->xfer);
+    if (!lane->xfer.tx_len && !lane->xfer.rx_len) {
+        s->step = SENSOR_WAIT; // Nada a enviar: só espera
+        s->ready_us = now_us + s->wait_us;
+        return;
+    }
+    lane->owner = s;
+    s->step = SENSOR_STARTING;
+    submit(b, s->bus, s->addr, s->raw);
+}
+
+static void collect_sensor(struct sensor_bus *b, struct sensor *s) {
+    struct sensor_lane *lane = &b->lane[s->bus];
+    lane->xfer = (struct sensor_xfer){0};
+    s->driver->collect(s, &lane->xfer);
+    lane->owner = s;
+    s->step = SENSOR_COLLECTING;
+    submit(b, s->bus, s->addr, s->raw);
+}
+
+// Processa o fim da transação do barramento
+static void complete_lane(struct sensor_lane *lane, uint64_t now_us) {
+    bool ok = lane->result > 0;
+    struct sensor *s = lane->owner;
+    lane->busy = false;
+    lane->result = 0;
+    lane->owner = NULL;
+
+    if (!s) { // Mux
+        if (ok) {
+            lane->mux_addr = lane->mux_pending ? lane->mux_pending_addr : 0;
+            lane->mux_channel = 0;
+            for (uint8_t mask = lane->mux_pending; mask > 1; mask >>= 1) {
+                lane->mux_channel++;
+            }
+        } else {
+            // Estado do mux desconhecido: perde só o sensor que esperava o
+            // canal (um mux ausente não prende a rodada); os outros refazem a
+            // abertura na vez deles
+            finish_sensor(lane->mux_target, false);
+            lane->mux_addr = 0;
+        }
+        return;
+    }
+
+    if (!ok) {
+        finish_sensor(s, false);
+        return;
+    }
+    if (s->step == SENSOR_STARTING) {
+        s->step = SENSOR_WAIT;
+        s->ready_us = now_us + s->wait_us;
+        return;
+    }
+    int32_t r = s->driver->compensate(s, s->value);
+    if (r > 0 && s->retries < SENSOR_MAX_RETRIES) {
+        s->retries++;
+        s->step = SENSOR_WAIT;
+        s->ready_us = now_us + (uint32_t)r;
+        return;
+    }
+    finish_sensor(s, r == 0);
+}
+
+// Próxima transação do barramento: disparos primeiro (quanto antes começam,
+// mais as conversões se sobrepõem), depois a leitura pronta há mais tempo.
+// Retorna false se não havia nada a fazer.
+static bool dispatch(struct sensor_bus *b, uint8_t bus, uint64_t now_us) {
+    struct sensor *next = NULL;
+    for (int i = 0; i < b->count; i++) {
+        struct sensor *s = b->sensor[i];
+        if (s->bus != bus) {
+            continue;
+        }
+        if (s->step == SENSOR_START) {
+            next = s;
+            break;
+        }
+        if (s->step == SENSOR_WAIT && s->ready_us <= now_us && (!next || s->ready_us < next->ready_us)) {
+            next = s;
+        }
+    }
+    if (!next) {
+        return false;
+    }
+    if (!route_to(b, next)) {
+        return true;
+    }
+    if (next->step == SENSOR_START) {
+        start_sensor(b, next, now_us);
+    } else {
+        collect_sensor(b, next);
+    }
+    return true;
+}
+
+uint64_t sensor_bus_poll(struct sensor_bus *b, uint64_t now_us) {
+    for (uint8_t bus = 0; bus < SENSOR_BUSES; bus++) {
+        struct sensor_lane *lane = &b->lane[bus];
+        // Disparos sem transação e falhas imediatas liberam o barramento na
+        // hora: segue até ele ficar ocupado ou sem trabalho
+        do {
+            if (lane->busy && lane->result != 0) {
+                complete_lane(lane, now_us);
+            }
+        } while (!lane->busy && dispatch(b, bus, now_us));
+    }
+
+    uint64_t deadline = SENSOR_NO_DEADLINE;
+    bool pending = false;
+    for (int i = 0; i < b->count; i++) {
+        struct sensor *s = b->sensor[i];
+        if (s->step != SENSOR_IDLE && s->step != SENSOR_DONE) {
+            pending = true;
+        }
+        if (s->step == SENSOR_WAIT && s->ready_us > now_us && s->ready_us < deadline) {
+            deadline = s->ready_us;
+        }
+    }
+    if (b->running && !pending && !b->lane[0].busy && !b->lane[1].busy) {
+        uint32_t elapsed = (uint32_t)(now_us - b->round_start_us);
+        b->running = false;
+        b->stats.rounds++;
+        b->stats.last_round_us = elapsed;
+        if (elapsed > b->stats.max_round_us) {
+            b->stats.max_round_us = elapsed;
+        }
+        if (b->ops->round_done) {
+            b->ops->round_done(b, b->ctx);
+        }
+        b->round++;
+    }
+    return deadline;
+}
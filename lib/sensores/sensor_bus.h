@@ -0,0 +1,194 @@
+#ifndef SENSOR_BUS_H
+#define SENSOR_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "compensation.h"
+
+// Registro de sensores e escalonador dos barramentos I2C.
+//
+// Cada sensor é um struct sensor com um driver (struct sensor_driver): o
+// driver só monta as transações (disparo da conversão e leitura do
+// resultado) e converte os bytes lidos; quem decide quando cada transação
+// vai para o barramento é o escalonador. Numa rodada ele dispara todos os
+// sensores, espera o tempo de conversão de cada um sem bloquear e lê cada
+// resultado assim que fica pronto. Os barramentos andam em paralelo (uma
+// transação em andamento por barramento) e as conversões se sobrepõem, então
+// a rodada dura ~a conversão mais longa mais as transações (centenas de us
+// cada), e não a soma das esperas de todos os sensores.
+//
+// Sensores atrás de um multiplexador TCA9548A indicam o endereço dele e o
+// canal; o escalonador abre o canal antes de falar com o sensor, com no
+// máximo um mux de canal aberto por barramento. Sensores iguais (mesmo
+// endereço) no mesmo barramento precisam de canais de mux diferentes.
+//
+// Este arquivo não depende do SDK: as transações saem por struct
+// sensor_bus_ops (i2c_async.c no RP2040, barramentos simulados em
+// tools/bench_sensor_bus.c) e o fim de cada uma volta por
+// sensor_bus_xfer_done.
+
+#define SENSOR_MAX          8   // Sensores registrados
+#define SENSOR_BUSES        2   // i2c0 e i2c1
+#define SENSOR_MAX_CHANNELS 2   // Grandezas por sensor
+#define SENSOR_TX_MAX       4   // Bytes escritos por transação
+#define SENSOR_RAW_MAX      10  // Bytes lidos por transação
+#define SENSOR_MAX_RETRIES  5   // Resultado ainda não pronto: novas leituras
+#define SENSOR_NO_DEADLINE  UINT64_MAX
+
+#define TCA9548A_ADDR       0x70 // 0x70..0x77 conforme A0..A2
+
+enum sensor_quantity {
+    SENSOR_TEMPERATURE, // 0,01 °C
+    SENSOR_HUMIDITY,    // 0,01 %
+    SENSOR_PRESSURE,    // 0,01 Pa
+};
+
+// Transação montada pelo driver: escreve tx_len bytes e depois, se rx_len >
+// 0, lê rx_len bytes em sensor.raw (repeated start entre as duas partes)
+struct sensor_xfer {
+    uint8_t tx[SENSOR_TX_MAX];
+    uint8_t tx_len;
+    uint8_t rx_len;
+};
+
+struct sensor;
+
+struct sensor_driver {
+    const char *name;
+    uint8_t channels;
+    uint8_t quantity[SENSOR_MAX_CHANNELS];  // enum sensor_quantity de cada canal
+
+    // Configuração inicial, bloqueante (boot), com o canal do mux já aberto.
+    // false: sensor ausente, fica fora das rodadas.
+    bool (*init)(struct sensor *s);
+
+    // Monta o disparo da conversão; retorna quantos us esperar até o
+    // resultado. tx_len 0 e rx_len 0: nada a enviar (ex.: modo contínuo).
+    uint32_t (*start)(struct sensor *s, struct sensor_xfer *x);
+
+    // Monta a leitura do resultado
+    void (*collect)(struct sensor *s, struct sensor_xfer *x);
+
+    // Converte sensor.raw em value[] (centésimos). Retorna 0 se a leitura é
+    // válida, > 0 para ler de novo depois desse tanto de us (conversão ainda
+    // em andamento) ou < 0 se a leitura deve ser descartada.
+    int32_t (*compensate)(struct sensor *s, int32_t *value);
+};
+
+struct sensor {
+    const struct sensor_driver *driver;
+    const char *label;
+    uint8_t bus;             // 0 = i2c0, 1 = i2c1
+    uint8_t addr;            // 0: o driver procura (BMP280 em 0x76 ou 0x77)
+    uint8_t mux_addr;        // 0 = ligado direto no barramento
+    uint8_t mux_channel;
+    uint8_t decimation;      // Participa de 1 a cada N rodadas (0 ou 1 = todas)
+
+    // Estado do driver
+    union {
+        struct {
+            struct bmp280_calib_param calib;
+            uint8_t profile;         // enum bmp280_profile
+            bool reprogram;          // Sensor saiu do modo do perfil (reinício)
+        } bmp280;
+        struct {
+            bool calibrated;         // Último status lido
+            bool reset_pending;      // Próxima rodada começa pelo soft reset (boot)
+            uint8_t phase;           // Último comando da rodada (aht20.c)
+        } aht20;
+    };
+
+    // Resultado da última rodada da qual participou
+    int32_t value[SENSOR_MAX_CHANNELS];
+    bool online;             // init deu certo
+    bool fresh;              // value veio da última rodada
+    uint32_t samples;
+    uint32_t errors;
+
+    // Escalonador (sensor_bus.c)
+    uint8_t step;
+    uint8_t retries;
+    uint32_t wait_us;
+    uint64_t ready_us;
+    uint8_t raw[SENSOR_RAW_MAX];
+};
+
+struct sensor_bus;
+
+struct sensor_bus_ops {
+    // Inicia uma transação no barramento e retorna na hora; o fim é avisado
+    // por sensor_bus_xfer_done (pode ser numa interrupção). false: não saiu.
+    bool (*submit)(void *ctx, uint8_t bus, uint8_t addr, const uint8_t *tx, uint8_t tx_len,
+                   uint8_t *rx, uint8_t rx_len);
+    // Escrita bloqueante, usada só no registro (canal do mux antes do init)
+    bool (*write_blocking)(void *ctx, uint8_t bus, uint8_t addr, const uint8_t *data, uint8_t len);
+    // Fim de uma rodada, chamado de dentro de sensor_bus_poll (pode ser NULL)
+    void (*round_done)(struct sensor_bus *b, void *ctx);
+};
+
+struct sensor_bus_stats {
+    uint32_t rounds;
+    uint32_t overruns;       // Rodada pedida com a anterior ainda em andamento
+    uint32_t transfers;
+    uint32_t mux_switches;
+    uint32_t last_round_us;
+    uint32_t max_round_us;
+};
+
+// Barramento físico: uma transação em andamento e o canal de mux aberto
+struct sensor_lane {
+    struct sensor *owner;    // NULL: a transação em andamento é do mux
+    bool busy;
+    volatile int8_t result;  // 0 em andamento, 1 ok, -1 falha (escrito por sensor_bus_xfer_done)
+    uint8_t mux_addr;        // Canal aberto (mux_addr 0 = nenhum)
+    uint8_t mux_channel;
+    uint8_t mux_pending;     // Máscara sendo escrita no mux
+    uint8_t mux_pending_addr;
+    struct sensor *mux_target; // Sensor à espera da escrita no mux
+    struct sensor_xfer xfer; // Buffer da transação em andamento
+};
+
+struct sensor_bus {
+    const struct sensor_bus_ops *ops;
+    void *ctx;
+    struct sensor *sensor[SENSOR_MAX];
+    uint8_t count;
+    struct sensor_lane lane[SENSOR_BUSES];
+    bool running;
+    uint32_t round;          // Rodada atual (em round_done, a que terminou)
+    uint64_t round_start_us;
+    struct sensor_bus_stats stats;
+};
+
+void sensor_bus_init(struct sensor_bus *b, const struct sensor_bus_ops *ops, void *ctx);
+
+// Abre o canal do mux (se houver) e chama driver->init. Um sensor que não
+// respondeu fica registrado, com online false. Retorna false com o registro
+// cheio ou com o endereço já usado por outro sensor sem um canal de mux que
+// os separe (nesse caso o sensor fica de fora).
+bool sensor_bus_add(struct sensor_bus *b, struct sensor *s);
+
+// Começa uma rodada com os sensores da vez (decimation). false se a rodada
+// anterior ainda não terminou (conta em stats.overruns).
+bool sensor_bus_start_round(struct sensor_bus *b, uint64_t now_us);
+
+// Avança as transações e esperas. Chame depois de start_round, a cada
+// sensor_bus_xfer_done e no prazo retornado (SENSOR_NO_DEADLINE: nada a
+// esperar além das transações em andamento).
+uint64_t sensor_bus_poll(struct sensor_bus *b, uint64_t now_us);
+
+// Fim da transação em andamento no barramento. Só registra o resultado:
+// pode ser chamada em interrupção, e o processamento fica para o poll.
+void sensor_bus_xfer_done(struct sensor_bus *b, uint8_t bus, bool ok);
+
+bool sensor_bus_running(const struct sensor_bus *b);
+
+// O sensor participou da última rodada e não trouxe leitura válida
+bool sensor_failed(const struct sensor *s);
+
+// Identifica o sensor no rastro (trace.h): barramento, mux, canal e endereço
+static inline uint32_t sensor_trace_id(const struct sensor *s) {
+    return (uint32_t)s->bus << 24 | (uint32_t)s->mux_addr << 16 | (uint32_t)s->mux_channel << 8 | s->addr;
+}
+
+#endif // SENSOR_BUS_H
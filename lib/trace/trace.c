@@ -0,0 +1,131 @@
+#include "trace.h"
+
+#ifdef ESTACAO_TRACE
+
+#include <string.h>
+
+struct trace_ring trace_rings[TRACE_CORES];
+volatile bool trace_frozen;
+
+// Resposta de /trace (little-endian, como no RP2040 e no PC):
+//   cabeçalho: "TRC1", u16 tamanho do registro, u8 eventos, u8 núcleos,
+//              u32 registros, u32 bytes da tabela de eventos
+//   tabela:    por evento, u8 tipo (enum trace_kind) e o nome com '\0',
+//              completada com zeros até múltiplo de 4
+//   registros: struct trace_record, o núcleo 0 e depois o 1, do mais antigo
+//              para o mais novo
+#define TRACE_HEADER_SIZE 16
+#define TRACE_NAMES_MAX   240
+
+static const struct {
+    const char *name;
+    uint8_t kind;
+} trace_event_info[TRACE_EVENT_COUNT] = {
+#define TRACE_EVENT_INFO(id, name, kind) {name, kind},
+    TRACE_EVENTS(TRACE_EVENT_INFO)
+#undef TRACE_EVENT_INFO
+};
+
+static uint8_t dump_header[TRACE_HEADER_SIZE + TRACE_NAMES_MAX];
+static uint32_t dump_header_len;
+static uint32_t dump_total_len;
+static uint32_t dump_first[TRACE_CORES]; // Primeiro registro enviado de cada anel
+static uint32_t dump_count[TRACE_CORES];
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+uint32_t trace_freeze(void)
+{
+    trace_frozen = true;
+    __dmb();
+
+    // Uma marca do outro núcleo que já tinha passado pelo teste de
+    // trace_frozen ainda pode estar escrevendo a posição head do anel, que
+    // num anel cheio é a do registro mais antigo: essa posição fica de fora
+    uint32_t records = 0;
+    for (int core = 0; core < TRACE_CORES; core++) {
+        uint32_t head = trace_rings[core].head;
+        dump_count[core] = head < TRACE_RECORDS ? head : TRACE_RECORDS - 1;
+        dump_first[core] = head - dump_count[core];
+        records += dump_count[core];
+    }
+
+    uint32_t names = 0;
+    uint8_t *p = dump_header + TRACE_HEADER_SIZE;
+    for (int i = 0; i < TRACE_EVENT_COUNT; i++) {
+        size_t len = strlen(trace_event_info[i].name) + 1;
+        if (names + 1 + len > TRACE_NAMES_MAX) {
+            break; // Tabela cortada: o conversor mostra os demais pelo número
+        }
+        p[names++] = trace_event_info[i].kind;
+        memcpy(p + names, trace_event_info[i].name, len);
+        names += len;
+    }
+    while (names % 4) {
+        p[names++] = 0;
+    }
+
+    memcpy(dump_header, "TRC1", 4);
+    put_u16(dump_header + 4, sizeof(struct trace_record));
+    dump_header[6] = TRACE_EVENT_COUNT;
+    dump_header[7] = TRACE_CORES;
+    put_u32(dump_header + 8, records);
+    put_u32(dump_header + 12, names);
+    dump_header_len = TRACE_HEADER_SIZE + names;
+    dump_total_len = dump_header_len + records * sizeof(struct trace_record);
+    return dump_total_len;
+}
+
+uint16_t trace_fill(uint32_t arg, uint32_t offset, uint8_t *buf, uint16_t max)
+{
+    (void)arg;
+    uint32_t start = offset;
+    uint16_t written = 0;
+    if (offset < dump_header_len) {
+        uint32_t n = dump_header_len - offset;
+        written = (uint16_t)(n < max ? n : max);
+        memcpy(buf, dump_header + offset, written);
+        offset += written;
+    }
+    if (offset >= dump_header_len) {
+        uint32_t index = (offset - dump_header_len) / sizeof(struct trace_record);
+        uint32_t skip = (offset - dump_header_len) % sizeof(struct trace_record);
+        for (int core = 0; core < TRACE_CORES && written < max; core++) {
+            const struct trace_ring *ring = &trace_rings[core];
+            for (; index < dump_count[core] && written < max; index++) {
+                const struct trace_record *r = &ring->record[(dump_first[core] + index) & (TRACE_RECORDS - 1)];
+                uint32_t n = sizeof(*r) - skip;
+                n = n < (uint32_t)(max - written) ? n : (uint32_t)(max - written);
+                memcpy(buf + written, (const uint8_t *)r + skip, n);
+                written += (uint16_t)n;
+                skip = (skip + n) % sizeof(*r);
+                if (skip) {
+                    break; // Registro cortado: continua no próximo pedaço
+                }
+            }
+            index = index >= dump_count[core] ? index - dump_count[core] : index;
+        }
+    }
+
+    // Último pedaço entregue: volta a gravar, com os anéis vazios
+    if (start + written == dump_total_len && trace_frozen) {
+        for (int core = 0; core < TRACE_CORES; core++) {
+            trace_rings[core].head = 0;
+        }
+        __dmb();
+        trace_frozen = false;
+    }
+    return written;
+}
+
+#endif // ESTACAO_TRACE
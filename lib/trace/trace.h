@@ -0,0 +1,119 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Rastro binário dos caminhos quentes, para ver numa linha do tempo (Chrome
+// trace / Perfetto) uma rodada de leitura e uma requisição HTTP ao mesmo
+// tempo, sem printf (a USB muda justamente o tempo que se quer medir).
+//
+// Cada marca é um registro de 16 bytes (time_us_64, evento, fase, núcleo,
+// argumento de 32 bits) num anel em RAM por núcleo; o anel guarda os últimos
+// TRACE_RECORDS registros. GET /trace congela os anéis e os envia, e
+// tools/trace_dump.py converte a resposta em JSON do Chrome trace.
+//
+// Sem ESTACAO_TRACE (opção do CMake) as macros somem: nem os argumentos são
+// avaliados e os anéis não ocupam RAM.
+//
+// Eventos: X(identificador, nome, tipo). SPAN: início e fim no mesmo núcleo,
+// aninhados (uma fatia na linha do núcleo). ASYNC: início e fim em momentos
+// ou núcleos diferentes, casados pelo argumento (ex.: transação I2C que
+// termina por interrupção).
+#define TRACE_EVENTS(X)                                       \
+    X(HTTP_RECV,         "http_recv",         TRACE_SPAN)     \
+    X(HTTP_SENT,         "http_sent",         TRACE_SPAN)     \
+    X(BMP280_READ,       "bmp280_read",       TRACE_ASYNC)    \
+    X(BMP280_COMPENSATE, "bmp280_compensate", TRACE_SPAN)     \
+    X(AHT20_READ,        "aht20_read",        TRACE_ASYNC)    \
+    X(AHT20_COMPENSATE,  "aht20_compensate",  TRACE_SPAN)     \
+    X(ALERT_EVAL,        "alert_eval",        TRACE_SPAN)     \
+    X(SET_ONE_LED,       "set_one_led",       TRACE_SPAN)
+
+enum trace_kind {
+    TRACE_SPAN,
+    TRACE_ASYNC,
+};
+
+enum trace_event {
+#define TRACE_EVENT_ID(id, name, kind) TRACE_##id,
+    TRACE_EVENTS(TRACE_EVENT_ID)
+#undef TRACE_EVENT_ID
+    TRACE_EVENT_COUNT
+};
+
+enum trace_phase {
+    TRACE_PHASE_BEGIN,
+    TRACE_PHASE_END,
+};
+
+struct trace_record {
+    uint64_t time_us;  // time_us_64
+    uint8_t event;     // enum trace_event
+    uint8_t phase;     // enum trace_phase
+    uint8_t core;
+    uint8_t reserved;
+    uint32_t arg;
+};
+
+#ifdef ESTACAO_TRACE
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+#define TRACE_CORES   2
+#define TRACE_RECORDS 512 // Por núcleo (potência de 2): 8 KB cada
+
+// Um anel por núcleo: o laço de eventos e as interrupções do mesmo núcleo
+// (o lwIP roda numa interrupção no núcleo 0) disputam só o próprio anel, e
+// um registro é escrito inteiro com as interrupções desligadas (poucos
+// ciclos). head só avança depois do registro completo, então quem envia vê
+// apenas registros inteiros.
+struct trace_ring {
+    struct trace_record record[TRACE_RECORDS];
+    volatile uint32_t head; // Registros escritos desde o boot
+};
+
+extern struct trace_ring trace_rings[TRACE_CORES];
+extern volatile bool trace_frozen;
+
+static inline void trace_mark(enum trace_event event, enum trace_phase phase, uint32_t arg)
+{
+    unsigned core = get_core_num();
+    struct trace_ring *ring = &trace_rings[core];
+    uint32_t irq = save_and_disable_interrupts();
+    if (!trace_frozen) {
+        uint32_t head = ring->head;
+        struct trace_record *r = &ring->record[head & (TRACE_RECORDS - 1)];
+        r->time_us = time_us_64();
+        r->event = (uint8_t)event;
+        r->phase = (uint8_t)phase;
+        r->core = (uint8_t)core;
+        r->arg = arg;
+        __compiler_memory_barrier();
+        ring->head = head + 1;
+    }
+    restore_interrupts(irq);
+}
+
+#define TRACE_BEGIN(event, arg) trace_mark(TRACE_##event, TRACE_PHASE_BEGIN, (uint32_t)(arg))
+#define TRACE_END(event, arg)   trace_mark(TRACE_##event, TRACE_PHASE_END, (uint32_t)(arg))
+
+// Congela os anéis (as marcas passam a ser ignoradas) e retorna o tamanho da
+// resposta de /trace: cabeçalho, tabela de eventos e registros
+uint32_t trace_freeze(void);
+
+// Corpo de /trace (http_body_fill_fn). Ao entregar o último byte os anéis
+// recomeçam vazios; um envio interrompido deixa tudo congelado até o próximo
+// GET /trace, que reenvia o mesmo rastro.
+uint16_t trace_fill(uint32_t arg, uint32_t offset, uint8_t *buf, uint16_t max);
+
+#else
+
+// sizeof não avalia o argumento: só evita aviso de variável sem uso
+#define TRACE_BEGIN(event, arg) ((void)sizeof(arg))
+#define TRACE_END(event, arg)   ((void)sizeof(arg))
+
+#endif // ESTACAO_TRACE
+
+#endif // TRACE_H
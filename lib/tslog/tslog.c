@@ -0,0 +1,441 @@
+#include <string.h>
+#include "tslog.h"
+
+// Cabeçalho do bloco (little-endian):
+//   0 magic  2 quantidade  4 sequência  8 horário da 1ª amostra
+//  12 CRC-16 (página inteira exceto o próprio campo)  14 bits usados
+#define TSLOG_MAGIC        0x4C54 // "TL"
+#define TSLOG_PAYLOAD_BITS ((TSLOG_PAGE_SIZE - TSLOG_HEADER_SIZE) * 8)
+
+static uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t rd32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static void wr16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void wr32(uint8_t *p, uint32_t v) { wr16(p, (uint16_t)v); wr16(p + 2, (uint16_t)(v >> 16)); }
+
+// CRC-16/CCITT-FALSE
+static uint16_t crc16_update(uint16_t crc, const uint8_t *data, uint32_t len)
+{
+    while (len--) {
+        crc ^= (uint16_t)(*data++ << 8);
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t page_crc(const uint8_t *page)
+{
+    uint16_t crc = crc16_update(0xFFFF, page, 12);
+    return crc16_update(crc, page + 14, TSLOG_PAGE_SIZE - 14);
+}
+
+// Cabeçalho plausível (sem conferir o CRC): usado na varredura e na busca
+static bool header_ok(const uint8_t *page)
+{
+    uint16_t count = rd16(page + 2);
+    return rd16(page) == TSLOG_MAGIC && count > 0 && rd16(page + 14) <= TSLOG_PAYLOAD_BITS;
+}
+
+static const uint8_t *page_at(const struct tslog *log, uint32_t page)
+{
+    return log->flash->base + page * TSLOG_PAGE_SIZE;
+}
+
+static uint32_t page_of_seq(const struct tslog *log, uint32_t seq)
+{
+    return (log->newest_page + log->pages - (log->newest_seq - seq) % log->pages) % log->pages;
+}
+
+// ---- Códigos de tamanho variável ----
+//   0                    -> 0
+//   10   + 4 bits        -> 1..15
+//   110  + 8 bits        -> 16..255
+//   1110 + 16 bits       -> 256..65535
+//   1111 + 32 bits       -> restante
+// aplicados ao zig-zag do delta (variações pequenas, de qualquer sinal, ficam curtas)
+
+static uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static int32_t unzigzag(uint32_t z) { return (int32_t)(z >> 1) ^ -(int32_t)(z & 1); }
+
+static unsigned code_bits(uint32_t z)
+{
+    if (z == 0) return 1;
+    if (z < 16) return 2 + 4;
+    if (z < 256) return 3 + 8;
+    if (z < 65536) return 4 + 16;
+    return 4 + 32;
+}
+
+static void put_bits(struct tslog *log, uint32_t value, unsigned n)
+{
+    uint8_t *payload = log->page + TSLOG_HEADER_SIZE;
+    while (n--) {
+        if ((value >> n) & 1) {
+            payload[log->bit_pos >> 3] |= (uint8_t)(0x80 >> (log->bit_pos & 7));
+        }
+        log->bit_pos++;
+    }
+}
+
+static void put_code(struct tslog *log, uint32_t z)
+{
+    if (z == 0) {
+        put_bits(log, 0, 1);
+    } else if (z < 16) {
+        put_bits(log, 0x2, 2);
+        put_bits(log, z, 4);
+    } else if (z < 256) {
+        put_bits(log, 0x6, 3);
+        put_bits(log, z, 8);
+    } else if (z < 65536) {
+        put_bits(log, 0xE, 4);
+        put_bits(log, z, 16);
+    } else {
+        put_bits(log, 0xF, 4);
+        put_bits(log, z, 32);
+    }
+}
+
+// ---- Escrita ----
+
+static void block_begin(struct tslog *log, uint32_t time)
+{
+    memset(log->page, 0, sizeof(log->page));
+    wr16(log->page, TSLOG_MAGIC);
+    wr32(log->page + 8, time);
+    log->count = 0;
+    log->bit_pos = 0;
+    log->prev_time = time;
+    log->prev_delta = 0;
+    memset(log->prev_value, 0, sizeof(log->prev_value));
+}
+
+bool tslog_flush(struct tslog *log)
+{
+    if (log->count == 0) {
+        return true;
+    }
+    const struct tslog_flash *flash = log->flash;
+    uint32_t seq = log->newest_seq + 1;
+    uint32_t page = log->next_page;
+    bool ok = true;
+
+    if (page % TSLOG_PAGES_PER_SECTOR == 0) {
+        // Entrando num setor: ele é o mais antigo do anel e perde seus blocos
+        ok = flash->erase(page * TSLOG_PAGE_SIZE);
+        uint32_t keep = log->pages - TSLOG_PAGES_PER_SECTOR;
+        if (log->newest_seq && log->newest_seq - log->oldest_seq + 1 > keep) {
+            log->oldest_seq = log->newest_seq - keep + 1;
+        }
+    }
+
+    wr32(log->page + 4, seq);
+    wr16(log->page + 12, page_crc(log->page));
+    if (ok) {
+        ok = flash->program(page * TSLOG_PAGE_SIZE, log->page);
+    }
+
+    // Mesmo com falha a sequência e a página avançam: o bloco ruim é
+    // rejeitado pelo CRC na leitura e a correspondência seq -> página se mantém
+    if (log->newest_seq == 0) {
+        log->oldest_seq = seq;
+    }
+    log->newest_seq = seq;
+    log->newest_page = page;
+    log->next_page = (page + 1) % log->pages;
+    log->count = 0;
+    log->bit_pos = 0;
+    return ok;
+}
+
+bool tslog_append(struct tslog *log, const struct tslog_record *record)
+{
+    if (log->last_time && record->time <= log->last_time) {
+        return false;
+    }
+
+    if (log->count > 0) {
+        uint32_t delta = record->time - log->prev_time;
+        unsigned bits = code_bits(zigzag((int32_t)(delta - log->prev_delta)));
+        for (int c = 0; c < TSLOG_CHANNELS; c++) {
+            bits += code_bits(zigzag(record->value[c] - log->prev_value[c]));
+        }
+        if (log->bit_pos + bits > TSLOG_PAYLOAD_BITS || log->count == UINT16_MAX) {
+            tslog_flush(log);
+        }
+    }
+    if (log->count == 0) {
+        block_begin(log, record->time);
+    }
+
+    uint32_t delta = record->time - log->prev_time;
+    put_code(log, zigzag((int32_t)(delta - log->prev_delta)));
+    for (int c = 0; c < TSLOG_CHANNELS; c++) {
+        put_code(log, zigzag(record->value[c] - log->prev_value[c]));
+        log->prev_value[c] = record->value[c];
+    }
+    log->prev_time = record->time;
+    log->prev_delta = delta;
+    log->last_time = record->time;
+    log->count++;
+    // Cabeçalho sempre coerente, para tslog_query ler o bloco ainda em RAM
+    wr16(log->page + 2, log->count);
+    wr16(log->page + 14, log->bit_pos);
+    return true;
+}
+
+// ---- Leitura ----
+
+struct block_reader {
+    const uint8_t *payload;
+    uint16_t bits;
+    uint16_t bit_pos;
+    uint16_t remaining;
+    uint32_t prev_time;
+    uint32_t prev_delta;
+    int32_t prev_value[TSLOG_CHANNELS];
+};
+
+static void reader_init(struct block_reader *r, const uint8_t *page)
+{
+    r->payload = page + TSLOG_HEADER_SIZE;
+    r->bits = rd16(page + 14);
+    r->bit_pos = 0;
+    r->remaining = rd16(page + 2);
+    r->prev_time = rd32(page + 8);
+    r->prev_delta = 0;
+    memset(r->prev_value, 0, sizeof(r->prev_value));
+}
+
+static bool get_bits(struct block_reader *r, unsigned n, uint32_t *out)
+{
+    if (r->bit_pos + n > r->bits) {
+        return false;
+    }
+    uint32_t v = 0;
+    while (n--) {
+        v = (v << 1) | ((r->payload[r->bit_pos >> 3] >> (7 - (r->bit_pos & 7))) & 1);
+        r->bit_pos++;
+    }
+    *out = v;
+    return true;
+}
+
+static bool get_code(struct block_reader *r, uint32_t *z)
+{
+    static const uint8_t width[] = {0, 4, 8, 16, 32};
+    unsigned prefix = 0;
+    uint32_t bit;
+    while (prefix < 4) {
+        if (!get_bits(r, 1, &bit)) {
+            return false;
+        }
+        if (!bit) {
+            break;
+        }
+        prefix++;
+    }
+    if (prefix == 0) {
+        *z = 0;
+        return true;
+    }
+    return get_bits(r, width[prefix], z);
+}
+
+static bool reader_next(struct block_reader *r, struct tslog_record *out)
+{
+    if (r->remaining == 0) {
+        return false;
+    }
+    uint32_t z;
+    if (!get_code(r, &z)) {
+        return false;
+    }
+    r->prev_delta += (uint32_t)unzigzag(z);
+    r->prev_time += r->prev_delta;
+    out->time = r->prev_time;
+    for (int c = 0; c < TSLOG_CHANNELS; c++) {
+        if (!get_code(r, &z)) {
+            return false;
+        }
+        r->prev_value[c] += unzigzag(z);
+        out->value[c] = r->prev_value[c];
+    }
+    r->remaining--;
+    return true;
+}
+
+int tslog_decode_block(const uint8_t *page, struct tslog_record *out, int max)
+{
+    struct block_reader r;
+    reader_init(&r, page);
+    int n = 0;
+    while (n < max && reader_next(&r, &out[n])) {
+        n++;
+    }
+    return n;
+}
+
+const uint8_t *tslog_block(const struct tslog *log, uint32_t seq)
+{
+    if (log->newest_seq == 0 || seq < log->oldest_seq || seq > log->newest_seq) {
+        return NULL;
+    }
+    const uint8_t *page = page_at(log, page_of_seq(log, seq));
+    if (!header_ok(page) || rd32(page + 4) != seq || rd16(page + 12) != page_crc(page)) {
+        return NULL;
+    }
+    return page;
+}
+
+uint32_t tslog_seek(const struct tslog *log, uint32_t time)
+{
+    if (log->newest_seq == 0) {
+        return 1;
+    }
+    // Último bloco com início <= time. Cabeçalhos ilegíveis contam como
+    // "depois" de time: a busca termina mais cedo e a varredura os pula.
+    uint32_t lo = log->oldest_seq;
+    uint32_t hi = log->newest_seq + 1;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const uint8_t *page = page_at(log, page_of_seq(log, mid));
+        if (header_ok(page) && rd32(page + 4) == mid && rd32(page + 8) <= time) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+uint32_t tslog_query(const struct tslog *log, uint32_t from, uint32_t to,
+                     tslog_record_fn fn, void *ctx)
+{
+    uint32_t total = 0;
+    struct block_reader r;
+    struct tslog_record record;
+
+    for (uint32_t seq = tslog_seek(log, from); seq <= log->newest_seq; seq++) {
+        const uint8_t *page = tslog_block(log, seq);
+        if (!page) {
+            continue;
+        }
+        if (rd32(page + 8) > to) {
+            return total;
+        }
+        reader_init(&r, page);
+        while (reader_next(&r, &record)) {
+            if (record.time > to) {
+                return total;
+            }
+            if (record.time >= from) {
+                fn(&record, ctx);
+                total++;
+            }
+        }
+    }
+
+    // Bloco ainda em RAM
+    if (log->count > 0) {
+        reader_init(&r, log->page);
+        while (reader_next(&r, &record) && record.time <= to) {
+            if (record.time >= from) {
+                fn(&record, ctx);
+                total++;
+            }
+        }
+    }
+    return total;
+}
+
+uint32_t tslog_last_time(const struct tslog *log)
+{
+    return log->last_time;
+}
+
+uint32_t tslog_open_since(const struct tslog *log)
+{
+    return log->count ? rd32(log->page + 8) : 0;
+}
+
+uint32_t tslog_oldest_seq(const struct tslog *log)
+{
+    return log->oldest_seq;
+}
+
+uint32_t tslog_newest_seq(const struct tslog *log)
+{
+    return log->newest_seq;
+}
+
+// ---- Inicialização ----
+
+static bool page_blank(const uint8_t *page)
+{
+    for (int i = 0; i < TSLOG_PAGE_SIZE; i++) {
+        if (page[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void tslog_init(struct tslog *log, const struct tslog_flash *flash)
+{
+    memset(log, 0, sizeof(*log));
+    log->flash = flash;
+    log->pages = flash->size / TSLOG_PAGE_SIZE;
+
+    uint32_t oldest = UINT32_MAX;
+    for (uint32_t p = 0; p < log->pages; p++) {
+        const uint8_t *page = page_at(log, p);
+        if (!header_ok(page)) {
+            continue;
+        }
+        uint32_t seq = rd32(page + 4);
+        if (seq == 0 || seq == UINT32_MAX) {
+            continue;
+        }
+        if (seq > log->newest_seq) {
+            log->newest_seq = seq;
+            log->newest_page = p;
+        }
+        if (seq < oldest) {
+            oldest = seq;
+        }
+    }
+    if (log->newest_seq == 0) {
+        return; // Log vazio: começa na página 0 (apagando o setor)
+    }
+
+    log->oldest_seq = oldest;
+    if (log->newest_seq - oldest + 1 > log->pages) {
+        log->oldest_seq = log->newest_seq - log->pages + 1;
+    }
+
+    // Continua após o bloco mais novo; uma página suja (gravação interrompida)
+    // faz pular para o próximo setor, que será apagado antes do uso
+    log->next_page = (log->newest_page + 1) % log->pages;
+    if (log->next_page % TSLOG_PAGES_PER_SECTOR != 0 && !page_blank(page_at(log, log->next_page))) {
+        uint32_t skip = TSLOG_PAGES_PER_SECTOR - log->next_page % TSLOG_PAGES_PER_SECTOR;
+        log->newest_seq += skip;   // Mantém seq -> página para as páginas puladas
+        log->newest_page = (log->newest_page + skip) % log->pages;
+        log->next_page = (log->next_page + skip) % log->pages;
+    }
+
+    // Horário da última amostra gravada, para não aceitar horários anteriores
+    for (uint32_t seq = log->newest_seq; seq >= log->oldest_seq && seq > 0; seq--) {
+        const uint8_t *page = tslog_block(log, seq);
+        if (page) {
+            struct block_reader r;
+            struct tslog_record record;
+            reader_init(&r, page);
+            while (reader_next(&r, &record)) {
+                log->last_time = record.time;
+            }
+            break;
+        }
+    }
+}
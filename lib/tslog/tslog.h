@@ -0,0 +1,102 @@
+#ifndef TSLOG_H
+#define TSLOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Log de série temporal em flash, estruturado como anel de setores.
+//
+// Cada página de 256 bytes é um bloco independente: cabeçalho (sequência,
+// horário da primeira amostra, quantidade, CRC) + fluxo de bits comprimido.
+// Os horários usam delta-of-delta e os canais usam delta, ambos em zig-zag
+// com código de prefixo (0 = sem variação em 1 bit). O bloco em construção
+// fica em RAM e é gravado de uma vez quando enche: uma programação de página
+// por bloco e um apagamento de setor a cada TSLOG_PAGES_PER_SECTOR blocos,
+// sempre no setor mais antigo (desgaste distribuído por igual).
+//
+// Os cabeçalhos ficam em posições fixas e em ordem de tempo, então uma
+// consulta por intervalo acha o primeiro bloco por busca binária e só
+// descomprime os blocos do intervalo.
+//
+// Este arquivo não depende do SDK: o acesso à flash vem por struct tslog_flash
+// (tslog_flash.c no RP2040, RAM nos testes de bancada em tools/).
+
+#define TSLOG_CHANNELS         4    // temp. AHT, umid. AHT, temp. BMP (0,01), pressão (Pa)
+#define TSLOG_PAGE_SIZE        256
+#define TSLOG_SECTOR_SIZE      4096
+#define TSLOG_PAGES_PER_SECTOR (TSLOG_SECTOR_SIZE / TSLOG_PAGE_SIZE)
+#define TSLOG_HEADER_SIZE      16
+#define TSLOG_MAX_PER_BLOCK    ((TSLOG_PAGE_SIZE - TSLOG_HEADER_SIZE) * 8 / (1 + TSLOG_CHANNELS)) // 1 bit por campo, no mínimo
+
+struct tslog_record {
+    uint32_t time;                   // Segundos (relógio do log, ver wall_clock.h)
+    int32_t value[TSLOG_CHANNELS];
+};
+
+// Região de flash usada pelo log (múltiplo de TSLOG_SECTOR_SIZE)
+struct tslog_flash {
+    const uint8_t *base;             // Leitura direta (XIP no RP2040)
+    uint32_t size;
+    bool (*erase)(uint32_t offset);  // Apaga o setor que começa em offset
+    bool (*program)(uint32_t offset, const uint8_t *page); // Grava uma página apagada
+};
+
+struct tslog {
+    const struct tslog_flash *flash;
+    uint32_t pages;                  // Total de páginas da região
+    uint32_t oldest_seq;             // Bloco mais antigo ainda na flash
+    uint32_t newest_seq;             // Último bloco gravado (0 = nenhum)
+    uint32_t newest_page;            // Página física de newest_seq
+    uint32_t next_page;              // Onde o próximo bloco será gravado
+    uint32_t last_time;              // Horário da última amostra aceita
+
+    // Bloco em construção
+    uint8_t page[TSLOG_PAGE_SIZE];
+    uint16_t count;
+    uint16_t bit_pos;                // Bits usados após o cabeçalho
+    uint32_t prev_time;
+    uint32_t prev_delta;
+    int32_t prev_value[TSLOG_CHANNELS];
+};
+
+// Procura o bloco mais novo e o mais antigo na flash e prepara a próxima gravação
+void tslog_init(struct tslog *log, const struct tslog_flash *flash);
+
+// Acrescenta uma amostra. Horários devem ser crescentes (amostras fora de
+// ordem são descartadas). Quando o bloco enche ele é gravado na flash.
+// Um leitor (tslog_block, tslog_seek) pode interromper a gravação: ele só
+// aceita páginas com cabeçalho, sequência e CRC certos, então um bloco em
+// transição (setor recém-apagado, sequência já avançada) fica de fora.
+bool tslog_append(struct tslog *log, const struct tslog_record *record);
+
+// Grava o bloco em construção mesmo incompleto (ex.: aberto há muito tempo,
+// antes de reiniciar)
+bool tslog_flush(struct tslog *log);
+
+// Horário da primeira amostra do bloco em construção (0 se ele está vazio)
+uint32_t tslog_open_since(const struct tslog *log);
+
+// Horário da amostra mais recente já aceita (0 se o log está vazio)
+uint32_t tslog_last_time(const struct tslog *log);
+
+// Faixa de sequências gravadas na flash (newest 0 = nenhum bloco). O bloco
+// em construção na RAM não tem sequência ainda.
+uint32_t tslog_oldest_seq(const struct tslog *log);
+uint32_t tslog_newest_seq(const struct tslog *log);
+
+// Página gravada do bloco seq, ou NULL se não existe mais ou está corrompida
+const uint8_t *tslog_block(const struct tslog *log, uint32_t seq);
+
+// Sequência do primeiro bloco que pode conter amostras a partir de time
+// (busca binária nos cabeçalhos); newest_seq + 1 se não houver nenhum
+uint32_t tslog_seek(const struct tslog *log, uint32_t time);
+
+// Descomprime um bloco; retorna quantas amostras escreveu em out (até max)
+int tslog_decode_block(const uint8_t *page, struct tslog_record *out, int max);
+
+// Chama fn para cada amostra com from <= time <= to, em ordem; retorna o total
+typedef void (*tslog_record_fn)(const struct tslog_record *record, void *ctx);
+uint32_t tslog_query(const struct tslog *log, uint32_t from, uint32_t to,
+                     tslog_record_fn fn, void *ctx);
+
+#endif // TSLOG_H
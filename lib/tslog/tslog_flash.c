@@ -0,0 +1,59 @@
+#include <assert.h>
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "tslog_flash.h"
+
+extern char __flash_binary_end;
+
+// Apagar/programar tira a flash do modo XIP: flash_safe_execute desliga as
+// interrupções (e pausa o outro núcleo, se estiver rodando) durante a operação.
+// Um setor leva dezenas de ms, mas só acontece a cada 16 blocos (horas).
+#define TSLOG_FLASH_TIMEOUT_MS 100
+
+struct program_args {
+    uint32_t offset;
+    const uint8_t *page;
+};
+
+static void do_erase(void *param)
+{
+    flash_range_erase(TSLOG_FLASH_OFFSET + (uint32_t)(uintptr_t)param, FLASH_SECTOR_SIZE);
+}
+
+static void do_program(void *param)
+{
+    const struct program_args *args = param;
+    flash_range_program(TSLOG_FLASH_OFFSET + args->offset, args->page, FLASH_PAGE_SIZE);
+}
+
+static bool tslog_flash_erase(uint32_t offset)
+{
+    return flash_safe_execute(do_erase, (void *)(uintptr_t)offset, TSLOG_FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+static bool tslog_flash_program(uint32_t offset, const uint8_t *page)
+{
+    struct program_args args = {offset, page};
+    return flash_safe_execute(do_program, &args, TSLOG_FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+static const struct tslog_flash tslog_flash_region = {
+    .base = (const uint8_t *)(XIP_BASE + TSLOG_FLASH_OFFSET),
+    .size = TSLOG_FLASH_SIZE,
+    .erase = tslog_flash_erase,
+    .program = tslog_flash_program,
+};
+
+bool tslog_flash_init(struct tslog *log)
+{
+    static_assert(TSLOG_PAGE_SIZE == FLASH_PAGE_SIZE && TSLOG_SECTOR_SIZE == FLASH_SECTOR_SIZE,
+                  "geometria do log diferente da flash");
+    if ((uintptr_t)&__flash_binary_end - XIP_BASE > TSLOG_FLASH_OFFSET) {
+        printf("Erro: firmware invade a regiao do log em flash\n");
+        return false;
+    }
+    tslog_init(log, &tslog_flash_region);
+    return true;
+}
@@ -0,0 +1,14 @@
+#ifndef TSLOG_FLASH_H
+#define TSLOG_FLASH_H
+
+#include "tslog.h"
+#include "flash_layout.h"
+
+// Região do log no fim da flash (flash_layout.h): 512 KB = 128 setores,
+// cerca de duas semanas de amostras a cada 10 s (ver tools/bench_tslog.c)
+
+// Liga o log à região reservada da flash interna e varre os blocos gravados.
+// Retorna false (log desabilitado) se o firmware invadir a região.
+bool tslog_flash_init(struct tslog *log);
+
+#endif // TSLOG_FLASH_H
@@ -0,0 +1,41 @@
+#include "fmt_fixed.h"
+
+// Dígitos de v em ordem, sem zeros à esquerda (v = 0 escreve "0")
+static char *fmt_u32(char *out, uint32_t v)
+{
+    char tmp[10];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n) {
+        *out++ = tmp[--n];
+    }
+    return out;
+}
+
+char *fmt_int(char *out, int32_t value)
+{
+    uint32_t v = (uint32_t)value;
+    if (value < 0) {
+        *out++ = '-';
+        v = 0u - v;
+    }
+    return fmt_u32(out, v);
+}
+
+char *fmt_fixed2(char *out, int32_t centi)
+{
+    uint32_t v = (uint32_t)centi;
+    if (centi < 0) {
+        *out++ = '-';
+        v = 0u - v;
+    }
+    out = fmt_u32(out, v / 100);
+    uint32_t frac = v % 100;
+    *out++ = '.';
+    *out++ = (char)('0' + frac / 10);
+    *out++ = (char)('0' + frac % 10);
+    return out;
+}
@@ -0,0 +1,40 @@
+#ifndef FMT_FIXED_H
+#define FMT_FIXED_H
+
+#include <stdint.h>
+
+#define FMT_FIXED2_MAX 13 // "-21474836.48": maior saída de fmt_fixed2, sem '\0'
+
+// Escreve um valor em centésimos como decimal com duas casas ("-12.34"),
+// usando só inteiros: substitui o "%.2f" do printf, caro sem FPU.
+// Retorna o ponteiro após o último caractere (não termina a string).
+char *fmt_fixed2(char *out, int32_t centi);
+
+// Escreve um inteiro em decimal. Retorna o ponteiro após o último caractere.
+char *fmt_int(char *out, int32_t value);
+
+#define TO_CENTI_MAX 20000000.0f // Maior |valor| convertido; além disso satura
+
+// Converte para centésimos com arredondamento. A parte inteira é separada
+// antes da multiplicação (subtração exata em float): "valor * 100" direto
+// perderia a segunda casa em pressões (~100000 Pa excede 24 bits de mantissa).
+// Empates exatos arredondam para longe do zero (o printf usa par mais próximo).
+// Fora de ±TO_CENTI_MAX (inclusive infinito) satura em ±TO_CENTI_MAX * 100 e
+// NaN vira 0: quem recebe valores de fora deve validá-los antes.
+static inline int32_t to_centi(float value)
+{
+    if (value != value) {
+        return 0;
+    }
+    if (value >= TO_CENTI_MAX) {
+        return (int32_t)TO_CENTI_MAX * 100;
+    }
+    if (value <= -TO_CENTI_MAX) {
+        return -(int32_t)TO_CENTI_MAX * 100;
+    }
+    int32_t whole = (int32_t)value;
+    float frac = (value - (float)whole) * 100.0f;
+    return whole * 100 + (int32_t)(frac >= 0.0f ? frac + 0.5f : frac - 0.5f);
+}
+
+#endif // FMT_FIXED_H
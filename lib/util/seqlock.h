@@ -0,0 +1,53 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Seqlock para um escritor e leitores em outro núcleo, sem travas.
+//
+// O escritor incrementa a sequência antes e depois de copiar os dados
+// (ímpar = escrita em andamento). O leitor copia os dados e repete se a
+// sequência mudou ou era ímpar, então nunca fica com uma cópia misturada.
+// O escritor nunca espera; o leitor só repete se cruzar com uma escrita.
+// Os __dmb() ordenam as cópias entre os núcleos e barram o compilador.
+//
+//   seqlock_write_begin(&l); dados = novo; seqlock_write_end(&l);
+//
+//   do { s = seqlock_read_begin(&l); copia = dados; } while (seqlock_read_retry(&l, s));
+
+struct seqlock {
+    volatile uint32_t seq;
+};
+
+static inline void seqlock_write_begin(struct seqlock *lock)
+{
+    lock->seq++;
+    __dmb();
+}
+
+static inline void seqlock_write_end(struct seqlock *lock)
+{
+    __dmb();
+    lock->seq++;
+}
+
+static inline uint32_t seqlock_read_begin(const struct seqlock *lock)
+{
+    uint32_t seq;
+    while ((seq = lock->seq) & 1) {
+        tight_loop_contents();
+    }
+    __dmb();
+    return seq;
+}
+
+static inline bool seqlock_read_retry(const struct seqlock *lock, uint32_t seq)
+{
+    __dmb();
+    return lock->seq != seq;
+}
+
+#endif // SEQLOCK_H
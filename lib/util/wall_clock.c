@@ -0,0 +1,29 @@
+#include "pico/stdlib.h"
+#include "wall_clock.h"
+
+static uint32_t base_seconds; // Horário no instante base_us
+static uint64_t base_us;
+static bool synced;
+
+void wall_clock_init(uint32_t resume_from)
+{
+    base_seconds = resume_from;
+    base_us = time_us_64();
+}
+
+uint32_t wall_clock_now(void)
+{
+    return base_seconds + (uint32_t)((time_us_64() - base_us) / 1000000u);
+}
+
+bool wall_clock_synced(void)
+{
+    return synced;
+}
+
+void wall_clock_set_unix(uint32_t seconds)
+{
+    base_seconds = seconds;
+    base_us = time_us_64();
+    synced = true;
+}
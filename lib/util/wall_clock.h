@@ -0,0 +1,24 @@
+#ifndef WALL_CLOCK_H
+#define WALL_CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Relógio em segundos usado nos registros do log em flash.
+//
+// Antes da primeira resposta do SNTP ele continua a partir de um valor dado
+// no boot (o último horário gravado), então os horários nunca voltam atrás
+// entre reinícios; depois do SNTP passa a ser Unix time (UTC).
+// Atualizado no contexto do lwIP: leia com o lwIP travado.
+
+void wall_clock_init(uint32_t resume_from);
+
+uint32_t wall_clock_now(void);
+
+// true depois que o SNTP acertou o relógio pelo menos uma vez
+bool wall_clock_synced(void);
+
+// Chamado pelo SNTP do lwIP (SNTP_SET_SYSTEM_TIME em lwipopts.h)
+void wall_clock_set_unix(uint32_t seconds);
+
+#endif // WALL_CLOCK_H
@@ -1,15 +1,43 @@
+#include <errno.h>
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "lib/sensores/aht20.h"
 #include "lib/sensores/bmp280.h"
+#include "lib/sensores/sensor_bus.h" // Registro de sensores e escalonador do I2C
+#include "lib/sensores/i2c_async.h"  // Transações I2C por DMA
 #include "lib/buzzer/buzzer.h"
 #include "lib/led/led.h"
 #include "lib/matriz/matriz.h"
 #include "pico/cyw43_arch.h" // Biblioteca para arquitetura Wi-Fi da Pico com CYW43
-#include "lib/index_html.h"          // Página com gráficos
-#include "lib/html_limits_config.h" //  Página de limites
+#include "pico/async_context_poll.h" // Laços de eventos dos dois núcleos
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#include "lib/util/seqlock.h"          // Amostra publicada entre os núcleos
 #include "lwip/tcp.h"
+#include "lib/http/http_server.h" // Envio de respostas sem cópia
+#include "lib/http/http_router.h" // Tabela de rotas
+#include "lib/http/web_assets.h"  // Páginas e scripts gerados em build (gzip + ETag)
+#include "lib/http/http_sse.h"     // Stream /events (Server-Sent Events)
+#include "lib/http/http_ws.h"      // Canal binário /ws (WebSocket)
+#include "lib/util/fmt_fixed.h"     // Números em ponto fixo sem printf
+#include "lib/filter/filter.h"      // Filtros em ponto fixo das leituras
+#include "lib/history/history.h"    // Histórico de amostras no dispositivo
+#include "lib/tslog/tslog_flash.h"  // Log comprimido de longo prazo na flash
+#include "lib/util/wall_clock.h"    // Horário dos registros do log (SNTP)
+#include "lib/config/config_store.h" // Limites e offsets persistidos na flash
+#include "lib/metrics/metrics.h"     // Contadores por núcleo para /metrics
+#include "lib/trace/trace.h"         // Rastro dos caminhos quentes (/trace)
+#include "lib/log/dlog.h"             // Log adiado, formatado fora dos caminhos quentes
+#include "lib/alerts/alert_rules.h"   // Regras dos alertas (máscara, histerese, duração)
+#include "lwip/apps/sntp.h"
+#include "lwip/stats.h"
+#ifdef ESTACAO_BENCHMARKS
+#include "lib/bench/bench_cycles.h"
+#endif
 #include <math.h>
 
 #define I2C_PORT_0 i2c0               // i2c0 pinos 0 e 1
@@ -24,7 +52,15 @@
 // Wi-Fi credentials
 #define WIFI_SSID "Leonardo"
 #define WIFI_PASSWORD "00695470PI"
+#define SNTP_SERVER "pool.ntp.org"
 
+#define TSLOG_INTERVAL_S 10 // Uma amostra no log em flash a cada 10 s
+#define TSLOG_FLUSH_AGE_S (15 * 60) // Bloco incompleto mais velho que isso vai para a flash
+static struct tslog station_log;
+static bool g_log_ready;
+
+// Amostra atual vista pela rede: escrita só pelo núcleo 0, com o lwIP
+// travado, a partir da amostra publicada pelo núcleo 1 (ver publish_work)
 volatile float g_aht_temperature = 0.0f;
 volatile float g_aht_humidity = 0.0f;
 volatile float g_bmp_temperature = 0.0f; // Em °C
@@ -50,14 +86,46 @@ volatile bool g_alerts_enabled = true; //  Alertas habilitados por padrão
 volatile int g_current_page = 0; // 0 para a página principal (gráficos), 1 para a página de limites
 
 
-// Estrutura de dados
-struct http_state
+// Divisão entre os núcleos, cada um com seu async_context em modo poll:
+//  - núcleo 1 (sensor_context): leitura dos sensores, alertas e atuadores.
+//    Transações I2C lentas nunca atrasam a rede.
+//  - núcleo 0 (app_context): publicação das amostras (histórico, log, SSE,
+//    /ws) e manutenção; o lwIP segue no contexto em segundo plano do
+//    cyw43_arch, também no núcleo 0.
+// Cada trabalho é agendado com seu próprio prazo. A amostra completa passa do
+// núcleo 1 para o 0 por um seqlock, então nenhuma resposta mistura leituras.
+static async_context_poll_t app_context;
+static async_context_poll_t sensor_context;
+static volatile bool sensor_core_ready;
+
+static void alert_work(async_context_t *ctx, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t alert_worker = {.do_work = alert_work};
+
+// Pede ao núcleo 1 para reavaliar os alertas (limites alterados)
+static void request_alert_evaluation(void)
 {
-    char response[14000];
-    size_t len;
-    size_t sent;
+    if (sensor_core_ready) {
+        async_context_set_work_pending(&sensor_context.core, &alert_worker);
+    }
+}
+
+// Amostra completa, com offsets aplicados, em ponto fixo: o núcleo 1 só faz
+// contas com inteiros, e a conversão para float fica com quem exibe
+struct station_sample {
+    uint32_t time_ms;      // ms desde o boot, no momento da leitura
+    int32_t temp_aht;      // 0,01 °C
+    int32_t humidity_aht;  // 0,01 %
+    int32_t temp_bmp;      // 0,01 °C
+    int32_t pressure;      // 0,01 Pa
 };
 
+static struct seqlock sample_lock;
+static struct station_sample shared_sample; // Escrita pelo núcleo 1, lida pelo 0
+
+// Botão B alterado: o núcleo 0 invalida o JSON em cache e avisa o /ws com
+// o lwIP travado (a geração não pode mudar dentro da interrupção do GPIO)
+static void button_state_work(async_context_t *ctx, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t button_state_worker = {.do_work = button_state_work};
 
 #define BOTAO_A_PIN 5 
 #define BOTAO_B_PIN 6
@@ -67,7 +135,10 @@ void gpio_irq_handler(uint gpio, uint32_t events){
         uint64_t current_time = time_us_64();
         if (current_time - last_gpio_event_time > 200000) { // 200ms de debounce
             g_alerts_enabled = !g_alerts_enabled; // Alterna entre alertas ativos e desativos
-            printf("DEBUG: Botao B pressionado. Desativando alertas %d\n", g_alerts_enabled);
+            config_store_touch();
+            request_alert_evaluation();
+            async_context_set_work_pending(&app_context.core, &button_state_worker);
+            DLOG_DEBUG("DEBUG: Botao B pressionado. Desativando alertas %d\n", g_alerts_enabled);
             last_gpio_event_time = current_time;
         }
     }
@@ -76,7 +147,7 @@ void gpio_irq_handler(uint gpio, uint32_t events){
         uint64_t current_time = time_us_64();
         if (current_time - last_gpio_event_time > 200000) { // 200ms de debounce
             g_current_page = 1 - g_current_page; // Alterna entre 0 e 1
-            printf("DEBUG: Botao A pressionado. Alternando para pagina %d\n", g_current_page);
+            DLOG_DEBUG("DEBUG: Botao A pressionado. Alternando para pagina %d\n", g_current_page);
             last_gpio_event_time = current_time;
         }
     }
@@ -84,220 +155,1776 @@ void gpio_irq_handler(uint gpio, uint32_t events){
 
 
 
-// Função de callback para enviar dados HTTP
-static err_t http_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
-{
-    struct http_state *hs = (struct http_state *)arg;
-    hs->sent += len;
-    if (hs->sent >= hs->len)
-    {
-        tcp_close(tpcb);
-        free(hs);
-    }
-    return ERR_OK;
-}
-
-// Função de recebimento HTTP
-static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) { 
-
-    if (!p) { // Se não há pbuf, a conexão foi fechada pelo cliente
-        tcp_close(tpcb);
-        return ERR_OK;
-    }
-
-    char *req = (char *)p->payload;
-    struct http_state *hs = malloc(sizeof(struct http_state));
-    if (!hs) { // Falha na alocação de memória para o estado HTTP
-        pbuf_free(p);
-        tcp_close(tpcb);
-        return ERR_MEM; // Erro de memória
-    }
-    hs->sent = 0; // Zera o contador de bytes enviados
-
-    // IMPRIME A REQUISIÇÃO RECEBIDA PARA DEBBUG
-    printf("DEBUG: Requisição recebida: %s\n", req);
-
-    // TRATAMENTO DE ENDPOINTS ESPECÍFICOS (JSON ou TEXT PLAIN)
-    // 1. GET /system_state (busca de dados dos sensores e configurações)
-    if (strstr(req, "GET /system_state")) {
-        printf("DEBUG: Processando GET /system_state (JSON).\n");
-        char json_payload[512]; // Aumente se o JSON ficar maior
-        int json_len = snprintf(json_payload, sizeof(json_payload),
-                                "{"
-                                "\"temperatura_aht\":%.2f,"
-                                "\"umidade_aht\":%.2f,"
-                                "\"temperatura_bmp\":%.2f,"
-                                "\"pressao_bmp\":%.2f,"
-                                "\"temp_offset\":%.2f,"
-                                "\"humidity_offset\":%.2f,"
-                                "\"pressure_offset\":%.2f,"
-                                // Limites (seguem os offsets)
-                                "\"temp_min\":%.2f,"
-                                "\"temp_max\":%.2f,"
-                                "\"humidity_min\":%.2f,"
-                                "\"humidity_max\":%.2f,"
-                                "\"pressure_min\":%.2f,"
-                                "\"pressure_max\":%.2f,"
-                                "\"alerts_enabled\":%d" 
-                                "}\r\n",
-                                g_aht_temperature, g_aht_humidity,
-                                g_bmp_temperature, g_bmp_pressure,
-                                g_temp_offset, g_humidity_offset, g_pressure_offset,
-                                g_temp_min_limit, g_temp_max_limit,
-                                g_humidity_min_limit, g_humidity_max_limit,
-                                g_pressure_min_limit, g_pressure_max_limit,
-                                (int)g_alerts_enabled
-                            );
-
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-                            "HTTP/1.1 200 OK\r\n"
-                            "Content-Type: application/json\r\n"
-                            "Content-Length: %d\r\n"
-                            "Connection: close\r\n"
-                            "\r\n"
-                            "%s",
-                            json_len, json_payload);
-    }
-    // 2. POST /set_limits (salva os limites e estado dos alertas)
-    else if (strstr(req, "POST /set_limits")) {
-        printf("DEBUG: Processando POST /set_limits.\n");
-        char *body = strstr(req, "\r\n\r\n");
-        if (body) {
-            body += 4; // Avança para o início do corpo JSON
-            float t_min, t_max, h_min, h_max, p_min, p_max;
-            int alerts_on_int;
-            // Tenta ler todos os 7 valores do JSON
-            if (sscanf(body, "{\"temp_min\":%f,\"temp_max\":%f,\"humidity_min\":%f,\"humidity_max\":%f,\"pressure_min\":%f,\"pressure_max\":%f,\"alerts_enabled\":%d",
-                       &t_min, &t_max, &h_min, &h_max, &p_min, &p_max, &alerts_on_int) == 7) {
-                if (t_min < t_max && h_min < h_max && p_min < p_max) {
-                    g_temp_min_limit = t_min;
-                    g_temp_max_limit = t_max;
-                    g_humidity_min_limit = h_min;
-                    g_humidity_max_limit = h_max;
-                    g_pressure_min_limit = p_min;
-                    g_pressure_max_limit = p_max;
-                    g_alerts_enabled = (bool)alerts_on_int; // Atualiza o estado dos alertas
-
-                    printf("DEBUG: Limites atualizados: Temp %.2f-%.2f, Hum %.2f-%.2f, Press %.2f-%.2f, Alertas: %d\n",
-                           g_temp_min_limit, g_temp_max_limit, g_humidity_min_limit, g_humidity_max_limit,
-                           g_pressure_min_limit, g_pressure_max_limit, g_alerts_enabled);
-
-                    const char *success_msg = "Limites atualizados com sucesso.";
-                    hs->len = snprintf(hs->response, sizeof(hs->response),
-                                        "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-                                        (int)strlen(success_msg), success_msg);
-                } else {
-                    const char *error_msg = "Valores de limite invalidos (min >= max).";
-                    hs->len = snprintf(hs->response, sizeof(hs->response),
-                                        "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-                                        (int)strlen(error_msg), error_msg);
-                }
-            } else {
-                const char *error_msg = "Formato de dados invalido para set_limits.";
-                hs->len = snprintf(hs->response, sizeof(hs->response),
-                                    "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-                                    (int)strlen(error_msg), error_msg);
-            }
+// Incrementado a cada amostra nova e a cada alteração de limites/offsets.
+// Só é alterado com o lwIP travado (callbacks ou cyw43_arch_lwip_begin/end).
+volatile uint32_t g_state_generation = 0;
+
+static void mark_state_changed(void)
+{
+    g_state_generation++;
+}
+
+// Offsets em centésimos para o núcleo 1, refeitos a cada alteração
+static volatile int32_t g_temp_offset_centi;
+static volatile int32_t g_humidity_offset_centi;
+static volatile int32_t g_pressure_offset_centi;
+
+static void update_fixed_offsets(void)
+{
+    g_temp_offset_centi = to_centi(g_temp_offset);
+    g_humidity_offset_centi = to_centi(g_humidity_offset);
+    g_pressure_offset_centi = to_centi(g_pressure_offset);
+}
+
+// Alertas (alert_rules.h): um canal por par de limites. O núcleo 0 monta a
+// configuração (faixas em centésimos, a partir dos limites, e a tabela de
+// regras, editável por /alert_rules) e a publica por um seqlock; o núcleo 1
+// copia quando a sequência muda e avalia cada amostra só com inteiros.
+enum alert_channel {
+    ALERT_CH_TEMP,       // Temperatura do AHT20
+    ALERT_CH_HUMIDITY,   // Umidade do AHT20
+    ALERT_CH_PRESSURE,   // Pressão do BMP280
+    ALERT_CHANNELS
+};
+
+#define ALERT_BIT(ch)          ((uint64_t)1 << (ch))
+#define ALERT_BEEP_HZ          2000
+#define ALERT_BEEP_MS          50
+#define ALERT_BEEP_PERIOD_MS   1000   // O bipe da regra ativa se repete neste período
+#define ALERT_MIN_DURATION_MS  3000   // ~3 amostras seguidas fora (ou de volta) da faixa
+#define ALERT_MAX_DURATION_MS  600000
+
+static const char *const alert_channel_names[ALERT_CHANNELS] = {"temperatura", "umidade", "pressao"};
+
+// Histerese pedida de cada canal (centésimos); a efetiva fica limitada a
+// meia faixa, para limites estreitos continuarem válidos
+static int32_t alert_hysteresis[ALERT_CHANNELS] = {
+    [ALERT_CH_TEMP] = 50,        // 0,5 °C
+    [ALERT_CH_HUMIDITY] = 200,   // 2 %
+    [ALERT_CH_PRESSURE] = 10000, // 100 Pa
+};
+
+// Regras padrão, na ordem das combinações que o alerta sempre teve
+#define ALERT_RULE(bits, prio, red, green, blue, label) \
+    {.mask = (bits), .priority = (prio), .r = (red), .g = (green), .b = (blue), .led = ALERT_LED_RED, \
+     .beep_hz = ALERT_BEEP_HZ, .beep_ms = ALERT_BEEP_MS, .name = label}
+
+static struct seqlock alert_lock;
+static struct alert_config alert_shared = { // Escrita só pelo núcleo 0
+    .channels = ALERT_CHANNELS,
+    .band = {
+        [ALERT_CH_TEMP] = {.min_duration_ms = ALERT_MIN_DURATION_MS},
+        [ALERT_CH_HUMIDITY] = {.min_duration_ms = ALERT_MIN_DURATION_MS},
+        [ALERT_CH_PRESSURE] = {.min_duration_ms = ALERT_MIN_DURATION_MS},
+    },
+    .rules = 6,
+    .rule = {
+        ALERT_RULE(ALERT_BIT(ALERT_CH_PRESSURE) | ALERT_BIT(ALERT_CH_HUMIDITY), 60, 0, 125, 0, "pressao+umidade"),
+        ALERT_RULE(ALERT_BIT(ALERT_CH_HUMIDITY) | ALERT_BIT(ALERT_CH_TEMP), 50, 125, 0, 125, "umidade+temperatura"),
+        ALERT_RULE(ALERT_BIT(ALERT_CH_TEMP) | ALERT_BIT(ALERT_CH_PRESSURE), 40, 125, 125, 125, "temperatura+pressao"),
+        ALERT_RULE(ALERT_BIT(ALERT_CH_HUMIDITY), 30, 0, 0, 125, "umidade"),
+        ALERT_RULE(ALERT_BIT(ALERT_CH_PRESSURE), 20, 125, 125, 0, "pressao"),
+        ALERT_RULE(ALERT_BIT(ALERT_CH_TEMP), 10, 125, 0, 0, "temperatura"),
+    },
+};
+
+// Estado da última avaliação, para o GET /alert_rules (escrito pelo núcleo 1)
+static struct seqlock alert_status_lock;
+static struct alert_status {
+    uint64_t out;
+    int8_t active;
+} alert_status = {.active = ALERT_NONE};
+
+// Faixas dos canais a partir dos limites (float, da interface) em centésimos.
+// Os limites já passaram por limits_valid; se ainda assim uma faixa sair vazia
+// (min >= max), as faixas anteriores continuam valendo e retorna false.
+static bool update_alert_bands(void)
+{
+    const volatile float *const limits[ALERT_CHANNELS][2] = {
+        [ALERT_CH_TEMP] = {&g_temp_min_limit, &g_temp_max_limit},
+        [ALERT_CH_HUMIDITY] = {&g_humidity_min_limit, &g_humidity_max_limit},
+        [ALERT_CH_PRESSURE] = {&g_pressure_min_limit, &g_pressure_max_limit},
+    };
+    struct alert_band bands[ALERT_CHANNELS];
+    for (int i = 0; i < ALERT_CHANNELS; i++) {
+        struct alert_band *band = &bands[i];
+        *band = alert_shared.band[i]; // Mantém a duração mínima
+        band->min = to_centi(*limits[i][0]);
+        band->max = to_centi(*limits[i][1]);
+        if (band->min >= band->max) {
+            DLOG_WARN("Erro: limites de %s sem faixa valida; faixas dos alertas mantidas\n",
+                      alert_channel_names[i]);
+            return false;
+        }
+        int32_t half = (band->max - band->min) / 2;
+        band->hysteresis = alert_hysteresis[i] < half ? alert_hysteresis[i] : half;
+    }
+    seqlock_write_begin(&alert_lock);
+    memcpy(alert_shared.band, bands, sizeof(bands));
+    seqlock_write_end(&alert_lock);
+    return true;
+}
+
+// Limites/offsets alterados: atualiza os clientes e agenda a gravação na flash
+static void mark_config_changed(void)
+{
+    update_fixed_offsets();
+    update_alert_bands();
+    mark_state_changed();
+    config_store_touch();
+    request_alert_evaluation(); // Reavalia já, sem esperar a próxima leitura
+}
+
+// Faixas aceitas para limites e offsets, nas unidades de /system_state. Cabem
+// nos campos do /ws (temperatura e umidade em int16 de centésimos, pressão em
+// 32 bits) e ficam longe da saturação de to_centi. NaN e infinito falham em
+// todas as comparações.
+#define LIMIT_TEMP_RANGE        200.0f    // °C, ±
+#define LIMIT_HUMIDITY_MAX      100.0f    // %, de 0
+#define LIMIT_PRESSURE_MAX      200000.0f // Pa, de 0
+#define OFFSET_TEMP_RANGE       100.0f    // °C, ±
+#define OFFSET_HUMIDITY_RANGE   100.0f    // %, ±
+#define OFFSET_PRESSURE_RANGE   20000.0f  // Pa, ±
+
+static bool in_range(float value, float lo, float hi)
+{
+    return value >= lo && value <= hi;
+}
+
+// Limites dentro das faixas e com mínimo abaixo do máximo já em centésimos,
+// como nas faixas dos alertas (20.001 e 20.004 dariam uma faixa vazia)
+static bool limits_valid(float t_min, float t_max, float h_min, float h_max, float p_min, float p_max)
+{
+    return in_range(t_min, -LIMIT_TEMP_RANGE, LIMIT_TEMP_RANGE) &&
+           in_range(t_max, -LIMIT_TEMP_RANGE, LIMIT_TEMP_RANGE) &&
+           in_range(h_min, 0.0f, LIMIT_HUMIDITY_MAX) && in_range(h_max, 0.0f, LIMIT_HUMIDITY_MAX) &&
+           in_range(p_min, 0.0f, LIMIT_PRESSURE_MAX) && in_range(p_max, 0.0f, LIMIT_PRESSURE_MAX) &&
+           to_centi(t_min) < to_centi(t_max) && to_centi(h_min) < to_centi(h_max) &&
+           to_centi(p_min) < to_centi(p_max);
+}
+
+static bool offsets_valid(float t, float h, float p)
+{
+    return in_range(t, -OFFSET_TEMP_RANGE, OFFSET_TEMP_RANGE) &&
+           in_range(h, -OFFSET_HUMIDITY_RANGE, OFFSET_HUMIDITY_RANGE) &&
+           in_range(p, -OFFSET_PRESSURE_RANGE, OFFSET_PRESSURE_RANGE);
+}
+
+// Registro da flash aceitável (gravado por uma versão sem a validação acima?)
+static bool config_valid(const struct station_config *config)
+{
+    return limits_valid(config->temp_min_limit, config->temp_max_limit, config->humidity_min_limit,
+                        config->humidity_max_limit, config->pressure_min_limit, config->pressure_max_limit) &&
+           offsets_valid(config->temp_offset, config->humidity_offset, config->pressure_offset);
+}
+
+static void apply_config(const struct station_config *config)
+{
+    g_temp_min_limit = config->temp_min_limit;
+    g_temp_max_limit = config->temp_max_limit;
+    g_humidity_min_limit = config->humidity_min_limit;
+    g_humidity_max_limit = config->humidity_max_limit;
+    g_pressure_min_limit = config->pressure_min_limit;
+    g_pressure_max_limit = config->pressure_max_limit;
+    g_temp_offset = config->temp_offset;
+    g_humidity_offset = config->humidity_offset;
+    g_pressure_offset = config->pressure_offset;
+    g_alerts_enabled = config->alerts_enabled != 0;
+    update_fixed_offsets();
+}
+
+static void capture_config(struct station_config *config)
+{
+    config->temp_min_limit = g_temp_min_limit;
+    config->temp_max_limit = g_temp_max_limit;
+    config->humidity_min_limit = g_humidity_min_limit;
+    config->humidity_max_limit = g_humidity_max_limit;
+    config->pressure_min_limit = g_pressure_min_limit;
+    config->pressure_max_limit = g_pressure_max_limit;
+    config->temp_offset = g_temp_offset;
+    config->humidity_offset = g_humidity_offset;
+    config->pressure_offset = g_pressure_offset;
+    config->alerts_enabled = g_alerts_enabled;
+}
+
+// Grava a configuração depois de CONFIG_STORE_SAVE_DELAY_MS sem alterações.
+// A cópia é feita com o lwIP travado (os handlers rodam no contexto dele) e
+// a gravação fora, já que ela desliga as interrupções por dezenas de ms.
+static void save_config_if_due(void)
+{
+    struct station_config config;
+    cyw43_arch_lwip_begin();
+    bool due = config_store_due(to_ms_since_boot(get_absolute_time()));
+    if (due) {
+        capture_config(&config);
+    }
+    cyw43_arch_lwip_end();
+    if (due) {
+        if (config_store_save(&config)) {
+            DLOG_DEBUG("DEBUG: Configuracao gravada na flash.\n");
         } else {
-            const char *error_msg = "Corpo da requisicao vazio para set_limits.";
-            hs->len = snprintf(hs->response, sizeof(hs->response),
-                                "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-                                (int)strlen(error_msg), error_msg);
+            DLOG_ERROR("Erro ao gravar a configuracao na flash!\n");
+            config_store_touch(); // Tenta de novo após o mesmo intervalo
         }
     }
-    else if (strstr(req, "POST /set_offsets")) {
-        printf("DEBUG: Processando POST /set_offsets.\n");
-        char *body = strstr(req, "\r\n\r\n");
-        if (body) {
-            body += 4;
-            float t_offset, h_offset, p_offset;
-            if (sscanf(body, "{\"temp_offset\":%f,\"humidity_offset\":%f,\"pressure_offset\":%f",
-                    &t_offset, &h_offset, &p_offset) == 3) {
-                g_temp_offset = t_offset;
-                g_humidity_offset = h_offset;
-                g_pressure_offset = p_offset;
-
-
-                const char *success_msg = "Offsets atualizados com sucesso.";
-                hs->len = snprintf(hs->response, sizeof(hs->response),
-                                    "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-                                    (int)strlen(success_msg), success_msg);
-            } else {
-                const char *error_msg = "Formato de dados invalido para set_offsets.";
-                hs->len = snprintf(hs->response, sizeof(hs->response),
-                                    "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-                                    (int)strlen(error_msg), error_msg);
-            }
+}
+
+// Grava o bloco do log em RAM se a primeira amostra dele passou de
+// TSLOG_FLUSH_AGE_S: um reset perde no máximo esse intervalo. Blocos comuns
+// enchem antes (~12 min); só os muito comprimidos, de leituras estáveis,
+// saem incompletos. O relógio é lido com o lwIP travado e a gravação é feita
+// fora, como em publish_system_state.
+static void flush_log_if_old(void)
+{
+    if (!g_log_ready) {
+        return;
+    }
+    cyw43_arch_lwip_begin();
+    uint32_t now = wall_clock_now();
+    cyw43_arch_lwip_end();
+    uint32_t since = tslog_open_since(&station_log);
+    if (since && now >= since + TSLOG_FLUSH_AGE_S) {
+        tslog_flush(&station_log);
+    }
+}
+
+// Campos numéricos do JSON, na ordem em que aparecem
+static const struct {
+    const char *key; // Já com aspas, dois-pontos e vírgula de separação
+    volatile float *value;
+} state_fields[] = {
+    {"{\"temperatura_aht\":", &g_aht_temperature},
+    {",\"umidade_aht\":",     &g_aht_humidity},
+    {",\"temperatura_bmp\":", &g_bmp_temperature},
+    {",\"pressao_bmp\":",     &g_bmp_pressure},
+    {",\"temp_offset\":",     &g_temp_offset},
+    {",\"humidity_offset\":", &g_humidity_offset},
+    {",\"pressure_offset\":", &g_pressure_offset},
+    // Limites (seguem os offsets)
+    {",\"temp_min\":",        &g_temp_min_limit},
+    {",\"temp_max\":",        &g_temp_max_limit},
+    {",\"humidity_min\":",    &g_humidity_min_limit},
+    {",\"humidity_max\":",    &g_humidity_max_limit},
+    {",\"pressure_min\":",    &g_pressure_min_limit},
+    {",\"pressure_max\":",    &g_pressure_max_limit},
+};
+
+#define STATE_JSON_MAX 420 // 13 chaves + 13 valores de até FMT_FIXED2_MAX + alertas + seq
+
+// Serializa sensores, offsets e limites no JSON usado por /system_state e
+// /events, só com aritmética inteira (fmt_fixed2 no lugar de "%.2f")
+static int format_system_state(char *buf)
+{
+    char *p = buf;
+    for (size_t i = 0; i < count_of(state_fields); i++) {
+        size_t key_len = strlen(state_fields[i].key);
+        memcpy(p, state_fields[i].key, key_len);
+        p = fmt_fixed2(p + key_len, to_centi(*state_fields[i].value));
+    }
+    static const char alerts_key[] = ",\"alerts_enabled\":";
+    memcpy(p, alerts_key, sizeof(alerts_key) - 1);
+    p += sizeof(alerts_key) - 1;
+    *p++ = g_alerts_enabled ? '1' : '0';
+    static const char seq_key[] = ",\"seq\":"; // Última amostra do histórico (cursor de /history)
+    memcpy(p, seq_key, sizeof(seq_key) - 1);
+    p = fmt_int(p + sizeof(seq_key) - 1, (int32_t)history_last_seq());
+    *p++ = '}';
+    return (int)(p - buf);
+}
+
+// JSON da geração atual, serializado no máximo uma vez por geração e
+// compartilhado por /system_state e /events. Chamar com o lwIP travado.
+static char state_json[STATE_JSON_MAX];
+static u16_t state_json_len;
+static uint32_t state_json_generation;
+static bool state_json_valid;
+
+static const char *system_state_json(u16_t *len)
+{
+    uint32_t generation = g_state_generation;
+    if (!state_json_valid || state_json_generation != generation) {
+        state_json_len = (u16_t)format_system_state(state_json);
+        state_json_generation = generation;
+        state_json_valid = true;
+    }
+    *len = state_json_len;
+    return state_json;
+}
+
+#ifdef ESTACAO_BENCHMARKS
+// Serialização anterior (printf com float), mantida só para comparação
+static int format_system_state_printf(char *buf, size_t size)
+{
+    return snprintf(buf, size,
+                    "{"
+                    "\"temperatura_aht\":%.2f,"
+                    "\"umidade_aht\":%.2f,"
+                    "\"temperatura_bmp\":%.2f,"
+                    "\"pressao_bmp\":%.2f,"
+                    "\"temp_offset\":%.2f,"
+                    "\"humidity_offset\":%.2f,"
+                    "\"pressure_offset\":%.2f,"
+                    "\"temp_min\":%.2f,"
+                    "\"temp_max\":%.2f,"
+                    "\"humidity_min\":%.2f,"
+                    "\"humidity_max\":%.2f,"
+                    "\"pressure_min\":%.2f,"
+                    "\"pressure_max\":%.2f,"
+                    "\"alerts_enabled\":%d,"
+                    "\"seq\":%lu"
+                    "}",
+                    g_aht_temperature, g_aht_humidity,
+                    g_bmp_temperature, g_bmp_pressure,
+                    g_temp_offset, g_humidity_offset, g_pressure_offset,
+                    g_temp_min_limit, g_temp_max_limit,
+                    g_humidity_min_limit, g_humidity_max_limit,
+                    g_pressure_min_limit, g_pressure_max_limit,
+                    (int)g_alerts_enabled, (unsigned long)history_last_seq()
+                    );
+}
+
+// Ciclos por serialização: printf antigo, formatador inteiro e cache da geração
+static void bench_system_state(void)
+{
+    enum { RUNS = 100 };
+    char buf[STATE_JSON_MAX];
+    uint32_t printf_cycles = 0, fixed_cycles = 0, cached_cycles = 0;
+    u16_t len;
+
+    bench_cycles_init();
+    for (int i = 0; i < RUNS; i++) {
+        uint32_t t0 = bench_cycles_now();
+        format_system_state_printf(buf, sizeof(buf));
+        printf_cycles += bench_cycles_since(t0);
+
+        t0 = bench_cycles_now();
+        format_system_state(buf);
+        fixed_cycles += bench_cycles_since(t0);
+
+        t0 = bench_cycles_now();
+        system_state_json(&len);
+        cached_cycles += bench_cycles_since(t0);
+    }
+    printf("BENCH system_state: printf %lu ciclos, fmt_fixed2 %lu ciclos, cache %lu ciclos\n",
+           (unsigned long)(printf_cycles / RUNS), (unsigned long)(fixed_cycles / RUNS),
+           (unsigned long)(cached_cycles / RUNS));
+}
+#endif
+
+// Mensagens binárias do /ws: little-endian, valores em centésimos (0,01 °C,
+// 0,01 %, 0,01 Pa), o primeiro byte indica o tipo.
+//   Servidor -> cliente
+//     WS_MSG_SAMPLE (15 bytes): u32 ms desde o boot, i16 temp. AHT, u16 umid. AHT,
+//                               i16 temp. BMP, u32 pressão
+//     WS_MSG_CONFIG (26 bytes): i16 offset temp., i16 offset umid., i32 offset pressão,
+//                               i16 temp. mín/máx, u16 umid. mín/máx,
+//                               u32 pressão mín/máx, u8 alertas
+//   Cliente -> servidor
+//     WS_MSG_SET_LIMITS  (18 bytes): mesmos campos de limites + alertas do CONFIG
+//     WS_MSG_SET_OFFSETS (9 bytes):  mesmos campos de offsets do CONFIG
+// Toda alteração aceita é confirmada com um CONFIG para todos os clientes;
+// uma alteração rejeitada recebe o CONFIG atual só no cliente que a enviou.
+#define WS_MSG_SAMPLE      0x01
+#define WS_MSG_CONFIG      0x02
+#define WS_MSG_SET_LIMITS  0x10
+#define WS_MSG_SET_OFFSETS 0x11
+
+#define WS_SAMPLE_LEN      15
+#define WS_CONFIG_LEN      26
+#define WS_SET_LIMITS_LEN  18
+#define WS_SET_OFFSETS_LEN 9
+
+static u8_t *put_u16(u8_t *p, u16_t v)
+{
+    p[0] = (u8_t)v;
+    p[1] = (u8_t)(v >> 8);
+    return p + 2;
+}
+
+static u8_t *put_u32(u8_t *p, u32_t v)
+{
+    p[0] = (u8_t)v;
+    p[1] = (u8_t)(v >> 8);
+    p[2] = (u8_t)(v >> 16);
+    p[3] = (u8_t)(v >> 24);
+    return p + 4;
+}
+
+static u16_t get_u16(const u8_t *p)
+{
+    return (u16_t)(p[0] | (p[1] << 8));
+}
+
+static u32_t get_u32(const u8_t *p)
+{
+    return (u32_t)p[0] | ((u32_t)p[1] << 8) | ((u32_t)p[2] << 16) | ((u32_t)p[3] << 24);
+}
+
+static u16_t encode_ws_config(u8_t *buf)
+{
+    u8_t *p = buf;
+    *p++ = WS_MSG_CONFIG;
+    p = put_u16(p, (u16_t)to_centi(g_temp_offset));
+    p = put_u16(p, (u16_t)to_centi(g_humidity_offset));
+    p = put_u32(p, (u32_t)to_centi(g_pressure_offset));
+    p = put_u16(p, (u16_t)to_centi(g_temp_min_limit));
+    p = put_u16(p, (u16_t)to_centi(g_temp_max_limit));
+    p = put_u16(p, (u16_t)to_centi(g_humidity_min_limit));
+    p = put_u16(p, (u16_t)to_centi(g_humidity_max_limit));
+    p = put_u32(p, (u32_t)to_centi(g_pressure_min_limit));
+    p = put_u32(p, (u32_t)to_centi(g_pressure_max_limit));
+    *p++ = g_alerts_enabled ? 1 : 0;
+    return (u16_t)(p - buf);
+}
+
+static void button_state_work(async_context_t *ctx, async_when_pending_worker_t *worker)
+{
+    u8_t config[WS_CONFIG_LEN];
+    cyw43_arch_lwip_begin();
+    mark_state_changed(); // /system_state e o próximo /events já saem com alerts_enabled novo
+    if (http_ws_client_count()) {
+        http_ws_broadcast(config, encode_ws_config(config));
+    }
+    cyw43_arch_lwip_end();
+}
+
+// Alterações de limites e offsets vindas do /ws (mesmas regras dos POSTs)
+static void ws_message_handler(struct http_state *hs, const u8_t *data, u16_t len)
+{
+    bool accepted = false;
+    if (len == WS_SET_LIMITS_LEN && data[0] == WS_MSG_SET_LIMITS) {
+        float t_min = (int16_t)get_u16(data + 1) / 100.0f;
+        float t_max = (int16_t)get_u16(data + 3) / 100.0f;
+        float h_min = get_u16(data + 5) / 100.0f;
+        float h_max = get_u16(data + 7) / 100.0f;
+        float p_min = get_u32(data + 9) / 100.0f;
+        float p_max = get_u32(data + 13) / 100.0f;
+        if (limits_valid(t_min, t_max, h_min, h_max, p_min, p_max)) {
+            g_temp_min_limit = t_min;
+            g_temp_max_limit = t_max;
+            g_humidity_min_limit = h_min;
+            g_humidity_max_limit = h_max;
+            g_pressure_min_limit = p_min;
+            g_pressure_max_limit = p_max;
+            g_alerts_enabled = data[17] != 0;
+            mark_config_changed();
+            DLOG_DEBUG("DEBUG: Limites atualizados via /ws.\n");
+            accepted = true;
+        }
+    } else if (len == WS_SET_OFFSETS_LEN && data[0] == WS_MSG_SET_OFFSETS) {
+        float t = (int16_t)get_u16(data + 1) / 100.0f;
+        float h = (int16_t)get_u16(data + 3) / 100.0f;
+        float p = (int32_t)get_u32(data + 5) / 100.0f;
+        if (offsets_valid(t, h, p)) {
+            g_temp_offset = t;
+            g_humidity_offset = h;
+            g_pressure_offset = p;
+            mark_config_changed();
+            DLOG_DEBUG("DEBUG: Offsets atualizados via /ws.\n");
+            accepted = true;
+        }
+    }
+
+    u8_t config[WS_CONFIG_LEN];
+    u16_t config_len = encode_ws_config(config);
+    if (accepted) {
+        http_ws_broadcast(config, config_len);
+    } else {
+        http_ws_send(hs, config, config_len);
+    }
+}
+
+// Registro do log em flash, no máximo um a cada TSLOG_INTERVAL_S (false:
+// ainda não é hora). Pressão com resolução de 1 Pa (a do BMP280 em modo normal).
+static bool log_record(const struct history_sample *sample, struct tslog_record *record)
+{
+    uint32_t now = wall_clock_now();
+    if (tslog_last_time(&station_log) && now < tslog_last_time(&station_log) + TSLOG_INTERVAL_S) {
+        return false;
+    }
+    *record = (struct tslog_record){
+        .time = now,
+        .value = {sample->temp_aht, sample->humidity_aht, sample->temp_bmp,
+                  (int32_t)((sample->pressure + 50) / 100)},
+    };
+    return true;
+}
+
+// Torna a amostra atual, guarda no histórico e a envia aos clientes de
+// /events (JSON) e /ws (binário), cada formato montado uma única vez para todos
+static void publish_system_state(const struct station_sample *current)
+{
+    struct history_sample sample = {
+        .time_ms = current->time_ms,
+        .pressure = (uint32_t)current->pressure,
+        .temp_aht = (int16_t)current->temp_aht,
+        .humidity_aht = (uint16_t)current->humidity_aht,
+        .temp_bmp = (int16_t)current->temp_bmp,
+    };
+
+    u8_t ws_sample[WS_SAMPLE_LEN];
+    u8_t *p = ws_sample;
+    *p++ = WS_MSG_SAMPLE;
+    p = put_u32(p, sample.time_ms);
+    p = put_u16(p, (u16_t)sample.temp_aht);
+    p = put_u16(p, sample.humidity_aht);
+    p = put_u16(p, (u16_t)sample.temp_bmp);
+    p = put_u32(p, sample.pressure);
+
+    struct tslog_record record;
+    bool log_due = false;
+
+    cyw43_arch_lwip_begin(); // O lwIP roda em interrupção (threadsafe_background)
+    g_aht_temperature = current->temp_aht / 100.0f; // Os quatro juntos para os handlers
+    g_aht_humidity = current->humidity_aht / 100.0f;
+    g_bmp_temperature = current->temp_bmp / 100.0f;
+    g_bmp_pressure = current->pressure / 100.0f;
+    history_push(&sample); // /history lê o buffer no contexto do lwIP
+    if (g_log_ready) {
+        log_due = log_record(&sample, &record); // O relógio é acertado pelo SNTP, no contexto do lwIP
+    }
+    mark_state_changed();
+    if (http_sse_client_count()) {
+        static const char prefix[] = "data: ";
+        char frame[sizeof(prefix) - 1 + STATE_JSON_MAX + 2];
+        u16_t json_len;
+        const char *json = system_state_json(&json_len);
+        memcpy(frame, prefix, sizeof(prefix) - 1);
+        memcpy(frame + sizeof(prefix) - 1, json, json_len);
+        u16_t len = sizeof(prefix) - 1 + json_len;
+        frame[len++] = '\n';
+        frame[len++] = '\n';
+        http_sse_broadcast(frame, len);
+    }
+    if (http_ws_client_count()) {
+        http_ws_broadcast(ws_sample, sizeof(ws_sample));
+    }
+    cyw43_arch_lwip_end();
+
+    // Fora da trava, como save_config_if_due: o bloco cheio vai para a flash
+    // (com apagamento de setor a cada 16 blocos) sem parar a rede. O /log
+    // pode ler no meio; tslog_block e tslog_seek conferem cada cabeçalho.
+    if (log_due) {
+        tslog_append(&station_log, &record);
+    }
+}
+
+// HANDLERS DAS ROTAS HTTP (requisições já interpretadas pelo servidor)
+
+// GET /system_state (busca de dados dos sensores e configurações)
+static err_t handle_system_state(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    u16_t json_len;
+    const char *json = system_state_json(&json_len);
+    // O cache é reescrito na próxima geração: o lwIP copia o corpo
+    return http_send_response(tpcb, hs, 200, "application/json", json, json_len, HTTP_BODY_COPY);
+}
+
+// GET /events (stream com uma atualização por amostra)
+static err_t handle_events(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    return http_sse_subscribe(tpcb, hs);
+}
+
+// GET /ws (WebSocket: amostras binárias e alterações de limites/offsets)
+static err_t handle_ws(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    err_t err = http_ws_upgrade(tpcb, hs, req, ws_message_handler);
+    if (err == ERR_OK && hs->mode == HTTP_MODE_WEBSOCKET) {
+        u8_t config[WS_CONFIG_LEN];
+        http_ws_send(hs, config, encode_ws_config(config)); // Estado inicial da configuração
+    }
+    return err;
+}
+
+// Corpo do /history: registros history_sample a partir da sequência first
+// (arg); o offset pode cair no meio de um registro
+static u16_t history_fill(u32_t first, u32_t offset, u8_t *buf, u16_t max)
+{
+    const u32_t record = sizeof(struct history_sample);
+    u16_t written = 0;
+    while (written < max) {
+        struct history_sample sample;
+        if (!history_get(first + offset / record, &sample)) {
+            break; // Sobrescrita durante o envio (cliente lento demais)
+        }
+        u32_t skip = offset % record;
+        u16_t n = (u16_t)LWIP_MIN(record - skip, (u32_t)(max - written));
+        memcpy(buf + written, (const u8_t *)&sample + skip, n);
+        written += n;
+        offset += n;
+    }
+    return written;
+}
+
+// GET /history?since=<seq>: amostras com sequência maior que since (todas se
+// ausente), em registros binários de 16 bytes (struct history_sample).
+// X-History-First traz a sequência do primeiro registro e X-History-Now o
+// relógio do dispositivo, para o cliente converter time_ms em horário.
+static err_t handle_history(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    u32_t since = 0;
+    http_query_u32(req->query, "since", &since);
+    u32_t last = history_last_seq();
+    // since >= last antes do + 1: since=4294967295 daria a volta e pediria o buffer todo
+    u32_t first = since >= last ? last + 1 : LWIP_MAX(since + 1, history_first_seq());
+    u32_t count = last >= first ? last - first + 1 : 0;
+
+    char headers[96];
+    snprintf(headers, sizeof(headers),
+             "X-History-First: %lu\r\nX-History-Now: %lu\r\nCache-Control: no-store\r\n",
+             (unsigned long)first, (unsigned long)to_ms_since_boot(get_absolute_time()));
+    return http_send_generated(tpcb, hs, 200, "application/octet-stream", headers,
+                               count * sizeof(struct history_sample), history_fill, first);
+}
+
+// Corpo do /log: páginas de TSLOG_PAGE_SIZE bytes dos blocos first, first + 1...
+static u16_t log_fill(u32_t first, u32_t offset, u8_t *buf, u16_t max)
+{
+    u16_t written = 0;
+    while (written < max) {
+        u32_t seq = first + offset / TSLOG_PAGE_SIZE;
+        if (seq < tslog_oldest_seq(&station_log)) {
+            break; // Setor apagado durante o envio (cliente lento demais)
+        }
+        u32_t skip = offset % TSLOG_PAGE_SIZE;
+        u16_t n = (u16_t)LWIP_MIN(TSLOG_PAGE_SIZE - skip, (u32_t)(max - written));
+        const uint8_t *page = tslog_block(&station_log, seq);
+        if (page) {
+            memcpy(buf + written, page + skip, n);
         } else {
-            const char *error_msg = "Corpo da requisicao vazio para set_offsets.";
-            hs->len = snprintf(hs->response, sizeof(hs->response),
-                                "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-                                (int)strlen(error_msg), error_msg);
+            memset(buf + written, 0xFF, n); // Bloco corrompido: vai como página apagada
         }
+        written += n;
+        offset += n;
+    }
+    return written;
+}
+
+// GET /log?from=<t>&to=<t>: blocos comprimidos da flash que cobrem o intervalo
+// (horários do wall_clock, Unix time depois do SNTP), copiados como estão.
+// O cliente descomprime e filtra (tools/tslog_dump.py). Amostras ainda no
+// bloco em RAM ficam de fora; as mais recentes estão em /history.
+static err_t handle_log(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    u32_t from = 0;
+    u32_t to = UINT32_MAX;
+    http_query_u32(req->query, "from", &from);
+    http_query_u32(req->query, "to", &to);
+
+    u32_t count = 0;
+    u32_t first = 0;
+    if (g_log_ready && tslog_newest_seq(&station_log) && from <= to) {
+        first = tslog_seek(&station_log, from);
+        count = tslog_seek(&station_log, to) - first + 1;
+    }
+
+    char headers[80];
+    snprintf(headers, sizeof(headers), "X-Log-Now: %lu\r\nCache-Control: no-store\r\n",
+             (unsigned long)wall_clock_now());
+    return http_send_generated(tpcb, hs, 200, "application/octet-stream", headers,
+                               count * TSLOG_PAGE_SIZE, log_fill, first);
+}
+
+// GET /server_stats[?reset=1]: pool de conexões do servidor HTTP, para o
+// benchmark de carga (tools/bench_http.c). Todo o estado do servidor vem de
+// pools estáticos, então high_water (estados ocupados ao mesmo tempo) é a
+// marca d'água da memória do caminho web; reset=1 a recomeça do valor atual.
+static err_t handle_server_stats(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    u32_t reset = 0;
+    http_query_u32(req->query, "reset", &reset);
+    if (reset) {
+        http_server_reset_high_water();
+    }
+    const struct http_server_stats *stats = http_server_get_stats();
+    char json[160];
+    int len = snprintf(json, sizeof(json),
+                       "{\"pool\":%u,\"active\":%u,\"high_water\":%u,\"accepted\":%lu,\"rejected\":%lu}",
+                       HTTP_MAX_CONNECTIONS, stats->active, stats->high_water,
+                       (unsigned long)stats->accepted, (unsigned long)stats->rejected);
+    return http_send_response(tpcb, hs, 200, "application/json", json, (u32_t)len, HTTP_BODY_COPY);
+}
+
+#ifdef ESTACAO_TRACE
+// GET /trace: congela o rastro (trace.h) e envia os registros em binário;
+// tools/trace_dump.py converte em JSON do Chrome trace. A gravação volta,
+// com os anéis vazios, quando o último byte sai.
+static err_t handle_trace(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    return http_send_generated(tpcb, hs, 200, "application/octet-stream", "Cache-Control: no-store\r\n",
+                               trace_freeze(), trace_fill, 0);
+}
+#endif
+
+// GET /metrics: contadores da estação no formato de texto do Prometheus. O
+// texto é montado de uma vez em metrics_text e sai aos poucos, como o
+// /history; uma coleta que comece antes de a anterior terminar de sair corta
+// a anterior (metrics_fill devolve 0 e a conexão fecha).
+#define METRICS_TEXT_MAX 16384
+static char metrics_text[METRICS_TEXT_MAX];
+static u32_t metrics_generation;
+
+static void format_metrics(struct metrics_writer *w); // Junto dos laços, no fim do arquivo
+
+static u16_t metrics_fill(u32_t generation, u32_t offset, u8_t *buf, u16_t max)
+{
+    if (generation != metrics_generation) {
+        return 0;
+    }
+    memcpy(buf, metrics_text + offset, max); // max nunca passa do fim do corpo
+    return max;
+}
+
+static err_t handle_metrics(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    struct metrics_writer w;
+    metrics_writer_init(&w, metrics_text, sizeof(metrics_text));
+    format_metrics(&w);
+    if (w.overflow) {
+        DLOG_WARN("Erro: /metrics cortado em %u bytes (METRICS_TEXT_MAX)\n", (unsigned)w.len);
+    }
+    metrics_generation++;
+    return http_send_generated(tpcb, hs, 200, "text/plain; version=0.0.4", "Cache-Control: no-store\r\n",
+                               (u32_t)w.len, metrics_fill, metrics_generation);
+}
+
+// Respostas de texto dos POSTs: mensagens constantes, enviadas direto da flash
+static err_t send_text(struct tcp_pcb *tpcb, struct http_state *hs, int status, const char *msg) {
+    return http_send_response(tpcb, hs, status, "text/plain", msg, strlen(msg), HTTP_BODY_STATIC);
+}
+
+// POST /set_limits (salva os limites e estado dos alertas)
+static err_t handle_set_limits(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    if (!req->body_len) {
+        return send_text(tpcb, hs, 400, "Corpo da requisicao vazio para set_limits.");
+    }
+    float t_min, t_max, h_min, h_max, p_min, p_max;
+    int alerts_on_int;
+    // Tenta ler todos os 7 valores do JSON
+    if (sscanf(req->body, "{\"temp_min\":%f,\"temp_max\":%f,\"humidity_min\":%f,\"humidity_max\":%f,\"pressure_min\":%f,\"pressure_max\":%f,\"alerts_enabled\":%d",
+               &t_min, &t_max, &h_min, &h_max, &p_min, &p_max, &alerts_on_int) != 7) {
+        return send_text(tpcb, hs, 400, "Formato de dados invalido para set_limits.");
+    }
+    if (!limits_valid(t_min, t_max, h_min, h_max, p_min, p_max)) {
+        return send_text(tpcb, hs, 400, "Valores de limite invalidos (fora da faixa ou min >= max).");
+    }
+    g_temp_min_limit = t_min;
+    g_temp_max_limit = t_max;
+    g_humidity_min_limit = h_min;
+    g_humidity_max_limit = h_max;
+    g_pressure_min_limit = p_min;
+    g_pressure_max_limit = p_max;
+    g_alerts_enabled = (bool)alerts_on_int; // Atualiza o estado dos alertas
+    mark_config_changed();
+
+    DLOG_DEBUG("DEBUG: Limites atualizados: Temp %.2f-%.2f, Hum %.2f-%.2f, Press %.2f-%.2f, Alertas: %d\n",
+           g_temp_min_limit, g_temp_max_limit, g_humidity_min_limit, g_humidity_max_limit,
+           g_pressure_min_limit, g_pressure_max_limit, g_alerts_enabled);
+    return send_text(tpcb, hs, 200, "Limites atualizados com sucesso.");
+}
+
+// POST /set_offsets
+static err_t handle_set_offsets(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    if (!req->body_len) {
+        return send_text(tpcb, hs, 400, "Corpo da requisicao vazio para set_offsets.");
+    }
+    float t_offset, h_offset, p_offset;
+    if (sscanf(req->body, "{\"temp_offset\":%f,\"humidity_offset\":%f,\"pressure_offset\":%f",
+               &t_offset, &h_offset, &p_offset) != 3) {
+        return send_text(tpcb, hs, 400, "Formato de dados invalido para set_offsets.");
+    }
+    if (!offsets_valid(t_offset, h_offset, p_offset)) {
+        return send_text(tpcb, hs, 400, "Valores de offset fora da faixa.");
+    }
+    g_temp_offset = t_offset;
+    g_humidity_offset = h_offset;
+    g_pressure_offset = p_offset;
+    mark_config_changed();
+    return send_text(tpcb, hs, 200, "Offsets atualizados com sucesso.");
+}
+
+// GET|POST /alert_rules: faixas dos canais e tabela de regras dos alertas
+// (alert_rules.h), em centésimos das unidades de /system_state. O corpo de
+// um POST cabe em HTTP_BODY_MAX, então cada POST altera um item:
+//   {"rule":1,"mask":3,"priority":70,"color":[0,0,125],"led":2,"beep_hz":1500,"beep_ms":80,"name":"x"}
+//     altera a regra 1 (só os campos presentes); "rule" igual ao número de
+//     regras acrescenta uma no fim
+//   {"rule":1,"delete":1}                          remove a regra 1
+//   {"channel":0,"hysteresis":30,"min_duration_ms":5000}  altera um canal
+// A resposta é a configuração inteira, como no GET. As regras ficam só na
+// RAM: um reset volta às regras padrão.
+// O JSON (até ~2,5 KB com 16 regras) sai aos poucos de alert_json, como o
+// /metrics: uma resposta nova antes de a anterior terminar de sair corta a
+// anterior (alert_json_fill devolve 0 e a conexão fecha).
+#define ALERT_JSON_MAX 3072
+static char alert_json[ALERT_JSON_MAX];
+static size_t alert_json_len;
+static u32_t alert_json_generation;
+
+static u16_t alert_json_fill(u32_t generation, u32_t offset, u8_t *buf, u16_t max)
+{
+    if (generation != alert_json_generation) {
+        return 0;
     }
-    // TRATAMENTO DA PÁGINA PRINCIPAL OU DE LIMITES (HTML)
-    // Se a requisição não corresponder a nenhum endpoint específico, serve a página HTML adequada
-    else {
-        // Verifica qual página deve ser servida com base na variável global
-        if (g_current_page == 0) { // Página de gráficos
-            printf("DEBUG: Servindo pagina de Graficos (g_current_page == 0).\n");
-            hs->len = snprintf(hs->response, sizeof(hs->response),
-                                "HTTP/1.1 200 OK\r\n"
-                                "Content-Type: text/html\r\n"
-                                "Content-Length: %d\r\n"
-                                "Connection: close\r\n"
-                                "\r\n"
-                                "%s",
-                                (int)strlen(index_html), index_html); 
-        } else { // Página de limites
-            printf("DEBUG: Servindo pagina de Limites (g_current_page == 1).\n");
-            hs->len = snprintf(hs->response, sizeof(hs->response),
-                                "HTTP/1.1 200 OK\r\n"
-                                "Content-Type: text/html\r\n"
-                                "Content-Length: %d\r\n"
-                                "Connection: close\r\n"
-                                "\r\n"
-                                "%s",
-                                (int)strlen(html_limits_config), html_limits_config); 
+    memcpy(buf, alert_json + offset, max); // max nunca passa do fim do corpo
+    return max;
+}
+
+static void alert_json_add(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    int w = vsnprintf(alert_json + alert_json_len, sizeof(alert_json) - alert_json_len, fmt, ap);
+    va_end(ap);
+    if (w > 0) {
+        alert_json_len += (size_t)w < sizeof(alert_json) - alert_json_len ? (size_t)w
+                                                                            : sizeof(alert_json) - alert_json_len - 1;
+    }
+}
+
+static err_t send_alert_rules(struct tcp_pcb *tpcb, struct http_state *hs)
+{
+    struct alert_status status;
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&alert_status_lock);
+        status = alert_status;
+    } while (seqlock_read_retry(&alert_status_lock, seq));
+
+    const struct alert_config *c = &alert_shared; // Só o núcleo 0 escreve: lê sem trava
+    alert_json_len = 0;
+    alert_json_add("{\"enabled\":%d,\"out\":%llu,\"active\":%d,\"channels\":[", (int)g_alerts_enabled,
+                   (unsigned long long)status.out, status.active);
+    for (int i = 0; i < c->channels; i++) {
+        const struct alert_band *band = &c->band[i];
+        alert_json_add("%s{\"name\":\"%s\",\"min\":%ld,\"max\":%ld,\"hysteresis\":%ld,\"min_duration_ms\":%lu}",
+                       i ? "," : "", alert_channel_names[i], (long)band->min, (long)band->max,
+                       (long)band->hysteresis, (unsigned long)band->min_duration_ms);
+    }
+    alert_json_add("],\"rules\":[");
+    for (int r = 0; r < c->rules; r++) {
+        const struct alert_rule *rule = &c->rule[r];
+        alert_json_add("%s{\"mask\":%llu,\"priority\":%u,\"color\":[%u,%u,%u],\"led\":%u,"
+                       "\"beep_hz\":%u,\"beep_ms\":%u,\"name\":\"%s\"}",
+                       r ? "," : "", (unsigned long long)rule->mask, rule->priority, rule->r, rule->g, rule->b,
+                       rule->led, rule->beep_hz, rule->beep_ms, rule->name);
+    }
+    alert_json_add("]}");
+    alert_json_generation++;
+    return http_send_generated(tpcb, hs, 200, "application/json", "Cache-Control: no-store\r\n",
+                               (u32_t)alert_json_len, alert_json_fill, alert_json_generation);
+}
+
+// Valor de "chave": no JSON plano dos POSTs, ou NULL se a chave não veio
+static const char *json_value(const char *json, const char *key)
+{
+    char pattern[24];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *p = strstr(json, pattern);
+    return p ? p + strlen(pattern) : NULL;
+}
+
+// Fim de um número no JSON plano: espaços e então ',', '}' ou o fim do corpo
+static bool json_number_end(const char *end)
+{
+    while (*end == ' ') {
+        end++;
+    }
+    return *end == ',' || *end == '}' || *end == '\0';
+}
+
+// Número inteiro em [min, max]; sem a chave, *out fica como estava.
+// Retorna false só se a chave veio com um valor inválido.
+static bool json_long(const char *json, const char *key, long min, long max, long *out)
+{
+    const char *v = json_value(json, key);
+    if (!v) {
+        return true;
+    }
+    char *end;
+    errno = 0;
+    long n = strtol(v, &end, 10);
+    if (end == v || errno == ERANGE || !json_number_end(end) || n < min || n > max) {
+        return false;
+    }
+    *out = n;
+    return true;
+}
+
+// Máscara de canais em decimal; só bits dos channels canais configurados.
+// Valores fora de 64 bits ou seguidos de lixo são recusados, não truncados.
+static bool json_mask(const char *json, uint8_t channels, uint64_t *out)
+{
+    const char *v = json_value(json, "mask");
+    if (!v) {
+        return true;
+    }
+    while (*v == ' ') {
+        v++;
+    }
+    if (*v < '0' || *v > '9') {
+        return false; // strtoull aceitaria sinal e negaria o valor
+    }
+    char *end;
+    errno = 0;
+    unsigned long long n = strtoull(v, &end, 10);
+    if (errno == ERANGE || !json_number_end(end)) {
+        return false;
+    }
+    if (channels < ALERT_MAX_CHANNELS && (n >> channels) != 0) {
+        return false;
+    }
+    *out = n;
+    return true;
+}
+
+// "color":[r,g,b], cada um de 0 a 255
+static bool json_color(const char *json, struct alert_rule *rule)
+{
+    const char *v = json_value(json, "color");
+    if (!v) {
+        return true;
+    }
+    uint8_t *rgb[3] = {&rule->r, &rule->g, &rule->b};
+    if (*v++ != '[') {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        char *end;
+        long n = strtol(v, &end, 10);
+        if (end == v || n < 0 || n > 255 || *end != (i < 2 ? ',' : ']')) {
+            return false;
         }
+        *rgb[i] = (uint8_t)n;
+        v = end + 1;
     }
+    return true;
+}
 
-    tcp_arg(tpcb, hs);
-    tcp_sent(tpcb, http_sent);
-    tcp_write(tpcb, hs->response, hs->len, TCP_WRITE_FLAG_COPY);
-    tcp_output(tpcb);
+// Nome da regra: só ASCII imprimível sem aspas nem barra invertida, que
+// volta como está no JSON do GET e no log
+static bool json_name(const char *json, char *out)
+{
+    const char *v = json_value(json, "name");
+    if (!v) {
+        return true;
+    }
+    if (*v++ != '"') {
+        return false;
+    }
+    size_t n = 0;
+    for (; *v != '"'; v++) {
+        if (!*v || *v < ' ' || *v > '~' || *v == '\\' || n + 1 >= ALERT_NAME_MAX) {
+            return false;
+        }
+        out[n++] = *v;
+    }
+    out[n] = '\0';
+    return true;
+}
+
+static err_t edit_alert_channel(struct tcp_pcb *tpcb, struct http_state *hs, const char *body)
+{
+    long channel = -1;
+    if (!json_long(body, "channel", 0, ALERT_CHANNELS - 1, &channel) || channel < 0) {
+        return send_text(tpcb, hs, 400, "Canal de alerta invalido.");
+    }
+    long hysteresis = alert_hysteresis[channel];
+    long duration = alert_shared.band[channel].min_duration_ms;
+    if (!json_long(body, "hysteresis", 0, INT32_MAX, &hysteresis) ||
+        !json_long(body, "min_duration_ms", 0, ALERT_MAX_DURATION_MS, &duration)) {
+        return send_text(tpcb, hs, 400, "Histerese ou duracao minima invalida.");
+    }
+    int32_t old_hysteresis = alert_hysteresis[channel];
+    uint32_t old_duration = alert_shared.band[channel].min_duration_ms;
+    alert_hysteresis[channel] = (int32_t)hysteresis;
+    seqlock_write_begin(&alert_lock);
+    alert_shared.band[channel].min_duration_ms = (uint32_t)duration;
+    seqlock_write_end(&alert_lock);
+    if (!update_alert_bands()) { // Aplica a histerese, limitada a meia faixa
+        // Faixas antigas mantidas: desfaz a edição para não ficar pela metade
+        alert_hysteresis[channel] = old_hysteresis;
+        seqlock_write_begin(&alert_lock);
+        alert_shared.band[channel].min_duration_ms = old_duration;
+        seqlock_write_end(&alert_lock);
+        return send_text(tpcb, hs, 400, "Limites sem faixa valida; canal de alerta nao alterado.");
+    }
+    request_alert_evaluation(); // Reavalia já, sem esperar a próxima leitura
+    return send_alert_rules(tpcb, hs);
+}
+
+static err_t edit_alert_rule(struct tcp_pcb *tpcb, struct http_state *hs, const char *body)
+{
+    static struct alert_config edit; // Grande demais para a pilha do lwIP
+    edit = alert_shared;
+    long index = -1;
+    if (!json_long(body, "rule", 0, edit.rules, &index) || index < 0) {
+        return send_text(tpcb, hs, 400, "Indice de regra invalido.");
+    }
+    long remove = 0;
+    if (!json_long(body, "delete", 0, 1, &remove)) {
+        return send_text(tpcb, hs, 400, "Valor de delete invalido (0 ou 1).");
+    }
+    if (remove) {
+        if (index == edit.rules) {
+            return send_text(tpcb, hs, 400, "Indice de regra invalido.");
+        }
+        memmove(&edit.rule[index], &edit.rule[index + 1], (edit.rules - index - 1) * sizeof(edit.rule[0]));
+        edit.rules--;
+    } else {
+        if (index == edit.rules && edit.rules == ALERT_MAX_RULES) {
+            return send_text(tpcb, hs, 400, "Tabela de regras cheia.");
+        }
+        struct alert_rule rule = index < edit.rules ? edit.rule[index]
+                                                     : (struct alert_rule){.led = ALERT_LED_RED};
+        long priority = rule.priority, led = rule.led, beep_hz = rule.beep_hz, beep_ms = rule.beep_ms;
+        if (!json_mask(body, edit.channels, &rule.mask) || !json_color(body, &rule) || !json_name(body, rule.name) ||
+            !json_long(body, "priority", 0, UINT8_MAX, &priority) ||
+            !json_long(body, "led", 0, ALERT_LED_OFF, &led) ||
+            !json_long(body, "beep_hz", 0, UINT16_MAX, &beep_hz) ||
+            !json_long(body, "beep_ms", 0, 1000, &beep_ms)) {
+            return send_text(tpcb, hs, 400, "Formato de dados invalido para alert_rules.");
+        }
+        rule.priority = (uint8_t)priority;
+        rule.led = (uint8_t)led;
+        rule.beep_hz = (uint16_t)beep_hz;
+        rule.beep_ms = (uint16_t)beep_ms;
+        edit.rule[index] = rule;
+        if (index == edit.rules) {
+            edit.rules++;
+        }
+    }
+    if (!alert_config_valid(&edit)) {
+        return send_text(tpcb, hs, 400, "Regra invalida (mascara vazia ou com canal inexistente).");
+    }
+    seqlock_write_begin(&alert_lock);
+    alert_shared.rules = edit.rules;
+    memcpy(alert_shared.rule, edit.rule, sizeof(edit.rule));
+    seqlock_write_end(&alert_lock);
+    DLOG_DEBUG("DEBUG: Regras de alerta atualizadas (%u regras).\n", edit.rules);
+    request_alert_evaluation();
+    return send_alert_rules(tpcb, hs);
+}
+
+static err_t handle_alert_rules(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    if (req->method == HTTP_METHOD_GET) {
+        return send_alert_rules(tpcb, hs);
+    }
+    if (json_value(req->body, "channel")) {
+        return edit_alert_channel(tpcb, hs, req->body);
+    }
+    if (json_value(req->body, "rule")) {
+        return edit_alert_rule(tpcb, hs, req->body);
+    }
+    return send_text(tpcb, hs, 400, "Corpo invalido para alert_rules (rule ou channel).");
+}
+
+// GET / (página escolhida pelo botão A)
+static err_t handle_root(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    const char *page = (g_current_page == 0) ? "/index.html" : "/limites.html";
+    DLOG_DEBUG("DEBUG: Servindo pagina %s (g_current_page == %d).\n", page, g_current_page);
+    const char *response;
+    u32_t response_len;
+    web_asset_lookup(page, req->accepts_gzip, req->if_none_match, strlen(req->if_none_match), &response, &response_len);
+    // Resposta completa (cabeçalho + gzip, ou 304) já está pronta na flash
+    return http_send_static(tpcb, hs, response, response_len);
+}
+
+// Caminhos fora da tabela: arquivos gerados de web/, ou 404 (favicon, sondagens...)
+static err_t handle_static_file(struct tcp_pcb *tpcb, struct http_state *hs, const struct http_request *req) {
+    const char *response;
+    u32_t response_len;
+    if (!web_asset_lookup(req->path, req->accepts_gzip, req->if_none_match, strlen(req->if_none_match), &response, &response_len)) {
+        return http_send_error(tpcb, hs, 404, NULL);
+    }
+    if (req->method != HTTP_METHOD_GET) {
+        return http_send_error(tpcb, hs, 405, "Allow: GET\r\n");
+    }
+    return http_send_static(tpcb, hs, response, response_len);
+}
+
+// Tabela de rotas: manter em ordem alfabética de caminho (busca binária)
+static const struct http_route app_routes[] = {
+    {"/",             HTTP_ALLOW_GET,  handle_root},
+    {"/alert_rules",  HTTP_ALLOW_GET | HTTP_ALLOW_POST, handle_alert_rules},
+    {"/events",       HTTP_ALLOW_GET,  handle_events},
+    {"/history",      HTTP_ALLOW_GET,  handle_history},
+    {"/log",          HTTP_ALLOW_GET,  handle_log},
+    {"/metrics",      HTTP_ALLOW_GET,  handle_metrics},
+    {"/server_stats", HTTP_ALLOW_GET,  handle_server_stats},
+    {"/set_limits",   HTTP_ALLOW_POST, handle_set_limits},
+    {"/set_offsets",  HTTP_ALLOW_POST, handle_set_offsets},
+    {"/system_state", HTTP_ALLOW_GET,  handle_system_state},
+#ifdef ESTACAO_TRACE
+    {"/trace",        HTTP_ALLOW_GET,  handle_trace},
+#endif
+    {"/ws",           HTTP_ALLOW_GET,  handle_ws},
+};
+
+// Contadores de cada rota e, no fim, dos arquivos estáticos (fallback)
+static struct http_route_stats app_route_stats[count_of(app_routes) + 1];
+
+static const struct http_router app_router = {
+    .routes = app_routes,
+    .count = sizeof(app_routes) / sizeof(app_routes[0]),
+    .fallback = handle_static_file,
+    .stats = app_route_stats,
+};
+
+// Aquisição: a cada SENSOR_TICK_MS uma rodada do escalonador de sensores
+// (sensor_bus.h) lê os BMP280 e, a cada AHT_DECIMATION rodadas, os AHT20
+// (medir mais que ~1 vez por segundo aquece o AHT20); as leituras passam
+// pelos filtros e a saída é publicada a cada PUBLISH_DECIMATION rodadas, sem
+// aumentar o tráfego de rede
+#define SENSOR_TICK_MS         200
+#define AHT_DECIMATION         5
+#define PUBLISH_DECIMATION     5   // 1 amostra publicada por segundo
+#define HOUSEKEEPING_PERIOD_MS 1000 // Gravação da configuração na flash
+// Perfil do BMP280 (bmp280.h). Forçado: cada rodada dispara uma conversão e
+// a lê quando fica pronta, então toda leitura é nova e a filtragem fica com
+// a cadeia abaixo (no lugar do IIR do sensor)
+#define BMP_PROFILE            BMP280_PROFILE_ULTRA_LOW_POWER
+
+// Trabalho periódico: o próximo prazo conta a partir do anterior, então o
+// tempo gasto no próprio trabalho não acumula atraso
+struct periodic_work {
+    async_at_time_worker_t worker;
+    uint32_t period_ms;
+    absolute_time_t next;
+};
+
+static void schedule_periodic(async_context_t *ctx, struct periodic_work *work)
+{
+    absolute_time_t now = get_absolute_time();
+    work->next = is_nil_time(work->next) ? now : delayed_by_ms(work->next, work->period_ms);
+    if (absolute_time_diff_us(now, work->next) < 0) {
+        work->next = now; // Atrasou mais de um período: segue daqui, sem rajada
+    }
+    async_context_add_at_time_worker_at(ctx, &work->worker, work->next);
+}
+
+// Sons do buzzer (sequenciador em buzzer.h, no pool de alarmes do núcleo 1).
+// Sensor sem resposta: três bipes agudos a cada ~2 s enquanto a falha durar,
+// acima de qualquer regra de alerta
+static const struct buzzer_step sensor_error_steps[] = {
+    {3000, 150, 150}, {3000, 150, 150}, {3000, 150, 1250},
+};
+static const struct buzzer_pattern sensor_error_sound = {
+    .steps = sensor_error_steps, .count = count_of(sensor_error_steps), .repeat = 1, .priority = UINT8_MAX,
+};
+
+// Bipe da regra de alerta ativa, montado quando a regra muda
+static struct buzzer_step alert_step;
+static struct buzzer_pattern alert_sound = {.steps = &alert_step, .count = 1};
+
+// Sensores da estação, lidos pelo escalonador (lib/sensores/sensor_bus.h).
+// Estações maiores acrescentam sondas aqui: um segundo BMP280 no mesmo
+// barramento (endereço 0x77) ou AHT20s (endereço fixo) atrás de um
+// TCA9548A, por exemplo:
+//   {.driver = &bmp280_sensor_driver, .label = "bmp280-b", .bus = 0,
+//    .addr = BMP280_ADDR_SECONDARY, .bmp280 = {.profile = BMP_PROFILE}},
+//   {.driver = &aht20_sensor_driver, .label = "aht20-ext", .bus = 1, .addr = AHT20_I2C_ADDR,
+//    .mux_addr = TCA9548A_ADDR, .mux_channel = 2, .decimation = AHT_DECIMATION},
+// Os canais publicados vêm de channel_source; as demais sondas aparecem no
+// terminal a cada publicação.
+enum { SENSOR_BMP, SENSOR_AHT };
+
+static struct sensor sensors[] = {
+    [SENSOR_BMP] = {.driver = &bmp280_sensor_driver, .label = "bmp280", .bus = 0,
+                    .addr = 0, // Procura em 0x76 e 0x77
+                    .bmp280 = {.profile = BMP_PROFILE}},
+    [SENSOR_AHT] = {.driver = &aht20_sensor_driver, .label = "aht20", .bus = 1, .addr = AHT20_I2C_ADDR,
+                    .decimation = AHT_DECIMATION},
+};
+
+#define SENSOR_COUNT (sizeof(sensors) / sizeof(sensors[0]))
+
+static struct sensor_bus sensor_bus;
+
+// Canais filtrados, em centésimos e sem offsets (aplicados na publicação)
+enum sensor_channel {
+    CH_TEMP_AHT,
+    CH_HUMIDITY_AHT,
+    CH_TEMP_BMP,
+    CH_PRESSURE,  // 0,01 Pa
+    CH_COUNT,
+};
+
+// Cadeia de filtros de cada canal (lib/filter/filter.h). A mediana derruba
+// leituras isoladas que disparariam alertas; EMA e Kalman tiram o ruído.
+// Kalman: q e r em unidades² do canal (r ~ variância do ruído do sensor).
+static const struct filter_stage_config filter_config[CH_COUNT][FILTER_MAX_STAGES] = {
+    [CH_TEMP_AHT]     = {{FILTER_MEDIAN, 3}, {FILTER_EMA, 1}},
+    [CH_HUMIDITY_AHT] = {{FILTER_MEDIAN, 3}, {FILTER_EMA, 1}},
+    [CH_TEMP_BMP]     = {{FILTER_MEDIAN, 5}, {FILTER_EMA, 2}},
+    [CH_PRESSURE]     = {{FILTER_MEDIAN, 5}, {FILTER_KALMAN, 0, 400, 40000}}, // Ruído ~2 Pa com x1
+};
+
+// Sensor e canal do driver que alimentam cada canal publicado
+static const struct { uint8_t sensor, channel; } channel_source[CH_COUNT] = {
+    [CH_TEMP_AHT]     = {SENSOR_AHT, 0},
+    [CH_HUMIDITY_AHT] = {SENSOR_AHT, 1},
+    [CH_TEMP_BMP]     = {SENSOR_BMP, 0},
+    [CH_PRESSURE]     = {SENSOR_BMP, 1},
+};
+
+static struct filter_chain filters[CH_COUNT];
+static int32_t filtered[CH_COUNT];
+
+// Centésimos como três argumentos do log, para "%s%d.%02d" (sinal, parte
+// inteira e fração): o log guarda números, nunca texto da pilha
+#define CENTI_ARGS(v) ((v) < 0 ? "-" : ""), abs((int)(v)) / 100, abs((int)(v)) % 100
+
+// Saída dos filtros + offsets, em centésimos
+static void compose_sample(struct station_sample *out)
+{
+    out->time_ms = to_ms_since_boot(get_absolute_time());
+    out->temp_aht = filtered[CH_TEMP_AHT] + g_temp_offset_centi;
+    // Umidade relativa corrigida satura em 0..100 %: com offsets de até ±100 %
+    // ela sairia negativa e daria a volta no uint16 do /history, /ws e log
+    int32_t humidity = filtered[CH_HUMIDITY_AHT] + g_humidity_offset_centi;
+    out->humidity_aht = humidity < 0 ? 0 : humidity > 10000 ? 10000 : humidity;
+    out->temp_bmp = filtered[CH_TEMP_BMP] + g_temp_offset_centi;
+    out->pressure = filtered[CH_PRESSURE] + g_pressure_offset_centi;
+
+    // PRINTS PARA DEPURAÇÃO NO TERMINAL//////////////////////////
+    DLOG_DEBUG("-----------BMP280 LEITURAS-----------------\n");
+    DLOG_DEBUG("Pressao = %s%d.%02d Pa\n", CENTI_ARGS(filtered[CH_PRESSURE]));
+    DLOG_DEBUG("Temperatura BMP: = %s%d.%02d C\n", CENTI_ARGS(filtered[CH_TEMP_BMP]));
+    DLOG_DEBUG("----------AHT LEITURAS------------------\n");
+    DLOG_DEBUG("Temperatura : %s%d.%02d C\n", CENTI_ARGS(filtered[CH_TEMP_AHT]));
+    DLOG_DEBUG("Umidade: %s%d.%02d %%\n", CENTI_ARGS(filtered[CH_HUMIDITY_AHT]));
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        const struct sensor *s = &sensors[i];
+        if (i > SENSOR_AHT && s->online) { // Sondas extras: leitura sem filtro
+            DLOG_DEBUG("%s: %s%d.%02d / %s%d.%02d\n", s->label, CENTI_ARGS(s->value[0]), CENTI_ARGS(s->value[1]));
+        }
+    }
+    DLOG_DEBUG("Sensores: rodada de %lu us (max. %lu), %lu rodadas atrasadas\n\n\n",
+           (unsigned long)sensor_bus.stats.last_round_us, (unsigned long)sensor_bus.stats.max_round_us,
+           (unsigned long)sensor_bus.stats.overruns);
+}
+
+static void publish_work(async_context_t *ctx, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t publish_worker = {.do_work = publish_work};
 
-    pbuf_free(p);
-    return ERR_OK;
+static struct station_sample core1_sample; // Última amostra publicada, usada pelos alertas
+static bool core1_has_sample;
+
+// Núcleo 1: publica a amostra inteira no seqlock e avisa o núcleo 0
+static void publish_sample(async_context_t *ctx)
+{
+    compose_sample(&core1_sample);
+    core1_has_sample = true;
+
+    seqlock_write_begin(&sample_lock);
+    shared_sample = core1_sample;
+    seqlock_write_end(&sample_lock);
+
+    async_context_set_work_pending(&app_context.core, &publish_worker);
+    async_context_set_work_pending(ctx, &alert_worker);
 }
 
-// Função de callback para aceitar conexões TCP
-static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err)
+// ---- Escalonador dos sensores no núcleo 1 ----
+
+static void sensor_bus_work(async_context_t *ctx, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t sensor_bus_worker = {.do_work = sensor_bus_work};
+static void sensor_deadline_work(async_context_t *ctx, async_at_time_worker_t *worker);
+static async_at_time_worker_t sensor_deadline_worker = {.do_work = sensor_deadline_work};
+
+static i2c_inst_t *sensor_i2c(uint8_t bus)
 {
-    tcp_recv(newpcb, http_recv);
-    return ERR_OK;
+    return bus ? I2C_PORT_1 : I2C_PORT_0;
 }
 
-// Função para iniciar o servidor HTTP
-static void start_http_server(void)
+static bool sensor_submit(void *ctx, uint8_t bus, uint8_t addr, const uint8_t *tx, uint8_t tx_len,
+                          uint8_t *rx, uint8_t rx_len)
 {
-    struct tcp_pcb *pcb = tcp_new();
-    if (!pcb)
-    {
-        printf("Erro ao criar PCB TCP\n");
+    return i2c_async_transfer(sensor_i2c(bus), addr, tx, tx_len, rx, rx_len);
+}
+
+static bool sensor_write_blocking(void *ctx, uint8_t bus, uint8_t addr, const uint8_t *data, uint8_t len)
+{
+    return i2c_write_blocking(sensor_i2c(bus), addr, data, len, false) == len;
+}
+
+// Interrupção (núcleo 1): fim de uma transação; o resto fica para o laço
+static void sensor_xfer_done(uint bus, bool ok, void *ctx)
+{
+    sensor_bus_xfer_done(&sensor_bus, (uint8_t)bus, ok);
+    async_context_set_work_pending(&sensor_context.core, &sensor_bus_worker);
+}
+
+// Rodada concluída: leituras novas entram nos filtros; a cada
+// PUBLISH_DECIMATION rodadas (as que incluem o AHT20) a amostra é publicada
+static void sensor_round_done(struct sensor_bus *b, void *ctx)
+{
+    for (int c = 0; c < CH_COUNT; c++) {
+        const struct sensor *s = &sensors[channel_source[c].sensor];
+        if (s->fresh) {
+            filtered[c] = filter_chain_apply(&filters[c], s->value[channel_source[c].channel]);
+        }
+    }
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        if (sensor_failed(&sensors[i])) { // Mantém a saída anterior do canal
+            buzzer_play(&sensor_error_sound); // Já tocando: segue sem recomeçar
+            DLOG_ERROR("Erro na leitura do %s!\n\n\n", sensors[i].label);
+        }
+    }
+    if (b->round % PUBLISH_DECIMATION == 0) {
+        publish_sample(&sensor_context.core);
+    }
+}
+
+static const struct sensor_bus_ops sensor_bus_ops = {
+    .submit = sensor_submit,
+    .write_blocking = sensor_write_blocking,
+    .round_done = sensor_round_done,
+};
+
+// Avança o escalonador e agenda o próximo prazo (fim de uma conversão)
+static void run_sensor_bus(async_context_t *ctx)
+{
+    uint64_t deadline = sensor_bus_poll(&sensor_bus, time_us_64());
+    async_context_remove_at_time_worker(ctx, &sensor_deadline_worker);
+    if (deadline != SENSOR_NO_DEADLINE) {
+        async_context_add_at_time_worker_at(ctx, &sensor_deadline_worker, from_us_since_boot(deadline));
+    }
+}
+
+static void sensor_bus_work(async_context_t *ctx, async_when_pending_worker_t *worker)
+{
+    run_sensor_bus(ctx);
+}
+
+static void sensor_deadline_work(async_context_t *ctx, async_at_time_worker_t *worker)
+{
+    run_sensor_bus(ctx);
+}
+
+// Núcleo 1, a cada SENSOR_TICK_MS: começa uma rodada. Se a anterior ainda
+// não terminou (sensor lento ou barramento com erro), este tick é pulado.
+static void sample_work_fn(async_context_t *ctx, async_at_time_worker_t *worker)
+{
+    if (sensor_bus_start_round(&sensor_bus, time_us_64())) {
+        run_sensor_bus(ctx);
+    }
+    schedule_periodic(ctx, worker->user_data);
+}
+
+static struct periodic_work sample_work = {
+    .worker = {.do_work = sample_work_fn, .user_data = &sample_work},
+    .period_ms = SENSOR_TICK_MS,
+};
+
+// Núcleo 0: copia a amostra mais recente e a empurra para /events e /ws.
+// Se o núcleo 1 publicar de novo no meio da cópia, a leitura é refeita.
+static void publish_work(async_context_t *ctx, async_when_pending_worker_t *worker)
+{
+    struct station_sample sample;
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&sample_lock);
+        sample = shared_sample;
+    } while (seqlock_read_retry(&sample_lock, seq));
+    publish_system_state(&sample);
+}
+
+static void housekeeping_work_fn(async_context_t *ctx, async_at_time_worker_t *worker)
+{
+    save_config_if_due(); // Depois de uma sequência de edições, grava uma vez
+    flush_log_if_old();
+    schedule_periodic(ctx, worker->user_data);
+}
+
+static struct periodic_work housekeeping_work = {
+    .worker = {.do_work = housekeeping_work_fn, .user_data = &housekeeping_work},
+    .period_ms = HOUSEKEEPING_PERIOD_MS,
+};
+
+// Núcleo 1: avaliação dos alertas, após cada leitura e a cada alteração de
+// limites ou regras. A configuração é escrita pelo núcleo 0 (seqlock); uma
+// avaliação que cruzar com a alteração é refeita logo em seguida
+// (request_alert_evaluation).
+static struct alert_config alert_local; // Cópia do núcleo 1
+static uint32_t alert_local_seq = UINT32_MAX;
+static struct alert_state alert_eval = {.active = ALERT_NONE};
+static int alert_shown = ALERT_NONE - 1; // Regra na matriz/LED (inicial: nenhuma indicação)
+
+static void refresh_alert_config(void)
+{
+    if (alert_lock.seq == alert_local_seq) {
         return;
     }
-    if (tcp_bind(pcb, IP_ADDR_ANY, 80) != ERR_OK)
-    {
-        printf("Erro ao ligar o servidor na porta 80\n");
+    uint32_t seq;
+    do {
+        seq = seqlock_read_begin(&alert_lock);
+        alert_local = alert_shared;
+    } while (seqlock_read_retry(&alert_lock, seq));
+    alert_local_seq = seq;
+    alert_state_rules_changed(&alert_eval); // Índices e máscaras podem ter mudado
+    alert_shown = ALERT_NONE - 1;           // Cor/LED da mesma posição podem ser outros
+}
+
+static void set_alert_led(uint8_t led)
+{
+    switch (led) {
+    case ALERT_LED_GREEN: set_led_green(); break;
+    case ALERT_LED_RED: set_led_red(); break;
+    case ALERT_LED_BLUE: set_led_blue(); break;
+    case ALERT_LED_YELLOW: set_led_yellow(); break;
+    default: turn_off_leds(); break;
+    }
+}
+
+static void alert_work(async_context_t *ctx, async_when_pending_worker_t *worker)
+{
+    buzzer_mute(!g_alerts_enabled); // Botão B: esvazia a fila do buzzer já nesta passada
+    if (!core1_has_sample) {
         return;
     }
-    pcb = tcp_listen(pcb);
-    tcp_accept(pcb, connection_callback);
-    printf("Servidor HTTP rodando na porta 80...\n");
+    TRACE_BEGIN(ALERT_EVAL, g_alerts_enabled);
+    refresh_alert_config();
+    const int32_t values[ALERT_CHANNELS] = {
+        [ALERT_CH_TEMP] = core1_sample.temp_aht,
+        [ALERT_CH_HUMIDITY] = core1_sample.humidity_aht,
+        [ALERT_CH_PRESSURE] = core1_sample.pressure,
+    };
+    // Os canais seguem sendo avaliados com os alertas desligados, para a
+    // histerese e a duração continuarem valendo quando forem religados
+    int active = alert_evaluate(&alert_local, &alert_eval, values, to_ms_since_boot(get_absolute_time()));
+    if (!g_alerts_enabled) {
+        active = ALERT_NONE;
+    }
+
+    seqlock_write_begin(&alert_status_lock);
+    alert_status.out = alert_eval.out;
+    alert_status.active = (int8_t)active;
+    seqlock_write_end(&alert_status_lock);
+
+    if (active != alert_shown) { // Matriz, LED e bipe só mudam na troca de regra
+        buzzer_stop(&alert_sound);
+        if (active == ALERT_NONE) {
+            if (alert_shown >= 0) {
+                DLOG_INFO("Alertas: todos os canais dentro da faixa\n");
+            }
+            set_led_green();
+            set_one_led(0, 0, 0, matriz_preenchida);
+        } else {
+            const struct alert_rule *rule = &alert_local.rule[active];
+            // Sem o nome: o dlog guarda só o ponteiro do "%s", e alert_local
+            // pode ser reescrito por /alert_rules antes do drain
+            DLOG_WARN("ALERTA: regra %d (prioridade %u), canais fora da faixa 0x%x\n",
+                      active, (unsigned)rule->priority, (unsigned)alert_eval.out);
+            set_alert_led(rule->led);
+            set_one_led(rule->r, rule->g, rule->b, matriz_preenchida);
+            if (rule->beep_ms) {
+                alert_step = (struct buzzer_step){rule->beep_hz, rule->beep_ms, ALERT_BEEP_PERIOD_MS - rule->beep_ms};
+                alert_sound.priority = rule->priority;
+                buzzer_play(&alert_sound); // Repete até a regra sair
+            }
+        }
+        alert_shown = active;
+    }
+    TRACE_END(ALERT_EVAL, g_alerts_enabled);
+}
+
+#ifdef ESTACAO_BENCHMARKS
+// Ciclos por amostra da compensação: caminho anterior (t_fine duas vezes,
+// float no BMP280 e double no AHT20) x compensação inteira numa passada.
+// Teste de valores de referência no PC: tools/bench_compensation.c
+static void bench_compensation(void)
+{
+    enum { RUNS = 100 };
+    static struct bmp280_calib_param calib = { // Exemplo do datasheet
+        27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+    };
+    static const uint8_t aht_frame[6] = {0x18, 0x80, 0x00, 0x06, 0x00, 0x00};
+    volatile float sink_f;
+    volatile int32_t sink_i;
+    uint32_t old_cycles = 0, new_cycles = 0;
+
+    bench_cycles_init();
+    for (int i = 0; i < RUNS; i++) {
+        int32_t raw_t = 519888 + i, raw_p = 415148 + i;
+        uint32_t t0 = bench_cycles_now();
+        float temp = bmp280_convert_temp(raw_t, &calib) / 100.0f;
+        float pressure = bmp280_convert_pressure(raw_p, raw_t, &calib);
+        uint32_t raw_h = ((uint32_t)aht_frame[1] << 12) | ((uint32_t)aht_frame[2] << 4) | (aht_frame[3] >> 4);
+        uint32_t raw_ta = ((uint32_t)(aht_frame[3] & 0x0F) << 16) | ((uint32_t)aht_frame[4] << 8) | aht_frame[5];
+        float humidity = (float)raw_h * 100.0 / 1048576.0;
+        float temp_aht = ((float)raw_ta * 200.0 / 1048576.0) - 50.0;
+        sink_f = temp + pressure + humidity + temp_aht;
+        old_cycles += bench_cycles_since(t0);
+
+        t0 = bench_cycles_now();
+        int32_t temp_centi, temp_aht_centi, humidity_centi;
+        uint32_t pressure_pa;
+        bmp280_compensate(raw_t, raw_p, &calib, &temp_centi, &pressure_pa);
+        aht20_compensate(aht_frame, &temp_aht_centi, &humidity_centi);
+        sink_i = temp_centi + (int32_t)pressure_pa + temp_aht_centi + humidity_centi;
+        new_cycles += bench_cycles_since(t0);
+    }
+    (void)sink_f;
+    (void)sink_i;
+    printf("BENCH compensacao: float/double %lu ciclos, inteiros numa passada %lu ciclos\n",
+           (unsigned long)(old_cycles / RUNS), (unsigned long)(new_cycles / RUNS));
+}
+
+// Ciclos por amostra de cada estágio de filtro, com a entrada variando.
+// Qualidade (ruído, alarmes falsos, atraso) no PC: tools/bench_filter.c
+static void bench_filters(void)
+{
+    enum { RUNS = 100 };
+    static const struct filter_stage_config stages[] = {
+        {FILTER_MEDIAN, 3}, {FILTER_MEDIAN, 5}, {FILTER_MEDIAN, 9}, {FILTER_EMA, 2}, {FILTER_KALMAN, 0, 400, 40000},
+    };
+    volatile int32_t sink;
+
+    bench_cycles_init();
+    for (size_t s = 0; s < sizeof(stages) / sizeof(stages[0]); s++) {
+        struct filter_chain chain;
+        filter_chain_init(&chain, &stages[s], 1);
+        uint32_t cycles = 0;
+        for (int i = 0; i < RUNS; i++) {
+            int32_t value = 10065600 + (i * 7919) % 500; // Pressão em 0,01 Pa
+            uint32_t t0 = bench_cycles_now();
+            sink = filter_stage_apply(&chain.stage[0], value);
+            cycles += bench_cycles_since(t0);
+        }
+        printf("BENCH filtro %s(%u): %lu ciclos\n", filter_kind_name(stages[s].kind), stages[s].param,
+               (unsigned long)(cycles / RUNS));
+    }
+    (void)sink;
+}
+#endif
+
+// Tempo de cada passada de um núcleo pelos trabalhos prontos, por núcleo
+// (a fatia de cada um no histograma): um trabalho lento aparece aqui antes
+// de atrasar leituras ou respostas
+static struct metrics_histogram loop_work_time = {.buckets = &metrics_buckets_fast};
+
+// Log adiado (dlog.h): registros formatados por volta do laço ocioso do
+// núcleo 0, e de quanto em quanto tempo ele acorda só para isso (os outros
+// produtores, o núcleo 1 e as interrupções, não o acordam)
+#define DLOG_DRAIN_BATCH 8
+#define DLOG_DRAIN_MS    50
+
+// Laço de eventos de um núcleo: dorme até o próximo prazo ou até alguém
+// marcar trabalho pendente. No núcleo 0, sem trabalho pendente, o tempo
+// ocioso vai para o log: a saída pela USB pode esperar o host, mas o lwIP
+// segue atendendo na interrupção dele.
+static void run_event_loop(async_context_t *ctx)
+{
+    bool drains_log = get_core_num() == 0;
+    while (true) {
+        uint32_t start = time_us_32();
+        async_context_poll(ctx);
+        metrics_observe(&loop_work_time, time_us_32() - start);
+        if (drains_log && dlog_drain(DLOG_DRAIN_BATCH)) {
+            continue; // Ainda há registros: volta depois de olhar o trabalho
+        }
+        async_context_wait_for_work_until(ctx, drains_log ? make_timeout_time_ms(DLOG_DRAIN_MS)
+                                                          : at_the_end_of_time);
+    }
+}
+
+// Nome do pool do lwIP em /metrics
+static const struct {
+    memp_t pool;
+    const char *name;
+} lwip_pools[] = {
+    {MEMP_TCP_PCB,        "tcp_pcb"},
+    {MEMP_TCP_PCB_LISTEN, "tcp_pcb_listen"},
+    {MEMP_TCP_SEG,        "tcp_seg"},
+    {MEMP_PBUF,           "pbuf"},
+    {MEMP_PBUF_POOL,      "pbuf_pool"},
+};
+
+// Texto de /metrics. Roda no contexto do lwIP (handler), então lwip_stats e
+// os contadores do servidor estão parados; os do núcleo 1 (I2C, sensores)
+// são lidos palavra a palavra enquanto ele segue.
+static void format_metrics(struct metrics_writer *w)
+{
+    char labels[48];
+
+    metrics_family(w, "estacao_uptime_seconds", "gauge", "Tempo desde o boot");
+    metrics_sample(w, "estacao_uptime_seconds", NULL, time_us_64() / 1000000u);
+
+    // Servidor HTTP
+    metrics_family(w, "estacao_http_requests_total", "counter", "Requisicoes despachadas por rota");
+    for (size_t i = 0; i <= count_of(app_routes); i++) {
+        snprintf(labels, sizeof(labels), "route=\"%s\"", i < count_of(app_routes) ? app_routes[i].path : "static");
+        metrics_sample(w, "estacao_http_requests_total", labels, metrics_counter_value(&app_route_stats[i].requests));
+    }
+    metrics_family(w, "estacao_http_request_seconds", "histogram",
+                   "Da requisicao completa ao ultimo byte da resposta confirmado (sem streams)");
+    for (size_t i = 0; i <= count_of(app_routes); i++) {
+        if (!metrics_histogram_count(&app_route_stats[i].duration)) {
+            continue; // Sem uso ou só streams: fica só o contador acima (texto menor)
+        }
+        snprintf(labels, sizeof(labels), "route=\"%s\"", i < count_of(app_routes) ? app_routes[i].path : "static");
+        metrics_histogram_write(w, "estacao_http_request_seconds", labels, &app_route_stats[i].duration, -1);
+    }
+    const struct http_server_stats *http = http_server_get_stats();
+    metrics_family(w, "estacao_http_connections", "gauge", "Estados de conexao em uso");
+    metrics_sample(w, "estacao_http_connections", NULL, http->active);
+    metrics_family(w, "estacao_http_connections_max", "gauge", "Estados de conexao disponiveis (pool estatico)");
+    metrics_sample(w, "estacao_http_connections_max", NULL, HTTP_MAX_CONNECTIONS);
+    metrics_family(w, "estacao_http_connections_high_water", "gauge", "Maior uso do pool de conexoes");
+    metrics_sample(w, "estacao_http_connections_high_water", NULL, http->high_water);
+    metrics_family(w, "estacao_http_connections_total", "counter", "Conexoes aceitas e recusadas com 503");
+    metrics_sample(w, "estacao_http_connections_total", "result=\"accepted\"", http->accepted);
+    metrics_sample(w, "estacao_http_connections_total", "result=\"rejected\"", http->rejected);
+    metrics_family(w, "estacao_http_sent_bytes_total", "counter", "Bytes de resposta confirmados pelos clientes");
+    metrics_sample(w, "estacao_http_sent_bytes_total", NULL, http->bytes_acked);
+    metrics_family(w, "estacao_http_write_mem_errors_total", "counter", "tcp_write sem memoria (ERR_MEM)");
+    metrics_sample(w, "estacao_http_write_mem_errors_total", NULL, http->write_mem);
+    metrics_family(w, "estacao_http_stream_dropped_total", "counter", "Mensagens SSE/WebSocket descartadas");
+    metrics_sample(w, "estacao_http_stream_dropped_total", NULL, http->stream_drops);
+
+    // Barramentos I2C
+    metrics_family(w, "estacao_i2c_transfers_total", "counter", "Transacoes I2C por desfecho");
+    for (uint bus = 0; bus < SENSOR_BUSES; bus++) {
+        const struct i2c_async_stats *i2c = i2c_async_get_stats(sensor_i2c((uint8_t)bus));
+        snprintf(labels, sizeof(labels), "bus=\"%u\",result=\"ok\"", bus);
+        metrics_sample(w, "estacao_i2c_transfers_total", labels, metrics_counter_value(&i2c->completed));
+        snprintf(labels, sizeof(labels), "bus=\"%u\",result=\"nack\"", bus);
+        metrics_sample(w, "estacao_i2c_transfers_total", labels, metrics_counter_value(&i2c->nacks));
+        snprintf(labels, sizeof(labels), "bus=\"%u\",result=\"timeout\"", bus);
+        metrics_sample(w, "estacao_i2c_transfers_total", labels, metrics_counter_value(&i2c->timeouts));
+        snprintf(labels, sizeof(labels), "bus=\"%u\",result=\"busy\"", bus);
+        metrics_sample(w, "estacao_i2c_transfers_total", labels, metrics_counter_value(&i2c->rejected));
+    }
+    metrics_family(w, "estacao_i2c_transfer_duration_seconds", "histogram", "Do disparo da transacao I2C ao fim");
+    for (uint bus = 0; bus < SENSOR_BUSES; bus++) {
+        snprintf(labels, sizeof(labels), "bus=\"%u\"", bus);
+        metrics_histogram_write(w, "estacao_i2c_transfer_duration_seconds", labels,
+                                &i2c_async_get_stats(sensor_i2c((uint8_t)bus))->duration, -1);
+    }
+
+    // Sensores e escalonador
+    metrics_family(w, "estacao_sensor_reads_total", "counter", "Leituras por sensor e desfecho");
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "sensor=\"%s\",result=\"ok\"", sensors[i].label);
+        metrics_sample(w, "estacao_sensor_reads_total", labels, sensors[i].samples);
+        snprintf(labels, sizeof(labels), "sensor=\"%s\",result=\"error\"", sensors[i].label);
+        metrics_sample(w, "estacao_sensor_reads_total", labels, sensors[i].errors);
+    }
+    metrics_family(w, "estacao_sensor_online", "gauge", "Sensor respondeu no registro");
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        snprintf(labels, sizeof(labels), "sensor=\"%s\"", sensors[i].label);
+        metrics_sample(w, "estacao_sensor_online", labels, sensors[i].online);
+    }
+    const struct sensor_bus_stats *bus = &sensor_bus.stats;
+    metrics_family(w, "estacao_sensor_rounds_total", "counter", "Rodadas do escalonador e ticks pulados");
+    metrics_sample(w, "estacao_sensor_rounds_total", "result=\"done\"", bus->rounds);
+    metrics_sample(w, "estacao_sensor_rounds_total", "result=\"overrun\"", bus->overruns);
+    metrics_family(w, "estacao_sensor_round_microseconds", "gauge", "Duracao da ultima rodada e a maior");
+    metrics_sample(w, "estacao_sensor_round_microseconds", "stat=\"last\"", bus->last_round_us);
+    metrics_sample(w, "estacao_sensor_round_microseconds", "stat=\"max\"", bus->max_round_us);
+
+    // Laços de eventos
+    metrics_family(w, "estacao_loop_work_seconds", "histogram", "Passada do laco de eventos pelos trabalhos prontos");
+    for (int core = 0; core < METRICS_CORES; core++) {
+        snprintf(labels, sizeof(labels), "core=\"%d\"", core);
+        metrics_histogram_write(w, "estacao_loop_work_seconds", labels, &loop_work_time, core);
+    }
+
+    // lwIP: heap, pools e TCP
+    metrics_family(w, "estacao_lwip_mem_bytes", "gauge", "Heap do lwIP: em uso, maior uso e tamanho");
+    metrics_sample(w, "estacao_lwip_mem_bytes", "stat=\"used\"", lwip_stats.mem.used);
+    metrics_sample(w, "estacao_lwip_mem_bytes", "stat=\"max\"", lwip_stats.mem.max);
+    metrics_sample(w, "estacao_lwip_mem_bytes", "stat=\"avail\"", lwip_stats.mem.avail);
+    metrics_family(w, "estacao_lwip_mem_errors_total", "counter", "Alocacoes recusadas pelo heap do lwIP");
+    metrics_sample(w, "estacao_lwip_mem_errors_total", NULL, lwip_stats.mem.err);
+    metrics_family(w, "estacao_lwip_pool", "gauge", "Pools do lwIP: em uso, maior uso e tamanho");
+    for (size_t i = 0; i < count_of(lwip_pools); i++) {
+        const struct stats_mem *pool = lwip_stats.memp[lwip_pools[i].pool];
+        if (!pool) {
+            continue;
+        }
+        snprintf(labels, sizeof(labels), "pool=\"%s\",stat=\"used\"", lwip_pools[i].name);
+        metrics_sample(w, "estacao_lwip_pool", labels, pool->used);
+        snprintf(labels, sizeof(labels), "pool=\"%s\",stat=\"max\"", lwip_pools[i].name);
+        metrics_sample(w, "estacao_lwip_pool", labels, pool->max);
+        snprintf(labels, sizeof(labels), "pool=\"%s\",stat=\"avail\"", lwip_pools[i].name);
+        metrics_sample(w, "estacao_lwip_pool", labels, pool->avail);
+    }
+    metrics_family(w, "estacao_lwip_pool_errors_total", "counter", "Alocacoes recusadas por pool vazio");
+    for (size_t i = 0; i < count_of(lwip_pools); i++) {
+        const struct stats_mem *pool = lwip_stats.memp[lwip_pools[i].pool];
+        if (pool) {
+            snprintf(labels, sizeof(labels), "pool=\"%s\"", lwip_pools[i].name);
+            metrics_sample(w, "estacao_lwip_pool_errors_total", labels, pool->err);
+        }
+    }
+    metrics_family(w, "estacao_lwip_tcp_segments_total", "counter", "Segmentos TCP enviados e recebidos");
+    metrics_sample(w, "estacao_lwip_tcp_segments_total", "dir=\"tx\"", lwip_stats.tcp.xmit);
+    metrics_sample(w, "estacao_lwip_tcp_segments_total", "dir=\"rx\"", lwip_stats.tcp.recv);
+    metrics_family(w, "estacao_lwip_tcp_errors_total", "counter", "Erros do TCP do lwIP por tipo");
+    metrics_sample(w, "estacao_lwip_tcp_errors_total", "kind=\"drop\"", lwip_stats.tcp.drop);
+    metrics_sample(w, "estacao_lwip_tcp_errors_total", "kind=\"mem\"", lwip_stats.tcp.memerr);
+    metrics_sample(w, "estacao_lwip_tcp_errors_total", "kind=\"checksum\"", lwip_stats.tcp.chkerr);
+    metrics_sample(w, "estacao_lwip_tcp_errors_total", "kind=\"protocol\"", lwip_stats.tcp.proterr);
+    metrics_sample(w, "estacao_lwip_tcp_errors_total", "kind=\"routing\"", lwip_stats.tcp.rterr);
+    metrics_sample(w, "estacao_lwip_tcp_errors_total", "kind=\"other\"", lwip_stats.tcp.err);
+}
+
+// Núcleo 1: sensores, alertas e atuadores no seu próprio laço de eventos
+static void core1_main(void)
+{
+    // O núcleo 0 grava a flash (log, configuração): este núcleo precisa poder
+    // ser pausado durante a gravação, já que executa da flash
+    flash_safe_execute_core_init();
+
+    for (int i = 0; i < CH_COUNT; i++) {
+        filter_chain_init(&filters[i], filter_config[i], FILTER_MAX_STAGES);
+    }
+
+    // Registro dos sensores: configuração bloqueante, antes do modo assíncrono
+    sensor_bus_init(&sensor_bus, &sensor_bus_ops, NULL);
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        struct sensor *s = &sensors[i];
+        sensor_bus_add(&sensor_bus, s);
+        printf("Sensor %s: %s em i2c%u", s->label, s->driver->name, s->bus);
+        if (s->mux_addr) {
+            printf(" (mux 0x%02x canal %u)", s->mux_addr, s->mux_channel);
+        }
+        printf(s->online ? ", endereco 0x%02x\n" : ", sem resposta (0x%02x)\n", s->addr);
+    }
+    const struct bmp280_profile_info *bmp_profile = bmp280_profile_info(BMP_PROFILE);
+    printf("BMP280: perfil %s, conversao ate %lu us, taxa maxima %lu.%03lu Hz\n", bmp_profile->name,
+           (unsigned long)bmp_profile->conversion_us, (unsigned long)(bmp_profile->rate_mhz / 1000),
+           (unsigned long)(bmp_profile->rate_mhz % 1000));
+
+    // Daqui em diante as transações saem por DMA: o pool de alarmes e as
+    // interrupções do I2C ficam neste núcleo
+    alarm_pool_t *sensor_alarms = alarm_pool_create_with_unused_hardware_alarm(4);
+    buzzer_seq_init(BUZZER_A_PIN, sensor_alarms); // Padrões do buzzer no mesmo pool (núcleo 1)
+    if (!i2c_async_init(I2C_PORT_0, sensor_alarms, sensor_xfer_done, NULL) ||
+        !i2c_async_init(I2C_PORT_1, sensor_alarms, sensor_xfer_done, NULL)) {
+        printf("Sensores: sem canais de DMA livres\n");
+    }
+
+    async_context_poll_init_with_defaults(&sensor_context);
+    async_context_t *ctx = &sensor_context.core;
+    async_context_add_when_pending_worker(ctx, &alert_worker);
+    async_context_add_when_pending_worker(ctx, &sensor_bus_worker);
+    schedule_periodic(ctx, &sample_work);
+    multicore_fifo_push_blocking(1); // Pronto: o núcleo 0 já pode pedir trabalho
+    run_event_loop(ctx);
 }
 
 int main(){
+    // Configuração salva antes de qualquer outra inicialização: a primeira
+    // amostra e os primeiros alertas já usam os limites e offsets do usuário
+    struct station_config config;
+    uint64_t config_load_start = time_us_64();
+    bool config_restored = config_store_load(&config) && config_valid(&config);
+    if (config_restored) {
+        apply_config(&config);
+    }
+    update_alert_bands(); // Faixas dos alertas a partir dos limites (salvos ou padrão)
+    uint64_t config_ready = time_us_64(); // O timer conta desde o reset
+
+    // Antes das interrupções dos botões e do núcleo 1, que marcam trabalho nele
+    async_context_poll_init_with_defaults(&app_context);
+    async_context_add_when_pending_worker(&app_context.core, &button_state_worker);
+
     gpio_init(BOTAO_B_PIN);
     gpio_set_dir(BOTAO_B_PIN, GPIO_IN);
     gpio_pull_up(BOTAO_B_PIN);
@@ -361,133 +1988,43 @@ int main(){
     char ip_str[24];
     snprintf(ip_str, sizeof(ip_str), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
     printf("IP: %s\n",ip_str);
-    start_http_server();
-    set_led_green();
-    
-    // Inicializa o BMP280
-    bmp280_init(I2C_PORT_0);
-    struct bmp280_calib_param params;
-    bmp280_get_calib_params(I2C_PORT_0, &params);
-
-    // Inicializa o AHT20
-    aht20_reset(I2C_PORT_1);
-    aht20_init(I2C_PORT_1);
-
-    // Estrutura para armazenar os dados do sensor
-    AHT20_Data data;
-    int32_t raw_temp_bmp;
-    int32_t raw_pressure;
-
-
-    while (1)
-    {
-        // Leitura do BMP280
-        bmp280_read_raw(I2C_PORT_0, &raw_temp_bmp, &raw_pressure);
-        int32_t temperature = bmp280_convert_temp(raw_temp_bmp, &params);
-        int32_t pressure = bmp280_convert_pressure(raw_pressure, raw_temp_bmp, &params);
-
-        
-
-        g_bmp_temperature = temperature / 100.0f; // 'temperature' do BMP280 em centésimos
-        g_bmp_pressure = pressure; // 'pressure' do BMP280 em Pa
-       
-
-        g_bmp_temperature += g_temp_offset;
-        g_bmp_pressure += g_pressure_offset;
-
-        // PRINTS PARA DEPURAÇÃO NO TERMINAL//////////////////////////
-        printf("-----------BMP280 LEITURAS-----------------\n");
-        printf("Pressao = %.3f kPa\n", pressure / 1000.0);
-        printf("Temperatura BMP: = %.2f C\n", temperature / 100.0);
-
-        // Leitura do AHT20
-        if (aht20_read(I2C_PORT_1, &data)){
-            printf("----------AHT LEITURAS------------------\n");
-            printf("Temperatura : %.2f C\n", data.temperature);
-            printf("Umidade: %.2f %%\n\n\n", data.humidity);
-        }
-        else{
-            play_tone(BUZZER_A_PIN,3000);
-            sleep_ms(2000);
-            stop_tone(BUZZER_A_PIN);
-            printf("Erro na leitura do AHT10!\n\n\n");
-        }
-
-        g_aht_temperature = data.temperature; 
-        g_aht_humidity = data.humidity;
-
-        g_aht_temperature += g_temp_offset;
-        g_aht_humidity += g_humidity_offset;
-
-        if (g_alerts_enabled) { // Verifica se os alertas estão habilitados
-            bool alert_active = false;
-
-            // Verificar Pressão BMP280 e umidade aht20
-            if ((g_bmp_pressure < g_pressure_min_limit || g_bmp_pressure > g_pressure_max_limit)  && (g_aht_humidity < g_humidity_min_limit || g_aht_humidity > g_humidity_max_limit)) {
-                printf("ALERTA: Pressao BMP280 fora dos limites! (%.2f Pa)\n", g_bmp_pressure);
-                set_one_led(0,125,0,matriz_preenchida);
-                alert_active = true;
-            }
-            // Verificar Temperatura AHT20 e umidade aht20
-            else if ((g_aht_humidity < g_humidity_min_limit || g_aht_humidity > g_humidity_max_limit) && (g_aht_temperature < g_temp_min_limit || g_aht_temperature > g_temp_max_limit)) {
-                printf("ALERTA: Umidade AHT20 fora dos limites! (%.2f %%)\n", g_aht_humidity);
-                set_one_led(125,0,125,matriz_preenchida);
-                alert_active = true;
-            }
-            // Verificar Temperatura AHT20 e pressao bmp280
-            else if ((g_aht_temperature < g_temp_min_limit || g_aht_temperature > g_temp_max_limit) && (g_bmp_pressure < g_pressure_min_limit || g_bmp_pressure > g_pressure_max_limit)) {
-                printf("ALERTA: Umidade AHT20 fora dos limites! (%.2f %%)\n", g_aht_humidity);
-                set_one_led(125,125,125,matriz_preenchida);
-                alert_active = true;
-            }
-            // Verificar Umidade AHT20
-            else if (g_aht_humidity < g_humidity_min_limit || g_aht_humidity > g_humidity_max_limit) {
-                printf("ALERTA: Umidade AHT20 fora dos limites! (%.2f %%)\n", g_aht_humidity);
-                set_one_led(0,0,125,matriz_preenchida);
-                alert_active = true;
-            }
-            // Verificar Pressão BMP280 (pode precisar de ajuste se g_bmp_pressure for kPa ou hPa)
-            else if (g_bmp_pressure < g_pressure_min_limit || g_bmp_pressure > g_pressure_max_limit) {
-                printf("ALERTA: Pressao BMP280 fora dos limites! (%.2f Pa)\n", g_bmp_pressure);
-                set_one_led(125,125,0,matriz_preenchida);
-                alert_active = true;
-            }
-            // Verificar Temperatura AHT20
-            else if (g_aht_temperature < g_temp_min_limit || g_aht_temperature > g_temp_max_limit) {
-                printf("ALERTA: Temperatura AHT20 fora dos limites! (%.2f C)\n", g_aht_temperature);
-                set_one_led(125,0,0,matriz_preenchida);
-                alert_active = true;
-            }
-             // Verificar Pressão BMP280 e umidade aht20
-            if ((g_bmp_pressure < g_pressure_min_limit || g_bmp_pressure > g_pressure_max_limit)  && (g_aht_humidity < g_humidity_min_limit || g_aht_humidity > g_humidity_max_limit)) {
-                printf("ALERTA: Pressao BMP280 fora dos limites! (%.2f Pa)\n", g_bmp_pressure);
-                set_one_led(0,125,0,matriz_preenchida);
-                alert_active = true;
-            }
-
-
-            if (alert_active) {
-                play_tone(BUZZER_A_PIN, 2000); // Toca um tom de alerta
-                sleep_ms(50); // Duração do tom
-                stop_tone(BUZZER_A_PIN);
-                set_led_red();
-            } else {
-                set_led_green(); // Se não houver alerta, LED verde
-                set_one_led(0,0,0,matriz_preenchida);
-            }
-        } else {
-            // Se os alertas estiverem desabilitados, garanta que o LED não esteja em estado de alerta
-            set_led_green(); // Ex: LED verde quando não há alerta e sistema normal
-            set_one_led(0,0,0,matriz_preenchida);
-        }
-
-           
-        // Mantém o servidor HTTP ativo
-        cyw43_arch_poll();
-        sleep_ms(1000);
-        //////////////////////////////////////////////////////////////
-
-    }
+    printf("Configuracao %s em %llu us apos o boot (leitura: %llu us)\n",
+           config_restored ? "restaurada da flash" : "padrao",
+           (unsigned long long)config_ready, (unsigned long long)(config_ready - config_load_start));
+
+    // Log em flash: continua do último bloco gravado, e o relógio do log
+    // continua do último horário até o SNTP responder
+    g_log_ready = tslog_flash_init(&station_log);
+    wall_clock_init(tslog_last_time(&station_log) + 1);
+
+    set_led_green(); // Daqui em diante LEDs, matriz e buzzer são do núcleo 1
+
+    // Aquisição no núcleo 1; o servidor só começa quando ele já aceita pedidos
+    multicore_launch_core1(core1_main);
+    multicore_fifo_pop_blocking();
+    sensor_core_ready = true;
+
+    http_server_start(80, &app_router);
+    cyw43_arch_lwip_begin();
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_setservername(0, SNTP_SERVER);
+    sntp_init();
+    cyw43_arch_lwip_end();
+
+#ifdef ESTACAO_BENCHMARKS
+    cyw43_arch_lwip_begin(); // O cache do JSON só é usado com o lwIP travado
+    bench_system_state();
+    cyw43_arch_lwip_end();
+    bench_compensation();
+    bench_filters();
+#endif
+
+    // Laço de eventos do núcleo 0: dorme até o próximo prazo agendado ou até
+    // o núcleo 1 publicar uma amostra
+    async_context_t *ctx = &app_context.core;
+    async_context_add_when_pending_worker(ctx, &publish_worker);
+    schedule_periodic(ctx, &housekeeping_work);
+    run_event_loop(ctx);
 
     return 0;
 }
\ No newline at end of file
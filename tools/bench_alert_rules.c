@@ -0,0 +1,174 @@
+// Benchmark do motor de regras dos alertas (lib/alerts/alert_rules.c) no PC.
+//
+// Mostra:
+//   - quantas vezes o alerta liga e desliga com uma leitura ruidosa rondando
+//     o limite, comparando sem histerese, só com histerese e com histerese e
+//     duração mínima (os padrões do firmware)
+//   - ciclos (TSC, em x86) e ns por avaliação: a cadeia de if/else em float
+//     que o firmware tinha (3 canais, 6 combinações), a tabela com a mesma
+//     configuração e a tabela cheia (64 canais, 16 regras)
+// No PC há FPU, então a cadeia em float sai bem mais barata aqui do que no
+// M0+, onde cada comparação de float é uma chamada de biblioteca.
+//
+//   cc -O2 -Ilib/alerts tools/bench_alert_rules.c lib/alerts/alert_rules.c -lm -o bench_alert_rules
+//   ./bench_alert_rules
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "alert_rules.h"
+#include "bench_host.h"
+
+#define SAMPLE_MS 1000    // Uma amostra dos AHT20 por segundo
+#define SAMPLES   (6 * 3600) // Seis horas de leituras
+#define RUNS      1000000
+
+static volatile int sink;
+
+// Configuração da estação: temperatura, umidade e pressão (centésimos)
+static void station_config(struct alert_config *c, int32_t hysteresis_scale, uint32_t duration_ms)
+{
+    static const struct alert_band bands[3] = {
+        {1800, 3000, 50, 0}, {4000, 8500, 200, 0}, {9800000, 10200000, 10000, 0},
+    };
+    static const struct { uint64_t mask; uint8_t priority; } rules[6] = {
+        {6, 60}, {3, 50}, {5, 40}, {2, 30}, {4, 20}, {1, 10},
+    };
+    memset(c, 0, sizeof(*c));
+    c->channels = 3;
+    for (int i = 0; i < 3; i++) {
+        c->band[i] = bands[i];
+        c->band[i].hysteresis *= hysteresis_scale;
+        c->band[i].min_duration_ms = duration_ms;
+    }
+    c->rules = 6;
+    for (int r = 0; r < 6; r++) {
+        c->rule[r].mask = rules[r].mask;
+        c->rule[r].priority = rules[r].priority;
+    }
+}
+
+// A cadeia de if/else do firmware antigo, com os limites em float
+struct ladder_limits { float t_min, t_max, h_min, h_max, p_min, p_max; };
+
+static int ladder(const struct ladder_limits *l, float t, float h, float p)
+{
+    bool t_out = t < l->t_min || t > l->t_max;
+    bool h_out = h < l->h_min || h > l->h_max;
+    bool p_out = p < l->p_min || p > l->p_max;
+    if (p_out && h_out) return 0;
+    else if (h_out && t_out) return 1;
+    else if (t_out && p_out) return 2;
+    else if (h_out) return 3;
+    else if (p_out) return 4;
+    else if (t_out) return 5;
+    return ALERT_NONE;
+}
+
+// Temperatura subindo e descendo devagar em torno do máximo (30 °C), com
+// ruído de ±0,6 °C como o de um sensor sem filtro
+static int32_t noisy_temperature(int i)
+{
+    return 2950 + (int32_t)(100 * sin(i / 900.0)) + rand() % 121 - 60;
+}
+
+static unsigned count_toggles(const struct alert_config *c, const int32_t *temp)
+{
+    struct alert_state s;
+    alert_state_reset(&s);
+    unsigned toggles = 0;
+    int last = ALERT_NONE;
+    for (int i = 0; i < SAMPLES; i++) {
+        int32_t value[3] = {temp[i], 6000, 10132500};
+        int active = alert_evaluate(c, &s, value, (uint32_t)i * SAMPLE_MS);
+        toggles += (active == ALERT_NONE) != (last == ALERT_NONE);
+        last = active;
+    }
+    return toggles;
+}
+
+static void report(const char *name, uint64_t cycles, double ns)
+{
+#ifdef HAVE_TSC
+    printf("%-28s %5llu ciclos (%6.1f ns)/avaliação\n", name, (unsigned long long)cycles, ns);
+#else
+    (void)cycles;
+    printf("%-28s %6.1f ns/avaliação\n", name, ns);
+#endif
+}
+
+int main(void)
+{
+    static int32_t temp[SAMPLES];
+    srand(1);
+    for (int i = 0; i < SAMPLES; i++) {
+        temp[i] = noisy_temperature(i);
+    }
+
+    static const struct { const char *name; int32_t hysteresis_scale; uint32_t duration_ms; } setups[] = {
+        {"sem histerese", 0, 0},
+        {"histerese", 1, 0},
+        {"histerese + 3 s", 1, 3000},
+    };
+    printf("%-28s %s\n", "alerta (6 h de leituras)", "liga/desliga");
+    for (size_t k = 0; k < sizeof(setups) / sizeof(setups[0]); k++) {
+        struct alert_config c;
+        station_config(&c, setups[k].hysteresis_scale, setups[k].duration_ms);
+        printf("%-28s %12u\n", setups[k].name, count_toggles(&c, temp));
+    }
+    printf("\n");
+
+    // Custo por avaliação, sobre leituras que variam (a máscara muda às vezes)
+    const struct ladder_limits limits = {18.0f, 30.0f, 40.0f, 85.0f, 98000.0f, 102000.0f};
+    uint64_t c0 = cycles_now();
+    double t0 = now_ns();
+    for (int i = 0; i < RUNS; i++) {
+        int32_t t = temp[i % SAMPLES];
+        sink = ladder(&limits, t / 100.0f, 60.0f, 101325.0f);
+    }
+    report("if/else em float", (cycles_now() - c0) / RUNS, (now_ns() - t0) / RUNS);
+
+    struct alert_config station;
+    station_config(&station, 1, 3000);
+    struct alert_state s;
+    alert_state_reset(&s);
+    c0 = cycles_now();
+    t0 = now_ns();
+    for (int i = 0; i < RUNS; i++) {
+        int32_t value[3] = {temp[i % SAMPLES], 6000, 10132500};
+        sink = alert_evaluate(&station, &s, value, (uint32_t)i * SAMPLE_MS);
+    }
+    report("tabela, 3 canais/6 regras", (cycles_now() - c0) / RUNS, (now_ns() - t0) / RUNS);
+
+    // Tabela cheia: 64 canais, 16 regras de 1 a 4 canais cada
+    static struct alert_config full;
+    full.channels = ALERT_MAX_CHANNELS;
+    for (int i = 0; i < ALERT_MAX_CHANNELS; i++) {
+        full.band[i] = (struct alert_band){1800, 3000, 50, 3000};
+    }
+    full.rules = ALERT_MAX_RULES;
+    for (int r = 0; r < ALERT_MAX_RULES; r++) {
+        for (int k = 0; k <= r % 4; k++) {
+            full.rule[r].mask |= (uint64_t)1 << ((r * 4 + k * 17) % ALERT_MAX_CHANNELS);
+        }
+        full.rule[r].priority = (uint8_t)r;
+    }
+    if (!alert_config_valid(&full)) {
+        fprintf(stderr, "configuração cheia inválida\n");
+        return 1;
+    }
+    static int32_t values[ALERT_MAX_CHANNELS];
+    alert_state_reset(&s);
+    c0 = cycles_now();
+    t0 = now_ns();
+    for (int i = 0; i < RUNS / 10; i++) {
+        for (int k = 0; k < ALERT_MAX_CHANNELS; k++) {
+            values[k] = temp[(i + k * 131) % SAMPLES];
+        }
+        sink = alert_evaluate(&full, &s, values, (uint32_t)i * SAMPLE_MS);
+    }
+    report("tabela, 64 canais/16 regras", (cycles_now() - c0) / (RUNS / 10), (now_ns() - t0) / (RUNS / 10));
+    return 0;
+}
@@ -0,0 +1,207 @@
+// Teste de valores de referência e benchmark da compensação dos sensores
+// (lib/sensores/compensation.c) no PC.
+//
+// Confere:
+//   - o exemplo do datasheet do BMP280 (seção 3.12) e uma varredura de
+//     quadros brutos contra as fórmulas em double do datasheet (seção 8.1) e
+//     contra a compensação de 32 bits original (duas chamadas, t_fine duas vezes)
+//   - todos os 2^20 valores brutos do AHT20 contra a conversão em double
+// e mede ciclos (TSC, em x86) e ns por amostra do caminho novo e do antigo.
+// No PC há FPU, então o ganho de sair do float/double aparece bem menor aqui
+// do que no M0+ (ESTACAO_BENCHMARKS mede no dispositivo).
+//
+//   cc -O2 -Ilib/sensores tools/bench_compensation.c lib/sensores/compensation.c -lm -o bench_compensation
+//   ./bench_compensation      (código de saída 1 se algum valor divergir)
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "compensation.h"
+#include "bench_host.h"
+
+// Calibração do exemplo do datasheet
+static const struct bmp280_calib_param datasheet_calib = {
+    27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+};
+
+#define RUNS 1000000
+
+// A compensação de 32 bits do datasheet arredonda a pressão para Pa inteiros
+// e trunca etapas intermediárias: alguns Pa de diferença para o double
+// (a exatidão absoluta do sensor é ±100 Pa)
+#define PRESSURE_TOLERANCE_PA 8.0
+
+// Fórmulas em double do datasheet (seção 8.1)
+static void reference_bmp280(int32_t adc_t, int32_t adc_p, const struct bmp280_calib_param *c,
+                             double *temp, double *pressure)
+{
+    double var1 = (adc_t / 16384.0 - c->dig_t1 / 1024.0) * c->dig_t2;
+    double var2 = (adc_t / 131072.0 - c->dig_t1 / 8192.0) * (adc_t / 131072.0 - c->dig_t1 / 8192.0) * c->dig_t3;
+    double t_fine = var1 + var2;
+    *temp = t_fine / 5120.0;
+
+    var1 = t_fine / 2.0 - 64000.0;
+    var2 = var1 * var1 * c->dig_p6 / 32768.0;
+    var2 = var2 + var1 * c->dig_p5 * 2.0;
+    var2 = var2 / 4.0 + c->dig_p4 * 65536.0;
+    var1 = (c->dig_p3 * var1 * var1 / 524288.0 + c->dig_p2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * c->dig_p1;
+    if (var1 == 0.0) {
+        *pressure = 0;
+        return;
+    }
+    double p = 1048576.0 - adc_p;
+    p = (p - var2 / 4096.0) * 6250.0 / var1;
+    var1 = c->dig_p9 * p * p / 2147483648.0;
+    var2 = p * c->dig_p8 / 32768.0;
+    *pressure = p + (var1 + var2 + c->dig_p7) / 16.0;
+}
+
+// Caminho anterior: temperatura e pressão em chamadas separadas, depois float.
+// Fora de linha, como as funções novas (em outro arquivo)
+__attribute__((noinline)) static void old_bmp280(int32_t adc_t, int32_t adc_p, const struct bmp280_calib_param *c,
+                       float *temp, float *pressure)
+{
+    int32_t t_fine = bmp280_t_fine(adc_t, c);
+    int32_t temp_centi = (t_fine * 5 + 128) >> 8;
+    uint32_t pa = bmp280_pressure_from_t_fine(adc_p, bmp280_t_fine(adc_t, c), c);
+    *temp = temp_centi / 100.0f;
+    *pressure = (float)pa;
+}
+
+// Conversão anterior do AHT20, em double
+__attribute__((noinline)) static void old_aht20(const uint8_t *buffer, float *temp, float *humidity)
+{
+    uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
+    *humidity = (float)raw_humidity * 100.0 / 1048576.0;
+    uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
+    *temp = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+}
+
+static void aht20_frame(uint32_t raw_humidity, uint32_t raw_temp, uint8_t *frame)
+{
+    frame[0] = 0x18;
+    frame[1] = raw_humidity >> 12;
+    frame[2] = raw_humidity >> 4;
+    frame[3] = (uint8_t)((raw_humidity & 0x0F) << 4) | (raw_temp >> 16);
+    frame[4] = raw_temp >> 8;
+    frame[5] = raw_temp;
+}
+
+static volatile int32_t sink; // Impede o compilador de descartar as contas
+
+int main(void)
+{
+    int failures = 0;
+
+    // Exemplo do datasheet: adc_T = 519888, adc_P = 415148 -> 25,08 °C, ~100653 Pa
+    int32_t temp_centi;
+    uint32_t pressure_pa;
+    bmp280_compensate(519888, 415148, &datasheet_calib, &temp_centi, &pressure_pa);
+    double ref_temp, ref_pressure;
+    reference_bmp280(519888, 415148, &datasheet_calib, &ref_temp, &ref_pressure);
+    bool example_ok = temp_centi == 2508 && fabs(pressure_pa - ref_pressure) <= PRESSURE_TOLERANCE_PA;
+    printf("exemplo do datasheet: %d.%02d C, %u Pa (double: %.2f C, %.2f Pa) %s\n", temp_centi / 100,
+           temp_centi % 100, pressure_pa, ref_temp, ref_pressure, example_ok ? "ok" : "FALHOU");
+    failures += !example_ok;
+
+    // Varredura de -40 a 85 °C e 300 a 1100 hPa (faixa do sensor)
+    double max_temp_err = 0, max_pressure_err = 0;
+    unsigned frames = 0, mismatches = 0;
+    for (int32_t adc_t = 380000; adc_t <= 640000; adc_t += 1000) {
+        for (int32_t adc_p = 180000; adc_p <= 650000; adc_p += 1000) {
+            bmp280_compensate(adc_t, adc_p, &datasheet_calib, &temp_centi, &pressure_pa);
+            reference_bmp280(adc_t, adc_p, &datasheet_calib, &ref_temp, &ref_pressure);
+            if (ref_temp < -40 || ref_temp > 85 || ref_pressure < 30000 || ref_pressure > 110000) {
+                continue;
+            }
+            frames++;
+            float old_temp, old_pressure;
+            old_bmp280(adc_t, adc_p, &datasheet_calib, &old_temp, &old_pressure);
+            mismatches += lroundf(old_temp * 100) != temp_centi || (uint32_t)old_pressure != pressure_pa;
+            max_temp_err = fmax(max_temp_err, fabs(temp_centi / 100.0 - ref_temp));
+            max_pressure_err = fmax(max_pressure_err, fabs(pressure_pa - ref_pressure));
+        }
+    }
+    bool sweep_ok = mismatches == 0 && max_temp_err <= 0.01 && max_pressure_err <= PRESSURE_TOLERANCE_PA;
+    printf("BMP280 varredura: %u quadros, %u diferentes do caminho anterior, erro máx. %.4f C / %.2f Pa "
+           "contra o double do datasheet %s\n", frames, mismatches, max_temp_err, max_pressure_err,
+           sweep_ok ? "ok" : "FALHOU");
+    failures += !sweep_ok;
+
+    // AHT20: todos os valores brutos, contra o double arredondado para centésimos
+    unsigned aht_worst = 0;
+    for (uint32_t raw = 0; raw < (1u << 20); raw++) {
+        uint8_t frame[6];
+        int32_t t, h;
+        aht20_frame(raw, raw, frame);
+        aht20_compensate(frame, &t, &h);
+        long ref_h = lround(raw * 10000.0 / 1048576.0);
+        long ref_t = lround(raw * 20000.0 / 1048576.0) - 5000;
+        unsigned err = (unsigned)labs(h - ref_h) + (unsigned)labs(t - ref_t);
+        aht_worst = err > aht_worst ? err : aht_worst;
+    }
+    printf("AHT20: 2^20 valores brutos, diferença máx. %u centésimo(s) %s\n", aht_worst,
+           aht_worst <= 1 ? "ok" : "FALHOU");
+    failures += aht_worst > 1;
+
+    // Benchmark: quadros variando para não virar constante
+    uint64_t c0 = cycles_now();
+    double t0 = now_ns();
+    for (int i = 0; i < RUNS; i++) {
+        bmp280_compensate(519888 + (i & 1023), 415148 + (i & 2047), &datasheet_calib, &temp_centi, &pressure_pa);
+        sink = temp_centi + (int32_t)pressure_pa;
+    }
+    double new_bmp_ns = (now_ns() - t0) / RUNS;
+    uint64_t new_bmp_cycles = (cycles_now() - c0) / RUNS;
+
+    c0 = cycles_now();
+    t0 = now_ns();
+    for (int i = 0; i < RUNS; i++) {
+        float t, p;
+        old_bmp280(519888 + (i & 1023), 415148 + (i & 2047), &datasheet_calib, &t, &p);
+        sink = (int32_t)(t + p);
+    }
+    double old_bmp_ns = (now_ns() - t0) / RUNS;
+    uint64_t old_bmp_cycles = (cycles_now() - c0) / RUNS;
+
+    uint8_t frame[6];
+    aht20_frame(0x80000, 0x60000, frame);
+    c0 = cycles_now();
+    t0 = now_ns();
+    for (int i = 0; i < RUNS; i++) {
+        int32_t t, h;
+        frame[2] = (uint8_t)(i >> 8);
+        frame[5] = (uint8_t)i;
+        aht20_compensate(frame, &t, &h);
+        sink = t + h;
+    }
+    double new_aht_ns = (now_ns() - t0) / RUNS;
+    uint64_t new_aht_cycles = (cycles_now() - c0) / RUNS;
+
+    c0 = cycles_now();
+    t0 = now_ns();
+    for (int i = 0; i < RUNS; i++) {
+        float t, h;
+        frame[2] = (uint8_t)(i >> 8);
+        frame[5] = (uint8_t)i;
+        old_aht20(frame, &t, &h);
+        sink = (int32_t)(t + h);
+    }
+    double old_aht_ns = (now_ns() - t0) / RUNS;
+    uint64_t old_aht_cycles = (cycles_now() - c0) / RUNS;
+
+#ifdef HAVE_TSC
+    printf("BMP280: %llu ciclos (%.1f ns)/amostra numa passada, %llu ciclos (%.1f ns) no caminho anterior\n",
+           (unsigned long long)new_bmp_cycles, new_bmp_ns, (unsigned long long)old_bmp_cycles, old_bmp_ns);
+    printf("AHT20: %llu ciclos (%.1f ns)/amostra em inteiros, %llu ciclos (%.1f ns) em double\n",
+           (unsigned long long)new_aht_cycles, new_aht_ns, (unsigned long long)old_aht_cycles, old_aht_ns);
+#else
+    (void)new_bmp_cycles, (void)old_bmp_cycles, (void)new_aht_cycles, (void)old_aht_cycles;
+    printf("BMP280: %.1f ns/amostra numa passada, %.1f ns no caminho anterior\n", new_bmp_ns, old_bmp_ns);
+    printf("AHT20: %.1f ns/amostra em inteiros, %.1f ns em double\n", new_aht_ns, old_aht_ns);
+#endif
+
+    return failures ? 1 : 0;
+}
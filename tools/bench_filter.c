@@ -0,0 +1,116 @@
+// Benchmark dos filtros em ponto fixo (lib/filter) no PC.
+//
+// Gera um sinal de umidade (0,01 %) perto do limite de alerta, com ruído de
+// sensor e leituras isoladas fora da curva (picos), e compara cadeias de
+// filtros com o sinal bruto:
+//   - ruído residual (RMS do erro contra o sinal verdadeiro)
+//   - alarmes falsos: amostras acima do limite sem que o sinal verdadeiro esteja
+//   - atraso: amostras até a saída acompanhar um degrau real
+// Também mede o custo de cada estágio (ciclos pelo TSC em x86, e ns).
+//
+//   cc -O2 -Ilib tools/bench_filter.c lib/filter/filter.c -lm -o bench_filter
+//   ./bench_filter
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "filter/filter.h"
+#include "bench_host.h"
+
+#define SAMPLES     100000
+#define LIMIT       8500   // Umidade máxima: 85,00 %
+#define SPIKE_EVERY 97     // Uma leitura fora da curva a cada ~97
+#define RUNS        2000000
+
+static uint32_t rng_state = 2024;
+static int32_t noise(int32_t amplitude)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (int32_t)(rng_state % (2 * amplitude + 1)) - amplitude;
+}
+
+static int32_t truth_at(int i)
+{
+    // Oscila de 80 a 84 %, sempre abaixo do limite, com um degrau real no fim
+    if (i >= SAMPLES - 200) {
+        return 9000;
+    }
+    return 8200 + (int32_t)lround(200 * sin(i * 2 * M_PI / 5000));
+}
+
+struct pipeline {
+    const char *name;
+    struct filter_stage_config stages[FILTER_MAX_STAGES];
+};
+
+static const struct pipeline pipelines[] = {
+    {"bruto", {{.kind = FILTER_NONE}}},
+    {"mediana 5", {{.kind = FILTER_MEDIAN, .param = 5}}},
+    {"ema 1/4", {{.kind = FILTER_EMA, .param = 2}}},
+    {"kalman", {{.kind = FILTER_KALMAN, .q = 100, .r = 2500}}},
+    {"mediana 5 + ema 1/4", {{.kind = FILTER_MEDIAN, .param = 5}, {.kind = FILTER_EMA, .param = 2}}},
+    {"mediana 5 + kalman", {{.kind = FILTER_MEDIAN, .param = 5}, {.kind = FILTER_KALMAN, .q = 100, .r = 2500}}},
+};
+
+static volatile int32_t sink;
+
+int main(void)
+{
+    static int32_t raw[SAMPLES];
+    for (int i = 0; i < SAMPLES; i++) {
+        raw[i] = truth_at(i) + noise(50); // ±0,5 %
+        if (i % SPIKE_EVERY == SPIKE_EVERY / 2 && i < SAMPLES - 200) {
+            raw[i] += 1500; // Leitura isolada 15 % acima
+        }
+    }
+
+    printf("%-22s %12s %16s %8s\n", "cadeia", "ruído RMS", "alarmes falsos", "atraso");
+    for (size_t p = 0; p < sizeof(pipelines) / sizeof(pipelines[0]); p++) {
+        struct filter_chain chain;
+        filter_chain_init(&chain, pipelines[p].stages, FILTER_MAX_STAGES);
+        double sq = 0;
+        unsigned false_alarms = 0;
+        int lag = -1;
+        for (int i = 0; i < SAMPLES; i++) {
+            int32_t out = filter_chain_apply(&chain, raw[i]);
+            int32_t truth = truth_at(i);
+            if (i < SAMPLES - 200) {
+                sq += (double)(out - truth) * (out - truth);
+                false_alarms += out > LIMIT;
+            } else if (lag < 0 && out > LIMIT) {
+                lag = i - (SAMPLES - 200);
+            }
+        }
+        printf("%-22s %10.2f %% %16u %8d\n", pipelines[p].name, sqrt(sq / (SAMPLES - 200)) / 100,
+               false_alarms, lag);
+    }
+
+    // Custo por estágio, com a entrada variando
+    static const struct { const char *name; struct filter_stage_config config; } stages[] = {
+        {"mediana 3", {.kind = FILTER_MEDIAN, .param = 3}},
+        {"mediana 5", {.kind = FILTER_MEDIAN, .param = 5}},
+        {"mediana 9", {.kind = FILTER_MEDIAN, .param = 9}},
+        {"ema", {.kind = FILTER_EMA, .param = 2}},
+        {"kalman", {.kind = FILTER_KALMAN, .q = 100, .r = 2500}},
+    };
+    for (size_t s = 0; s < sizeof(stages) / sizeof(stages[0]); s++) {
+        struct filter_chain chain;
+        filter_chain_init(&chain, &stages[s].config, 1);
+        uint64_t c0 = cycles_now();
+        double t0 = now_ns();
+        for (int i = 0; i < RUNS; i++) {
+            sink = filter_stage_apply(&chain.stage[0], raw[i % SAMPLES]);
+        }
+        double ns = (now_ns() - t0) / RUNS;
+        uint64_t cycles = (cycles_now() - c0) / RUNS;
+#ifdef HAVE_TSC
+        printf("estágio %-10s %4llu ciclos (%.1f ns)/amostra\n", stages[s].name, (unsigned long long)cycles, ns);
+#else
+        (void)cycles;
+        printf("estágio %-10s %.1f ns/amostra\n", stages[s].name, ns);
+#endif
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef BENCH_HOST_H
+#define BENCH_HOST_H
+
+// Medição de tempo dos benchmarks que rodam no PC (tools/bench_*.c).
+// No dispositivo os benchmarks usam lib/bench/bench_cycles.h.
+
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1 // cycles_now conta ciclos de verdade
+#endif
+
+static inline double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Ciclos pelo TSC em x86; 0 nas outras arquiteturas (só ns nesses casos)
+static inline uint64_t cycles_now(void)
+{
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+#endif // BENCH_HOST_H
@@ -0,0 +1,591 @@
+// Benchmark de carga e latência do servidor HTTP da estação.
+//
+// Abre N conexões em paralelo contra a placa (ou o build no PC, host/) e
+// dispara uma mistura ponderada de GET /, GET /system_state,
+// POST /set_limits e POST /set_offsets, reaproveitando cada conexão
+// (keep-alive) ou abrindo uma nova por requisição. Os POSTs reenviam os
+// limites e offsets lidos de /system_state no início: a configuração não
+// muda e a flash não é regravada.
+//
+// Resultado em JSON (stdout ou -o): requisições/s, latência p50/p99/p999 e
+// máxima, taxa de 503 (conexões recusadas pelo pool, o descarte de carga
+// esperado) e taxa de erro (as demais falhas), por rota e no total, e o pool de conexões
+// do servidor (GET /server_stats: high_water é a marca d'água da memória do
+// caminho web, que só usa pools estáticos). Um resumo vai para stderr.
+// Guardar o JSON de cada commit permite comparar regressões.
+//
+//   cc -O2 -o bench_http tools/bench_http.c
+//   ./bench_http -c 8 -d 10 192.168.0.50
+//   ./bench_http -c 32 -d 5 -1 -m root=1,system_state=1 -o carga.json 127.0.0.1:8080
+//
+// Opções:
+//   -c N      conexões simultâneas (padrão 8)
+//   -d S      duração em segundos (padrão 10)
+//   -n N      total de requisições (em vez de -d)
+//   -1        uma conexão por requisição (padrão: keep-alive)
+//   -m MIX    pesos por rota: root, system_state, set_limits, set_offsets
+//             (padrão root=1,system_state=8,set_limits=1,set_offsets=1)
+//   -t MS     timeout de cada requisição (padrão 5000)
+//   -l TEXTO  rótulo gravado no JSON (ex.: o commit)
+//   -o ARQ    arquivo de saída do JSON
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_CONNECTIONS 1024
+#define HEADER_MAX      4096
+
+enum endpoint { EP_ROOT, EP_SYSTEM_STATE, EP_SET_LIMITS, EP_SET_OFFSETS, EP_COUNT };
+
+static const char *const endpoint_names[EP_COUNT] = {"root", "system_state", "set_limits", "set_offsets"};
+
+// Latências (us) e contagens de uma rota
+struct samples {
+    uint32_t *latency_us;
+    size_t count;
+    size_t capacity;
+    uint32_t status_503;
+    uint32_t status_other;   // Outros 4xx/5xx
+    uint32_t failed;         // Sem resposta: conexão recusada, reset, timeout
+};
+
+enum conn_state { CONN_IDLE, CONN_CONNECTING, CONN_SENDING, CONN_RECEIVING };
+
+struct conn {
+    int fd;
+    enum conn_state state;
+    enum endpoint ep;
+    uint64_t start_ns;
+    uint64_t deadline_ns;
+    const char *out;
+    size_t out_len;
+    size_t out_off;
+    char header[HEADER_MAX];
+    size_t header_len;
+    bool in_body;
+    long body_left;          // -1: até o fim da conexão
+    int status;
+    bool server_close;
+};
+
+static struct sockaddr_storage target_addr;
+static socklen_t target_len;
+static char target_name[160];
+
+static struct samples results[EP_COUNT];
+static uint32_t errors_connect, errors_reset, errors_timeout;
+static char requests[EP_COUNT][512];
+static size_t request_len[EP_COUNT];
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void record(struct samples *s, uint32_t latency_us) {
+    if (s->count == s->capacity) {
+        s->capacity = s->capacity ? s->capacity * 2 : 4096;
+        s->latency_us = realloc(s->latency_us, s->capacity * sizeof(*s->latency_us));
+        if (!s->latency_us) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    s->latency_us[s->count++] = latency_us;
+}
+
+static void resolve(const char *spec) {
+    char host[128];
+    const char *port = "80";
+    snprintf(host, sizeof(host), "%s", spec);
+    char *colon = strrchr(host, ':');
+    if (colon) {
+        *colon = '\0';
+        port = colon + 1;
+    }
+    struct addrinfo hints = {.ai_family = AF_INET, .ai_socktype = SOCK_STREAM}, *res;
+    int err = getaddrinfo(host, port, &hints, &res);
+    if (err) {
+        fprintf(stderr, "%s: %s\n", spec, gai_strerror(err));
+        exit(1);
+    }
+    memcpy(&target_addr, res->ai_addr, res->ai_addrlen);
+    target_len = res->ai_addrlen;
+    freeaddrinfo(res);
+    snprintf(target_name, sizeof(target_name), "%s:%s", host, port);
+}
+
+// Requisição bloqueante simples (preparação e /server_stats): corpo em out
+static bool fetch(const char *path, char *out, size_t max) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct timeval tv = {.tv_sec = 5};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (connect(fd, (struct sockaddr *)&target_addr, target_len) < 0) {
+        close(fd);
+        return false;
+    }
+    char req[256];
+    int len = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n", path,
+                       target_name);
+    if (write(fd, req, (size_t)len) != len) {
+        close(fd);
+        return false;
+    }
+    char buf[8192];
+    size_t got = 0;
+    ssize_t n;
+    while (got < sizeof(buf) - 1 && (n = read(fd, buf + got, sizeof(buf) - 1 - got)) > 0) {
+        got += (size_t)n;
+    }
+    close(fd);
+    buf[got] = '\0';
+    char *body = strstr(buf, "\r\n\r\n");
+    if (strncmp(buf, "HTTP/1.1 200", 12) != 0 || !body) {
+        return false;
+    }
+    snprintf(out, max, "%s", body + 4);
+    return true;
+}
+
+// fetch com novas tentativas (50 ms, 100 ms, ... até ~3 s): logo após o fim
+// da carga o pool do servidor ainda está fechando conexões e responde 503
+static bool fetch_retry(const char *path, char *out, size_t max) {
+    for (useconds_t wait_us = 50000; wait_us <= 1600000; wait_us *= 2) {
+        if (fetch(path, out, max)) {
+            return true;
+        }
+        usleep(wait_us);
+    }
+    return fetch(path, out, max);
+}
+
+static double json_number(const char *json, const char *key) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *p = strstr(json, pattern);
+    if (!p) {
+        fprintf(stderr, "/system_state sem o campo %s\n", key);
+        exit(1);
+    }
+    return strtod(p + strlen(pattern), NULL);
+}
+
+static void build_requests(bool keep_alive) {
+    char state[2048];
+    if (!fetch("/system_state", state, sizeof(state))) {
+        fprintf(stderr, "%s: GET /system_state falhou\n", target_name);
+        exit(1);
+    }
+    char limits[256], offsets[128];
+    snprintf(limits, sizeof(limits),
+             "{\"temp_min\":%.2f,\"temp_max\":%.2f,\"humidity_min\":%.2f,\"humidity_max\":%.2f,"
+             "\"pressure_min\":%.2f,\"pressure_max\":%.2f,\"alerts_enabled\":%d}",
+             json_number(state, "temp_min"), json_number(state, "temp_max"), json_number(state, "humidity_min"),
+             json_number(state, "humidity_max"), json_number(state, "pressure_min"),
+             json_number(state, "pressure_max"), (int)json_number(state, "alerts_enabled"));
+    snprintf(offsets, sizeof(offsets), "{\"temp_offset\":%.2f,\"humidity_offset\":%.2f,\"pressure_offset\":%.2f}",
+             json_number(state, "temp_offset"), json_number(state, "humidity_offset"),
+             json_number(state, "pressure_offset"));
+
+    const char *connection = keep_alive ? "keep-alive" : "close";
+    const char *get = "GET %s HTTP/1.1\r\nHost: %s\r\nAccept-Encoding: gzip\r\nConnection: %s\r\n\r\n";
+    const char *post = "POST %s HTTP/1.1\r\nHost: %s\r\nContent-Type: application/json\r\n"
+                       "Content-Length: %zu\r\nConnection: %s\r\n\r\n%s";
+    int n[EP_COUNT];
+    n[EP_ROOT] = snprintf(requests[EP_ROOT], sizeof(requests[0]), get, "/", target_name, connection);
+    n[EP_SYSTEM_STATE] = snprintf(requests[EP_SYSTEM_STATE], sizeof(requests[0]), get, "/system_state",
+                                  target_name, connection);
+    n[EP_SET_LIMITS] = snprintf(requests[EP_SET_LIMITS], sizeof(requests[0]), post, "/set_limits", target_name,
+                                strlen(limits), connection, limits);
+    n[EP_SET_OFFSETS] = snprintf(requests[EP_SET_OFFSETS], sizeof(requests[0]), post, "/set_offsets",
+                                 target_name, strlen(offsets), connection, offsets);
+    for (int i = 0; i < EP_COUNT; i++) {
+        request_len[i] = (size_t)n[i];
+    }
+}
+
+// Mistura: tabela acumulada de pesos e um xorshift (sequência repetível)
+static unsigned weights[EP_COUNT] = {1, 8, 1, 1};
+static unsigned weight_total;
+static uint32_t rng_state = 0x2545F491u;
+
+static void parse_mix(const char *spec) {
+    memset(weights, 0, sizeof(weights));
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", spec);
+    for (char *save, *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(tok, '=');
+        int ep = -1;
+        for (int i = 0; i < EP_COUNT && eq; i++) {
+            if ((size_t)(eq - tok) == strlen(endpoint_names[i]) && strncmp(tok, endpoint_names[i], (size_t)(eq - tok)) == 0) {
+                ep = i;
+            }
+        }
+        if (ep < 0) {
+            fprintf(stderr, "mistura inválida: %s (rotas: root, system_state, set_limits, set_offsets)\n", tok);
+            exit(1);
+        }
+        weights[ep] = (unsigned)atoi(eq + 1);
+    }
+}
+
+static enum endpoint pick_endpoint(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    unsigned r = rng_state % weight_total;
+    for (int i = 0; i < EP_COUNT; i++) {
+        if (r < weights[i]) {
+            return (enum endpoint)i;
+        }
+        r -= weights[i];
+    }
+    return EP_SYSTEM_STATE;
+}
+
+static int epoll_fd;
+
+static void conn_close(struct conn *c) {
+    if (c->fd >= 0) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+        close(c->fd);
+        c->fd = -1;
+    }
+    c->state = CONN_IDLE;
+}
+
+static bool conn_open(struct conn *c) {
+    c->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    int one = 1;
+    setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(c->fd, (struct sockaddr *)&target_addr, target_len) < 0 && errno != EINPROGRESS) {
+        close(c->fd);
+        c->fd = -1;
+        return false;
+    }
+    struct epoll_event ev = {.events = EPOLLOUT | EPOLLIN, .data.ptr = c};
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, c->fd, &ev);
+    c->state = CONN_CONNECTING;
+    return true;
+}
+
+static void conn_watch(struct conn *c, uint32_t events) {
+    struct epoll_event ev = {.events = events, .data.ptr = c};
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+}
+
+// Começa uma requisição; com keep-alive reaproveita a conexão aberta
+static void conn_start(struct conn *c, uint64_t timeout_ns) {
+    c->ep = pick_endpoint();
+    c->start_ns = now_ns();
+    c->deadline_ns = c->start_ns + timeout_ns;
+    c->out = requests[c->ep];
+    c->out_len = request_len[c->ep];
+    c->out_off = 0;
+    c->header_len = 0;
+    c->in_body = false;
+    c->body_left = -1;
+    c->status = 0;
+    c->server_close = false;
+    if (c->fd < 0) {
+        if (!conn_open(c)) {
+            errors_connect++;
+            results[c->ep].failed++;
+        }
+        return;
+    }
+    c->state = CONN_SENDING;
+    conn_watch(c, EPOLLOUT | EPOLLIN);
+}
+
+static void conn_fail(struct conn *c, uint32_t *counter) {
+    (*counter)++;
+    results[c->ep].failed++;
+    conn_close(c);
+}
+
+static void conn_done(struct conn *c, bool keep_alive) {
+    struct samples *s = &results[c->ep];
+    record(s, (uint32_t)((now_ns() - c->start_ns) / 1000u));
+    if (c->status == 503) {
+        s->status_503++;
+    } else if (c->status >= 400) {
+        s->status_other++;
+    }
+    if (!keep_alive || c->server_close) {
+        conn_close(c);
+    } else {
+        c->state = CONN_IDLE;
+    }
+}
+
+static void parse_header(struct conn *c) {
+    c->status = atoi(c->header + 9); // "HTTP/1.1 200"
+    for (char *line = strstr(c->header, "\r\n"); line; line = strstr(line + 2, "\r\n")) {
+        if (strncasecmp(line + 2, "Content-Length:", 15) == 0) {
+            c->body_left = strtol(line + 17, NULL, 10);
+        } else if (strncasecmp(line + 2, "Connection: close", 17) == 0) {
+            c->server_close = true;
+        }
+    }
+}
+
+// Consome bytes da resposta; true quando ela terminou
+static bool consume(struct conn *c, const char *data, size_t len) {
+    size_t i = 0;
+    while (!c->in_body && i < len) {
+        if (c->header_len == HEADER_MAX - 1) {
+            return true; // Cabeçalho grande demais: conta como resposta inválida
+        }
+        c->header[c->header_len++] = data[i++];
+        if (c->header_len >= 4 && memcmp(&c->header[c->header_len - 4], "\r\n\r\n", 4) == 0) {
+            c->header[c->header_len] = '\0';
+            c->in_body = true;
+            parse_header(c);
+        }
+    }
+    if (c->in_body && c->body_left >= 0) {
+        c->body_left -= (long)(len - i);
+        return c->body_left <= 0;
+    }
+    return false;
+}
+
+static void conn_event(struct conn *c, uint32_t events, bool keep_alive) {
+    if (c->state == CONN_CONNECTING) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err) {
+            conn_fail(c, &errors_connect);
+            return;
+        }
+        c->state = CONN_SENDING;
+    }
+    if (c->state == CONN_SENDING && (events & EPOLLOUT)) {
+        ssize_t n = send(c->fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+        if (n < 0 && errno != EAGAIN) {
+            conn_fail(c, &errors_reset);
+            return;
+        }
+        c->out_off += n > 0 ? (size_t)n : 0;
+        if (c->out_off == c->out_len) {
+            c->state = CONN_RECEIVING;
+            conn_watch(c, EPOLLIN);
+        }
+    }
+    if ((c->state == CONN_RECEIVING || c->state == CONN_SENDING) && (events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+        char buf[16384];
+        for (;;) {
+            ssize_t n = recv(c->fd, buf, sizeof(buf), 0);
+            if (n > 0) {
+                if (consume(c, buf, (size_t)n)) {
+                    conn_done(c, keep_alive);
+                    return;
+                }
+                continue;
+            }
+            if (n == 0 && c->in_body && c->body_left < 0) {
+                conn_done(c, false); // Corpo sem Content-Length, até o FIN
+            } else if (n == 0 || errno != EAGAIN) {
+                conn_fail(c, &errors_reset);
+            }
+            return;
+        }
+    }
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Percentil pelo posto mais próximo
+static uint32_t percentile(const uint32_t *sorted, size_t n, double p) {
+    if (!n) {
+        return 0;
+    }
+    size_t rank = (size_t)(p / 100.0 * (double)n + 0.999999);
+    return sorted[rank ? rank - 1 : 0];
+}
+
+// Campos de estatística de um objeto JSON; o último sai sem quebra de linha
+static void print_stats(FILE *out, const struct samples *s, double elapsed_s, const char *indent) {
+    uint32_t *sorted = malloc((s->count ? s->count : 1) * sizeof(*sorted));
+    memcpy(sorted, s->latency_us, s->count * sizeof(*sorted));
+    qsort(sorted, s->count, sizeof(*sorted), compare_u32);
+    double sum = 0;
+    for (size_t i = 0; i < s->count; i++) {
+        sum += sorted[i];
+    }
+    uint64_t attempts = s->count + s->failed;
+    fprintf(out, "%s\"requests\": %zu,\n", indent, s->count);
+    fprintf(out, "%s\"rps\": %.1f,\n", indent, s->count / elapsed_s);
+    fprintf(out, "%s\"latency_us\": {\"mean\": %.0f, \"p50\": %u, \"p99\": %u, \"p999\": %u, \"max\": %u},\n", indent,
+            s->count ? sum / s->count : 0.0, percentile(sorted, s->count, 50), percentile(sorted, s->count, 99),
+            percentile(sorted, s->count, 99.9), s->count ? sorted[s->count - 1] : 0);
+    fprintf(out, "%s\"status_503\": %u,\n", indent, s->status_503);
+    fprintf(out, "%s\"status_error\": %u,\n", indent, s->status_other);
+    fprintf(out, "%s\"failed\": %u,\n", indent, s->failed);
+    fprintf(out, "%s\"rate_503\": %.5f,\n", indent, attempts ? (double)s->status_503 / attempts : 0.0);
+    // 503 fica só em rate_503: é o servidor recusando carga, não uma falha
+    fprintf(out, "%s\"error_rate\": %.5f", indent,
+            attempts ? (double)(s->status_other + s->failed) / attempts : 0.0);
+    free(sorted);
+}
+
+int main(int argc, char **argv) {
+    int connections = 8;
+    double duration_s = 10;
+    long total = 0;
+    bool keep_alive = true;
+    int timeout_ms = 5000;
+    const char *label = "";
+    const char *output = NULL;
+    const char *mix = "root=1,system_state=8,set_limits=1,set_offsets=1";
+    int opt;
+    while ((opt = getopt(argc, argv, "c:d:n:1m:t:l:o:")) != -1) {
+        switch (opt) {
+        case 'c': connections = atoi(optarg); break;
+        case 'd': duration_s = atof(optarg); break;
+        case 'n': total = atol(optarg); break;
+        case '1': keep_alive = false; break;
+        case 'm': mix = optarg; break;
+        case 't': timeout_ms = atoi(optarg); break;
+        case 'l': label = optarg; break;
+        case 'o': output = optarg; break;
+        default:
+            fprintf(stderr, "uso: %s [-c N] [-d S | -n N] [-1] [-m MIX] [-t MS] [-l TEXTO] [-o ARQ] host[:porta]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (connections < 1 || connections > MAX_CONNECTIONS) {
+        fprintf(stderr, "-c: 1 a %d conexões\n", MAX_CONNECTIONS);
+        return 2;
+    }
+    resolve(optind < argc ? argv[optind] : "127.0.0.1:8080");
+    parse_mix(mix);
+    for (int i = 0; i < EP_COUNT; i++) {
+        weight_total += weights[i];
+    }
+    if (!weight_total) {
+        fprintf(stderr, "mistura sem nenhuma rota\n");
+        return 2;
+    }
+    build_requests(keep_alive);
+
+    char stats_before[512] = "null", stats_after[512] = "null";
+    if (!fetch("/server_stats?reset=1", stats_before, sizeof(stats_before))) {
+        snprintf(stats_before, sizeof(stats_before), "null"); // Firmware anterior à rota
+    }
+
+    epoll_fd = epoll_create1(0);
+    static struct conn conns[MAX_CONNECTIONS];
+    uint64_t timeout_ns = (uint64_t)timeout_ms * 1000000u;
+    uint64_t begin = now_ns();
+    uint64_t end = total ? UINT64_MAX : begin + (uint64_t)(duration_s * 1e9);
+    long issued = 0;
+    for (int i = 0; i < connections; i++) {
+        conns[i].fd = -1;
+    }
+
+    for (;;) {
+        uint64_t now = now_ns();
+        bool issuing = now < end && (!total || issued < total);
+        int busy = 0;
+        for (int i = 0; i < connections; i++) {
+            struct conn *c = &conns[i];
+            if (c->state != CONN_IDLE && now > c->deadline_ns) {
+                conn_fail(c, &errors_timeout);
+            }
+            if (c->state == CONN_IDLE && issuing && (!total || issued < total)) {
+                conn_start(c, timeout_ns);
+                issued++;
+            }
+            busy += c->state != CONN_IDLE;
+        }
+        if (!busy && !issuing) {
+            break;
+        }
+        struct epoll_event events[64];
+        int n = epoll_wait(epoll_fd, events, 64, 10);
+        for (int i = 0; i < n; i++) {
+            struct conn *c = events[i].data.ptr;
+            if (c->state != CONN_IDLE) {
+                conn_event(c, events[i].events, keep_alive);
+            }
+        }
+    }
+    double elapsed_s = (now_ns() - begin) / 1e9;
+    for (int i = 0; i < connections; i++) {
+        conn_close(&conns[i]);
+    }
+    if (!fetch_retry("/server_stats", stats_after, sizeof(stats_after))) {
+        snprintf(stats_after, sizeof(stats_after), "null");
+    }
+
+    struct samples all = {0};
+    for (int i = 0; i < EP_COUNT; i++) {
+        for (size_t k = 0; k < results[i].count; k++) {
+            record(&all, results[i].latency_us[k]);
+        }
+        all.status_503 += results[i].status_503;
+        all.status_other += results[i].status_other;
+        all.failed += results[i].failed;
+    }
+
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (!out) {
+        perror(output);
+        return 1;
+    }
+    fprintf(out, "{\n  \"target\": \"%s\",\n  \"label\": \"%s\",\n", target_name, label);
+    fprintf(out, "  \"config\": {\"connections\": %d, \"keep_alive\": %s, \"duration_s\": %.1f, \"requests\": %ld, "
+                 "\"timeout_ms\": %d, \"mix\": {",
+            connections, keep_alive ? "true" : "false", total ? 0.0 : duration_s, total, timeout_ms);
+    for (int i = 0; i < EP_COUNT; i++) {
+        fprintf(out, "%s\"%s\": %u", i ? ", " : "", endpoint_names[i], weights[i]);
+    }
+    fprintf(out, "}},\n  \"elapsed_s\": %.3f,\n", elapsed_s);
+    print_stats(out, &all, elapsed_s, "  ");
+    fprintf(out, ",\n  \"failures\": {\"connect\": %u, \"reset\": %u, \"timeout\": %u},\n", errors_connect,
+            errors_reset, errors_timeout);
+    fprintf(out, "  \"endpoints\": {\n");
+    bool first = true;
+    for (int i = 0; i < EP_COUNT; i++) {
+        if (!weights[i]) {
+            continue;
+        }
+        fprintf(out, "%s    \"%s\": {\n", first ? "" : ",\n", endpoint_names[i]);
+        print_stats(out, &results[i], elapsed_s, "      ");
+        fprintf(out, "\n    }");
+        first = false;
+    }
+    fprintf(out, "\n  },\n  \"server_before\": %s,\n  \"server_after\": %s\n}\n", stats_before, stats_after);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    fprintf(stderr, "%s: %zu requisições em %.1f s = %.1f req/s, %d conexões%s\n", target_name, all.count,
+            elapsed_s, all.count / elapsed_s, connections, keep_alive ? " (keep-alive)" : "");
+    fprintf(stderr, "503: %u, erros HTTP: %u, sem resposta: %u (conexão %u, reset %u, timeout %u)\n",
+            all.status_503, all.status_other, all.failed, errors_connect, errors_reset, errors_timeout);
+    fprintf(stderr, "servidor: antes %s, depois %s\n", stats_before, stats_after);
+    return 0;
+}
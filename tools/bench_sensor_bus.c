@@ -0,0 +1,209 @@
+// Benchmark do escalonador de sensores (lib/sensores/sensor_bus.c) no PC.
+//
+// Simula os dois barramentos I2C a 400 kHz em tempo virtual: cada transação
+// ocupa o barramento por ~9 bits por byte mais o endereço e o STOP, e cada
+// sensor só tem o resultado pronto depois do tempo de conversão. Com 1 a 8
+// sensores (BMP280 em modo forçado e AHT20 alternados entre i2c0 e i2c1, os
+// que não cabem direto no barramento atrás de um TCA9548A) compara a rodada
+// do escalonador com a leitura em série, bloqueante, de um sensor por vez:
+//   - duração da rodada e amostras por segundo
+//   - ocupação dos barramentos (fração da rodada com transação em andamento)
+//
+//   cc -O2 -Ilib/sensores tools/bench_sensor_bus.c lib/sensores/sensor_bus.c -o bench_sensor_bus
+//   ./bench_sensor_bus
+
+#include <stdio.h>
+#include <string.h>
+#include "sensor_bus.h"
+
+#define BIT_US       2.5   // 400 kHz
+#define ROUNDS       200
+
+// Sensor simulado: só o tamanho das transações e o tempo de conversão
+struct sim_model {
+    const char *name;
+    uint8_t addr;
+    uint8_t start_len;
+    uint8_t read_len;        // Bytes lidos (mais 1 escrito: o registrador)
+    uint32_t conversion_us;
+};
+
+static const struct sim_model models[] = {
+    {"BMP280", 0x76, 2, 10, 6400},   // Forçado, x1/x1 (ultra low power)
+    {"AHT20", 0x38, 3, 6, 80000},
+};
+
+static uint32_t xfer_us(uint8_t bytes)
+{
+    return (uint32_t)((1 + bytes) * 9 * BIT_US + 2 * BIT_US); // Endereço, dados, START/STOP
+}
+
+static const struct sim_model *model_of(const struct sensor *s)
+{
+    return &models[s->addr == models[1].addr ? 1 : 0];
+}
+
+static bool sim_init(struct sensor *s)
+{
+    (void)s;
+    return true;
+}
+
+static uint32_t sim_start(struct sensor *s, struct sensor_xfer *x)
+{
+    const struct sim_model *m = model_of(s);
+    x->tx_len = m->start_len;
+    return m->conversion_us;
+}
+
+static void sim_collect(struct sensor *s, struct sensor_xfer *x)
+{
+    x->tx_len = 1;
+    x->rx_len = model_of(s)->read_len;
+}
+
+static int32_t sim_compensate(struct sensor *s, int32_t *value)
+{
+    (void)s;
+    value[0] = 2500;
+    return 0;
+}
+
+static const struct sensor_driver sim_driver = {
+    .name = "sim",
+    .channels = 1,
+    .quantity = {SENSOR_TEMPERATURE},
+    .init = sim_init,
+    .start = sim_start,
+    .collect = sim_collect,
+    .compensate = sim_compensate,
+};
+
+// Barramentos simulados: a transação termina em done_us
+static uint64_t now_us;
+static uint64_t done_us[SENSOR_BUSES];
+static bool busy[SENSOR_BUSES];
+static uint64_t busy_us[SENSOR_BUSES];
+
+static bool sim_submit(void *ctx, uint8_t bus, uint8_t addr, const uint8_t *tx, uint8_t tx_len,
+                       uint8_t *rx, uint8_t rx_len)
+{
+    (void)ctx, (void)addr, (void)tx, (void)rx;
+    uint32_t us = xfer_us(tx_len + rx_len) + (tx_len && rx_len ? 10 * BIT_US : 0); // Repeated start
+    busy[bus] = true;
+    done_us[bus] = now_us + us;
+    busy_us[bus] += us;
+    return true;
+}
+
+static bool sim_write_blocking(void *ctx, uint8_t bus, uint8_t addr, const uint8_t *data, uint8_t len)
+{
+    (void)ctx, (void)bus, (void)addr, (void)data, (void)len;
+    return true;
+}
+
+static const struct sensor_bus_ops sim_ops = {
+    .submit = sim_submit,
+    .write_blocking = sim_write_blocking,
+};
+
+// i-ésimo sensor: tipos alternados, barramentos alternados a cada par. Até
+// onde os endereços do tipo bastam (BMP280: 0x76 e 0x77, AHT20: só 0x38) os
+// sensores ficam direto no barramento; passando disso, todos os daquele tipo
+// e barramento vão para canais do mux.
+static void make_sensors(struct sensor *sensors, int n)
+{
+    static const int addresses[2] = {2, 1};
+    int count[SENSOR_BUSES][2] = {{0}};
+    for (int i = 0; i < n; i++) {
+        count[(i / 2) % SENSOR_BUSES][i % 2]++;
+    }
+    int seen[SENSOR_BUSES][2] = {{0}};
+    for (int i = 0; i < n; i++) {
+        int type = i % 2;
+        uint8_t bus = (i / 2) % SENSOR_BUSES;
+        int k = seen[bus][type]++;
+        bool muxed = count[bus][type] > addresses[type];
+        sensors[i] = (struct sensor){
+            .driver = &sim_driver,
+            .label = models[type].name,
+            .bus = bus,
+            .addr = (uint8_t)(models[type].addr + (muxed ? 0 : k)),
+            .mux_addr = muxed ? TCA9548A_ADDR : 0,
+            .mux_channel = (uint8_t)(muxed ? k : 0),
+        };
+    }
+}
+
+static double serial_round_us(const struct sensor *sensors, int n)
+{
+    double us = 0;
+    uint8_t open_channel[SENSOR_BUSES] = {0}; // Canal + 1 (0: nenhum)
+    for (int i = 0; i < n; i++) {
+        const struct sim_model *m = model_of(&sensors[i]);
+        if (sensors[i].mux_addr && open_channel[sensors[i].bus] != sensors[i].mux_channel + 1) {
+            us += xfer_us(1);
+            open_channel[sensors[i].bus] = sensors[i].mux_channel + 1;
+        }
+        us += xfer_us(m->start_len) + m->conversion_us + xfer_us(1 + m->read_len) + 10 * BIT_US;
+    }
+    return us;
+}
+
+static double scheduled_round_us(struct sensor *sensors, int n, double *occupancy)
+{
+    static struct sensor_bus b;
+    sensor_bus_init(&b, &sim_ops, NULL);
+    for (int i = 0; i < n; i++) {
+        sensor_bus_add(&b, &sensors[i]);
+    }
+    now_us = 0;
+    memset(busy_us, 0, sizeof(busy_us));
+    for (int r = 0; r < ROUNDS; r++) {
+        sensor_bus_start_round(&b, now_us);
+        for (;;) {
+            uint64_t deadline = sensor_bus_poll(&b, now_us);
+            if (!sensor_bus_running(&b)) {
+                break;
+            }
+            uint64_t next = deadline;
+            for (int bus = 0; bus < SENSOR_BUSES; bus++) {
+                if (busy[bus] && done_us[bus] < next) {
+                    next = done_us[bus];
+                }
+            }
+            now_us = next;
+            for (int bus = 0; bus < SENSOR_BUSES; bus++) {
+                if (busy[bus] && done_us[bus] <= now_us) {
+                    busy[bus] = false;
+                    sensor_bus_xfer_done(&b, bus, true);
+                }
+            }
+        }
+    }
+    uint32_t samples = 0;
+    for (int i = 0; i < n; i++) {
+        samples += sensors[i].samples;
+    }
+    if (samples != (uint32_t)(n * ROUNDS)) {
+        printf("amostras perdidas: %u de %d\n", samples, n * ROUNDS);
+    }
+    *occupancy = (double)(busy_us[0] + busy_us[1]) / (SENSOR_BUSES * (double)now_us);
+    return (double)now_us / ROUNDS;
+}
+
+int main(void)
+{
+    printf("%-8s %14s %14s %14s %14s %10s\n", "sensores", "série (ms)", "amostras/s", "escalonado (ms)",
+           "amostras/s", "ocupação");
+    for (int n = 1; n <= SENSOR_MAX; n++) {
+        struct sensor sensors[SENSOR_MAX];
+        make_sensors(sensors, n);
+        double serial = serial_round_us(sensors, n);
+        double occupancy;
+        double scheduled = scheduled_round_us(sensors, n, &occupancy);
+        printf("%-8d %14.2f %14.1f %14.2f %14.1f %9.1f %%\n", n, serial / 1000, n * 1e6 / serial,
+               scheduled / 1000, n * 1e6 / scheduled, occupancy * 100);
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+// Benchmark do log em flash (lib/tslog) no PC, com a flash simulada em RAM.
+//
+// Gera semanas de amostras sintéticas a cada 10 s (ciclo diário de
+// temperatura/umidade, pressão com frente de alguns dias e ruído de sensor),
+// grava pelo mesmo código do firmware e mede:
+//   - bytes de flash por amostra (contra os 16 bytes de struct history_sample)
+//   - tempo de gravação por amostra
+//   - consultas por intervalo: busca binária nos cabeçalhos x varredura linear
+// Também confere que tudo que foi gravado volta igual e que tslog_init
+// reencontra o fim do log depois de um "reinício".
+//
+//   cc -O2 -Ilib tools/bench_tslog.c lib/tslog/tslog.c -lm -o bench_tslog
+//   ./bench_tslog [semanas]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tslog/tslog.h"
+#include "bench_host.h"
+
+#define REGION_SIZE  (512 * 1024) // Mesmo tamanho de TSLOG_FLASH_SIZE
+#define INTERVAL_S   10
+#define WEEK_S       (7 * 24 * 3600)
+#define START_TIME   1735689600u  // 2025-01-01 00:00 UTC
+
+static uint8_t region[REGION_SIZE];
+static unsigned erases, programs;
+
+static bool ram_erase(uint32_t offset)
+{
+    memset(region + offset, 0xFF, TSLOG_SECTOR_SIZE);
+    erases++;
+    return true;
+}
+
+static bool ram_program(uint32_t offset, const uint8_t *page)
+{
+    for (int i = 0; i < TSLOG_PAGE_SIZE; i++) {
+        region[offset + i] &= page[i]; // Como a flash NOR: só zera bits
+    }
+    programs++;
+    return true;
+}
+
+static const struct tslog_flash ram_flash = {region, REGION_SIZE, ram_erase, ram_program};
+
+static uint32_t rng_state = 12345;
+static int noise(int amplitude)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (int)(rng_state % (2 * amplitude + 1)) - amplitude;
+}
+
+static void synth(uint32_t t, struct tslog_record *r)
+{
+    double day = 2 * M_PI * (t % 86400) / 86400.0;
+    double front = 2 * M_PI * (t % (3 * 86400)) / (3 * 86400.0);
+    r->time = t;
+    r->value[0] = (int32_t)lround(2400 + 400 * sin(day)) + noise(2);  // 0,01 °C
+    r->value[1] = (int32_t)lround(6000 - 1500 * sin(day)) + noise(5); // 0,01 %
+    r->value[2] = (int32_t)lround(2450 + 380 * sin(day)) + noise(2);  // 0,01 °C
+    r->value[3] = (int32_t)lround(100800 + 300 * sin(front)) + noise(3); // Pa
+}
+
+struct check {
+    uint32_t count;
+    uint32_t expected_time;
+    bool ok;
+};
+
+static void check_record(const struct tslog_record *r, void *ctx)
+{
+    struct check *c = ctx;
+    if (r->time != c->expected_time) {
+        c->ok = false;
+    }
+    c->expected_time += INTERVAL_S;
+    c->count++;
+}
+
+static void count_record(const struct tslog_record *r, void *ctx)
+{
+    (void)r;
+    (*(uint32_t *)ctx)++;
+}
+
+// Referência sem índice: descomprime do bloco mais antigo em diante
+static uint32_t linear_query(const struct tslog *log, uint32_t from, uint32_t to)
+{
+    static struct tslog_record records[TSLOG_MAX_PER_BLOCK];
+    uint32_t total = 0;
+    for (uint32_t seq = tslog_oldest_seq(log); seq <= tslog_newest_seq(log); seq++) {
+        const uint8_t *page = tslog_block(log, seq);
+        if (!page) {
+            continue;
+        }
+        int n = tslog_decode_block(page, records, TSLOG_MAX_PER_BLOCK);
+        for (int i = 0; i < n; i++) {
+            if (records[i].time > to) {
+                return total;
+            }
+            total += records[i].time >= from;
+        }
+    }
+    return total;
+}
+
+int main(int argc, char **argv)
+{
+    int weeks = argc > 1 ? atoi(argv[1]) : 1;
+    uint32_t samples = (uint32_t)weeks * WEEK_S / INTERVAL_S;
+    static struct tslog log;
+
+    memset(region, 0xFF, sizeof(region));
+    tslog_init(&log, &ram_flash);
+
+    // Gravação, guardando os valores gerados para a verificação
+    struct tslog_record *expected = malloc(samples * sizeof(*expected));
+    double t0 = now_ns();
+    for (uint32_t i = 0; i < samples; i++) {
+        synth(START_TIME + i * INTERVAL_S, &expected[i]);
+        tslog_append(&log, &expected[i]);
+    }
+    double append_ns = (now_ns() - t0) / samples;
+    tslog_flush(&log);
+
+    uint32_t blocks = tslog_newest_seq(&log) - tslog_oldest_seq(&log) + 1;
+    uint32_t kept = samples;
+    if (tslog_newest_seq(&log) > blocks) {
+        kept = 0; // Anel deu a volta: conta o que restou
+        tslog_query(&log, 0, UINT32_MAX, count_record, &kept);
+    }
+    printf("amostras: %u (%d semana(s), 1 a cada %d s), mantidas: %u\n", samples, weeks, INTERVAL_S, kept);
+    printf("blocos: %u gravados, %u na flash (%u KB de %u KB)\n",
+           tslog_newest_seq(&log), blocks, blocks * TSLOG_PAGE_SIZE / 1024, REGION_SIZE / 1024);
+    printf("bytes/amostra: %.2f (history_sample: 16, registro bruto: %zu)\n",
+           (double)blocks * TSLOG_PAGE_SIZE / kept, sizeof(struct tslog_record));
+    printf("apagamentos de setor: %u, gravações de página: %u\n", erases, programs);
+    printf("gravação: %.0f ns/amostra\n", append_ns);
+
+    // Tudo volta igual, na ordem
+    uint32_t first_kept = samples - kept;
+    struct check c = {0, expected[first_kept].time, true};
+    tslog_query(&log, 0, UINT32_MAX, check_record, &c);
+    bool values_ok = true;
+    for (uint32_t seq = tslog_oldest_seq(&log), i = first_kept; seq <= tslog_newest_seq(&log); seq++) {
+        static struct tslog_record records[TSLOG_MAX_PER_BLOCK];
+        int n = tslog_decode_block(tslog_block(&log, seq), records, TSLOG_MAX_PER_BLOCK);
+        for (int k = 0; k < n; k++, i++) {
+            values_ok &= memcmp(&records[k], &expected[i], sizeof(records[k])) == 0;
+        }
+    }
+    printf("verificação: %s (%u amostras)\n", c.ok && values_ok && c.count == kept ? "ok" : "FALHOU", c.count);
+
+    // Reinício: a varredura reencontra o último bloco e o último horário
+    static struct tslog reopened;
+    tslog_init(&reopened, &ram_flash);
+    printf("reinício: último bloco %u, último horário %s\n", tslog_newest_seq(&reopened),
+           tslog_last_time(&reopened) == expected[samples - 1].time ? "ok" : "FALHOU");
+
+    // Consultas por intervalo dentro da última semana
+    static const struct { const char *name; uint32_t span; } ranges[] = {
+        {"1 hora", 3600}, {"1 dia", 86400}, {"1 semana", WEEK_S},
+    };
+    uint32_t window_end = expected[samples - 1].time;
+    uint32_t window_start = window_end - WEEK_S + 1;
+    for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        const int runs = 200;
+        uint32_t span = ranges[r].span;
+        double indexed = 0, linear = 0;
+        uint32_t mismatches = 0, ref = 0;
+        rng_state = 777;
+        for (int i = 0; i < runs; i++) {
+            uint32_t from = window_start + (span < WEEK_S ? (uint32_t)(noise(1 << 30) & 0x7FFFFFFF) % (WEEK_S - span) : 0);
+            uint32_t to = from + span - 1;
+            uint32_t n = 0;
+            double s = now_ns();
+            tslog_query(&log, from, to, count_record, &n);
+            indexed += now_ns() - s;
+            s = now_ns();
+            ref = linear_query(&log, from, to);
+            linear += now_ns() - s;
+            mismatches += n != ref;
+        }
+        printf("consulta %-8s: %8.1f us com índice, %8.1f us varrendo (%u amostras, %s)\n",
+               ranges[r].name, indexed / runs / 1000, linear / runs / 1000, ref,
+               mismatches ? "DIVERGE" : "iguais");
+    }
+
+    free(expected);
+    return 0;
+}
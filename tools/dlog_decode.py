@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Decodifica o log cru da estação (firmware com -DESTACAO_LOG_BINARY=ON).
+
+Com o log binário a placa não formata nada: cada mensagem sai no serial como
+uma linha "#dlog <hex>" com o endereço da string de formato, o tempo, o
+nível e os argumentos crus (formato em lib/log/dlog.c). Este script procura
+as strings no .elf do mesmo build e formata como o printf faria. Linhas
+comuns (printf do boot) passam como estão.
+
+Uso: dlog_decode.py build/meteriologicaInterfaceWeb.elf [/dev/ttyACM0 | captura.txt]
+     (sem o segundo argumento lê da entrada padrão)
+"""
+import argparse
+import re
+import struct
+import sys
+
+LEVELS = {1: 'E', 2: 'W', 3: 'I', 4: 'D'}
+SPEC = re.compile(r'%([-+ #0]*[0-9]*(?:\.[0-9]+)?)(hh|h|ll|l|z|j|t|L)?([diouxXcspfFeEgG%])')
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+
+class Elf:
+    """Seções alocadas do ELF (32 ou 64 bits, little-endian): endereço -> bytes."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[5] != 1:
+            sys.exit('%s: não é um ELF little-endian' % path)
+        if self.data[4] == 1:
+            shoff, = struct.unpack_from('<I', self.data, 0x20)
+            shentsize, shnum = struct.unpack_from('<HH', self.data, 0x2E)
+            fmt = '<IIIIII'
+        else:
+            shoff, = struct.unpack_from('<Q', self.data, 0x28)
+            shentsize, shnum = struct.unpack_from('<HH', self.data, 0x3A)
+            fmt = '<IIQQQQ'
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from(fmt, self.data, shoff + i * shentsize)
+            if flags & SHF_ALLOC and sh_type != SHT_NOBITS and addr:
+                self.sections.append((addr, offset, size))
+
+    def string(self, addr):
+        for base, offset, size in self.sections:
+            if base <= addr < base + size:
+                start = offset + addr - base
+                end = self.data.index(b'\0', start, offset + size)
+                return self.data[start:end].decode('utf-8', 'replace')
+        return None
+
+
+def to_float(word):
+    return struct.unpack('<f', struct.pack('<I', word))[0]
+
+
+def to_int(word):
+    return word - (1 << 32) if word & 0x80000000 else word
+
+
+def format_message(elf, fmt, args):
+    args = list(args)
+
+    def convert(m):
+        flags, _, conv = m.groups()
+        if conv == '%':
+            return '%'
+        if not args:
+            return '<?>'
+        word = args.pop(0)
+        if conv in 'di':
+            return ('%' + flags + 'd') % to_int(word)
+        if conv in 'fFeEgG':
+            return ('%' + flags + conv) % to_float(word)
+        if conv == 's':
+            text = elf.string(word)
+            return ('%' + flags + 's') % (text if text is not None else '<0x%08x>' % word)
+        if conv == 'p':
+            return '0x%08x' % word
+        if conv == 'c':
+            return chr(word & 0xFF)
+        return ('%' + flags + conv) % word  # u, o, x, X
+
+    return SPEC.sub(convert, fmt)
+
+
+def decode_line(elf, line):
+    raw = bytes.fromhex(line[len('#dlog '):].strip())
+    if len(raw) < 12 or len(raw) % 4:
+        return line
+    fmt_addr, time_us, meta = struct.unpack_from('<III', raw)
+    level, argc = meta & 0xFF, (meta >> 8) & 0xFF
+    args = struct.unpack_from('<%dI' % argc, raw, 12) if len(raw) >= 12 + 4 * argc else ()
+    fmt = elf.string(fmt_addr)
+    if fmt is None:
+        return '[%10.6f] %s <formato 0x%08x fora do ELF: build diferente?>\n' % (
+            time_us / 1e6, LEVELS.get(level, '?'), fmt_addr)
+    return '[%10.6f] %s %s' % (time_us / 1e6, LEVELS.get(level, '?'), format_message(elf, fmt, args))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('elf', help='ELF do firmware que gerou o log')
+    parser.add_argument('input', nargs='?', help='porta serial ou captura (padrão: stdin)')
+    args = parser.parse_args()
+    elf = Elf(args.elf)
+    source = open(args.input, 'r', errors='replace') if args.input else sys.stdin
+    for line in source:
+        line = line.rstrip('\r\n') + '\n'
+        if line.startswith('#dlog '):
+            try:
+                line = decode_line(elf, line)
+            except ValueError:
+                pass  # Linha cortada no meio: vai como chegou
+        sys.stdout.write(line)
+        sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main()
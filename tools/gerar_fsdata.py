@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Gera a imagem de arquivos web para o fs do lwIP (fs.c).
+
+Cada arquivo é comprimido com gzip e gravado com a resposta HTTP 200
+completa já embutida (FS_FILE_FLAGS_HEADER_INCLUDED), incluindo
+Content-Encoding, ETag forte e Cache-Control. Para cada arquivo também é
+gerada a resposta 304 correspondente, usada quando o If-None-Match do
+navegador coincide com o ETag. Só existe a versão gzip: clientes sem gzip
+no Accept-Encoding recebem 406 (web_assets.c), daí o Vary nas duas.
+
+Uso: gerar_fsdata.py <saida.c> /url=arquivo [/url=arquivo ...]
+"""
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+CONTENT_TYPES = {
+    '.html': 'text/html; charset=utf-8',
+    '.js': 'application/javascript; charset=utf-8',
+    '.css': 'text/css; charset=utf-8',
+    '.json': 'application/json',
+    '.ico': 'image/x-icon',
+    '.svg': 'image/svg+xml',
+}
+
+# Arquivos do projeto são revalidados a cada acesso (um 304 custa poucos
+# bytes); bibliotecas de terceiros em /vendor/ mudam só com a versão fixada
+# em cmake/web_fsdata.cmake e podem ficar em cache por uma semana.
+CACHE_PROJETO = 'no-cache'
+CACHE_VENDOR = 'public, max-age=604800'
+
+
+def c_ident(url):
+    return 'web' + re.sub(r'[^A-Za-z0-9]', '_', url)
+
+
+def c_bytes(data):
+    linhas = []
+    for i in range(0, len(data), 16):
+        linhas.append(''.join('0x%02x,' % b for b in data[i:i + 16]))
+    return '\n'.join(linhas)
+
+
+def c_string(text):
+    return '"' + text.replace('\\', '\\\\').replace('"', '\\"').replace('\r', '\\r').replace('\n', '\\n') + '"'
+
+
+def main(argv):
+    if len(argv) < 3:
+        sys.stderr.write(__doc__)
+        return 1
+    saida = argv[1]
+    arquivos = []
+    for par in argv[2:]:
+        url, caminho = par.split('=', 1)
+        with open(caminho, 'rb') as f:
+            bruto = f.read()
+        # mtime=0 torna a saída (e o ETag) reprodutível entre builds
+        comprimido = gzip.compress(bruto, compresslevel=9, mtime=0)
+        ext = os.path.splitext(caminho)[1].lower()
+        etag = '"%s"' % hashlib.sha256(comprimido).hexdigest()[:16]
+        cache = CACHE_VENDOR if url.startswith('/vendor/') else CACHE_PROJETO
+        cabecalho = ('HTTP/1.1 200 OK\r\n'
+                     'Content-Type: %s\r\n'
+                     'Content-Encoding: gzip\r\n'
+                     'Content-Length: %d\r\n'
+                     'ETag: %s\r\n'
+                     'Cache-Control: %s\r\n'
+                     'Vary: Accept-Encoding\r\n'
+                     '\r\n') % (CONTENT_TYPES.get(ext, 'application/octet-stream'),
+                                len(comprimido), etag, cache)
+        nao_modificado = ('HTTP/1.1 304 Not Modified\r\n'
+                          'ETag: %s\r\n'
+                          'Cache-Control: %s\r\n'
+                          'Vary: Accept-Encoding\r\n'
+                          '\r\n') % (etag, cache)
+        arquivos.append((url, cabecalho.encode('ascii') + comprimido, etag, nao_modificado,
+                         len(bruto), len(comprimido)))
+
+    with open(saida, 'w') as out:
+        out.write('// Gerado por tools/gerar_fsdata.py - não editar\n')
+        out.write('#include "lwip/apps/fs.h"\n#include "lwip/def.h"\n#include "http/web_assets.h"\n\n')
+        out.write('#define file_NULL (struct fsdata_file *) NULL\n\n')
+        anterior = 'file_NULL'
+        for url, dados, etag, _, bruto, comprimido in arquivos:
+            ident = c_ident(url)
+            out.write('// %s: %d bytes -> %d bytes (gzip)\n' % (url, bruto, comprimido))
+            out.write('static const unsigned char data_%s[] = {\n%s\n};\n\n' % (ident, c_bytes(dados)))
+            out.write('const struct fsdata_file file_%s[] = { {\n' % ident)
+            out.write('    %s,\n    (const unsigned char *)%s,\n    data_%s,\n    sizeof(data_%s),\n'
+                      % (anterior, c_string(url), ident, ident))
+            out.write('    FS_FILE_FLAGS_HEADER_INCLUDED | FS_FILE_FLAGS_HEADER_PERSISTENT | FS_FILE_FLAGS_HEADER_HTTPVER_1_1,\n} };\n\n')
+            anterior = 'file_%s' % ident
+        out.write('#define FS_ROOT %s\n#define FS_NUMFILES %d\n\n' % (anterior, len(arquivos)))
+
+        out.write('// Metadados para respostas condicionais (If-None-Match -> 304)\n')
+        out.write('const struct web_asset web_assets[] = {\n')
+        for url, _, etag, nao_modificado, _, _ in arquivos:
+            out.write('    { %s, %s, %s, %d },\n' % (c_string(url), c_string(etag), c_string(nao_modificado),
+                                                    len(nao_modificado)))
+        out.write('};\n')
+        out.write('const u16_t web_assets_count = %d;\n' % len(arquivos))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Baixa o rastro da estação (GET /trace) e o converte em JSON do Chrome trace.
+
+O firmware precisa ser compilado com -DESTACAO_TRACE=ON. A resposta traz a
+tabela de eventos e os registros binários dos dois núcleos (formato descrito
+em lib/trace/trace.c); o JSON abre em chrome://tracing ou em
+https://ui.perfetto.dev, com uma linha por núcleo e as leituras I2C (eventos
+assíncronos) em faixas próprias.
+
+Uso: trace_dump.py <ip> [-o rastro.json]
+     trace_dump.py --file rastro.bin [-o rastro.json]   (resposta salva de /trace)
+"""
+import argparse
+import json
+import struct
+import sys
+import urllib.request
+
+MAGIC = b'TRC1'
+HEADER = struct.Struct('<4sHBBII')
+RECORD = struct.Struct('<QBBBxI')
+KIND_SPAN, KIND_ASYNC = 0, 1
+PHASE_BEGIN, PHASE_END = 0, 1
+CORE_NAMES = ('nucleo 0 (rede)', 'nucleo 1 (sensores)')
+
+
+def parse(data):
+    if len(data) < HEADER.size:
+        sys.exit('resposta curta demais')
+    magic, record_size, events, cores, count, names_len = HEADER.unpack_from(data)
+    if magic != MAGIC or record_size != RECORD.size:
+        sys.exit('formato desconhecido (firmware com ESTACAO_TRACE?)')
+    table = data[HEADER.size:HEADER.size + names_len]
+    info = []
+    pos = 0
+    while pos < len(table) and len(info) < events:
+        kind = table[pos]
+        end = table.index(b'\0', pos + 1)
+        info.append((table[pos + 1:end].decode('ascii'), kind))
+        pos = end + 1
+    while len(info) < events:
+        info.append(('evento_%d' % len(info), KIND_SPAN))
+    start = HEADER.size + names_len
+    records = [RECORD.unpack_from(data, start + i * RECORD.size) for i in range(count)
+               if start + (i + 1) * RECORD.size <= len(data)]
+    return info, cores, records
+
+
+def convert(info, cores, records):
+    out = [{'ph': 'M', 'pid': 1, 'name': 'process_name', 'args': {'name': 'estacao'}}]
+    for core in range(cores):
+        name = CORE_NAMES[core] if core < len(CORE_NAMES) else 'nucleo %d' % core
+        out.append({'ph': 'M', 'pid': 1, 'tid': core, 'name': 'thread_name', 'args': {'name': name}})
+
+    # Os anéis guardam só os últimos registros: um fim cujo início ficou de
+    # fora é descartado, e uma leitura que falhou (início sem fim) é fechada
+    # no início seguinte do mesmo sensor
+    stacks = {core: [] for core in range(cores)}
+    open_async = {}
+    records.sort(key=lambda r: (r[0], r[3]))
+    for time_us, event, phase, core, arg in records:
+        name, kind = info[event] if event < len(info) else ('evento_%d' % event, KIND_SPAN)
+        base = {'pid': 1, 'tid': core, 'ts': time_us, 'name': name, 'args': {'arg': arg}}
+        if kind == KIND_ASYNC:
+            key = (event, arg)
+            base.update(cat=name, id='0x%08x' % arg)
+            if phase == PHASE_BEGIN:
+                if key in open_async:
+                    out.append(dict(base, ph='e', args={'incompleta': True}))
+                open_async[key] = True
+                out.append(dict(base, ph='b'))
+            elif open_async.pop(key, None):
+                out.append(dict(base, ph='e'))
+            continue
+        stack = stacks.setdefault(core, [])
+        if phase == PHASE_BEGIN:
+            stack.append(event)
+            out.append(dict(base, ph='B'))
+        elif event in stack:
+            while stack and stack[-1] != event:
+                stack.pop()  # Fim perdido de um evento aninhado
+            stack.pop()
+            out.append(dict(base, ph='E'))
+    return {'traceEvents': out, 'displayTimeUnit': 'ms'}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('ip', nargs='?')
+    parser.add_argument('--file', help='resposta de /trace salva em arquivo')
+    parser.add_argument('-o', '--output', help='arquivo JSON de saída (padrão: stdout)')
+    args = parser.parse_args()
+    if args.file:
+        with open(args.file, 'rb') as f:
+            data = f.read()
+    elif args.ip:
+        with urllib.request.urlopen('http://%s/trace' % args.ip, timeout=10) as r:
+            data = r.read()
+    else:
+        parser.error('informe o ip ou --file')
+
+    info, cores, records = parse(data)
+    trace = convert(info, cores, records)
+    text = json.dumps(trace, separators=(',', ':'))
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+        print('%d registros, %d eventos -> %s' % (len(records), len(trace['traceEvents']), args.output),
+              file=sys.stderr)
+    else:
+        print(text)
+
+
+if __name__ == '__main__':
+    main()
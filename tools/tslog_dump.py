@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Baixa o log em flash da estação (GET /log) e imprime as amostras em CSV.
+
+O dispositivo envia os blocos comprimidos como estão gravados (páginas de
+256 bytes, formato descrito em lib/tslog/tslog.c); este script confere o
+CRC de cada bloco, descomprime e filtra o intervalo pedido.
+
+Uso: tslog_dump.py <ip> [--from AAAA-MM-DDTHH:MM] [--to AAAA-MM-DDTHH:MM]
+     tslog_dump.py --file blocos.bin     (resposta salva de /log)
+"""
+import argparse
+import struct
+import sys
+import urllib.request
+from datetime import datetime, timezone
+
+PAGE_SIZE = 256
+HEADER_SIZE = 16
+MAGIC = 0x4C54
+CHANNELS = ('temp_aht', 'umid_aht', 'temp_bmp', 'pressao_pa')
+SCALE = (100, 100, 100, 1)
+WIDTH = (0, 4, 8, 16, 32)
+UNIX_2020 = 1577836800  # Antes disso o relógio ainda não tinha passado pelo SNTP
+
+
+def crc16(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def unzigzag(z):
+    return (z >> 1) ^ -(z & 1)
+
+
+def to_i32(v):
+    v &= 0xFFFFFFFF
+    return v - (1 << 32) if v & 0x80000000 else v
+
+
+class Bits:
+    def __init__(self, payload, nbits):
+        self.payload = payload
+        self.nbits = nbits
+        self.pos = 0
+
+    def get(self, n):
+        if self.pos + n > self.nbits:
+            raise ValueError('bloco truncado')
+        v = 0
+        for _ in range(n):
+            v = (v << 1) | ((self.payload[self.pos >> 3] >> (7 - (self.pos & 7))) & 1)
+            self.pos += 1
+        return v
+
+    def code(self):
+        prefix = 0
+        while prefix < 4 and self.get(1):
+            prefix += 1
+        return self.get(WIDTH[prefix]) if prefix else 0
+
+
+def decode_block(page):
+    magic, count, seq, t0, crc, nbits = struct.unpack_from('<HHIIHH', page)
+    if magic != MAGIC or crc != crc16(page[14:], crc16(page[:12])):
+        return None, []
+    bits = Bits(page[HEADER_SIZE:], nbits)
+    time, delta = t0, 0
+    values = [0] * len(CHANNELS)
+    records = []
+    for _ in range(count):
+        delta = to_i32(delta + unzigzag(bits.code()))
+        time = (time + delta) & 0xFFFFFFFF
+        for c in range(len(CHANNELS)):
+            values[c] = to_i32(values[c] + unzigzag(bits.code()))
+        records.append((time, list(values)))
+    return seq, records
+
+
+def parse_time(text):
+    return int(datetime.fromisoformat(text).replace(tzinfo=timezone.utc).timestamp())
+
+
+def format_time(t):
+    if t < UNIX_2020:
+        return str(t)
+    return datetime.fromtimestamp(t, timezone.utc).strftime('%Y-%m-%dT%H:%M:%SZ')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('ip', nargs='?')
+    parser.add_argument('--from', dest='start', type=parse_time, default=0)
+    parser.add_argument('--to', dest='end', type=parse_time, default=0xFFFFFFFF)
+    parser.add_argument('--file')
+    args = parser.parse_args()
+
+    if args.file:
+        with open(args.file, 'rb') as f:
+            data = f.read()
+    elif args.ip:
+        url = 'http://%s/log?from=%d&to=%d' % (args.ip, args.start, args.end)
+        with urllib.request.urlopen(url, timeout=30) as response:
+            data = response.read()
+    else:
+        parser.error('informe o IP da estação ou --file')
+
+    print('horario,' + ','.join(CHANNELS))
+    bad = 0
+    for offset in range(0, len(data) - PAGE_SIZE + 1, PAGE_SIZE):
+        seq, records = decode_block(data[offset:offset + PAGE_SIZE])
+        if seq is None:
+            bad += 1
+            continue
+        for time, values in records:
+            if args.start <= time <= args.end:
+                fields = [('%.2f' % (v / s)) if s != 1 else str(v) for v, s in zip(values, SCALE)]
+                print(format_time(time) + ',' + ','.join(fields))
+    if bad:
+        print('%d bloco(s) corrompido(s) ignorado(s)' % bad, file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,201 @@
+// Página de gráficos: histórico inicial de /history, amostras empurradas por
+// /events (SSE) e ajuste de offsets
+const state = {
+    tempAHTHistory: [], humidityAHTHistory: [], tempBMPHistory: [], pressureBMPHistory: [], labels: [],
+    tempAHTChart: null, humidityAHTChart: null, tempBMPChart: null, pressureBMPChart: null,
+    lastSeq: 0,            // Última amostra já desenhada (cursor de /history)
+    loadingHistory: false
+};
+const MAX_HISTORY_POINTS = 300;
+const HISTORY_RECORD_SIZE = 16; // struct history_sample (lib/history/history.h)
+const offsetInputs = {
+    temp: document.getElementById('tempOffsetInput'),
+    humidity: document.getElementById('humidityOffsetInput'),
+    pressure: document.getElementById('pressureOffsetInput')
+};
+const offsetStatusMsg = document.getElementById('offsetStatusMsg');
+let isOffsetInputFocused = false;
+
+function createChart(canvasId, label, unit) {
+    const ctx = document.getElementById(canvasId).getContext('2d');
+    return new Chart(ctx, {
+        type: 'line',
+        data: { labels: state.labels, datasets: [{ label: label, data: [], borderColor: '#1abc9c', backgroundColor: 'rgba(26,188,156,0.2)', borderWidth: 1, fill: true }] },
+        options: {
+            responsive: true, maintainAspectRatio: false,
+            scales: {
+                x: { type: 'category', title: { display: true, text: 'Tempo', font: { size: 14 } }, ticks: { autoSkip: true, maxTicksLimit: 10, color: '#f0f0f0', font: { size: 12, weight: 'bold' } }, grid: { color: 'rgba(189,195,199,0.1)' } },
+                y: { beginAtZero: false, title: { display: true, text: unit, font: { size: 14 } }, ticks: { color: '#f0f0f0', font: { size: 12, weight: 'bold' }, callback: function (value) { return value.toFixed(2); } }, grid: { color: 'rgba(189,195,199,0.1)' } }
+            },
+            plugins: { legend: { display: false }, tooltip: { backgroundColor: '#34495e', titleColor: '#1abc9c', bodyColor: '#ecf0f1' } },
+            animation: { duration: 0 }
+        }
+    });
+}
+
+// Sem o Chart.js (build sem o bundle) a página segue com leituras e offsets
+function initializeCharts() {
+    if (typeof Chart === 'undefined') {
+        console.warn('Chart.js ausente: página sem gráficos');
+        return;
+    }
+    state.tempAHTChart = createChart('tempAHTChart', 'Temperatura AHT20', '°C');
+    state.humidityAHTChart = createChart('humidityAHTChart', 'Umidade AHT20', '%');
+    state.tempBMPChart = createChart('tempBMPChart', 'Temperatura BMP280', '°C');
+    state.pressureBMPChart = createChart('pressureBMPChart', 'Pressão BMP280', 'kPa');
+}
+
+function updateChart(chart, history) {
+    chart.data.labels = state.labels;
+    chart.data.datasets[0].data = history;
+    chart.update();
+}
+
+function timeLabel(date) {
+    const h = String(date.getHours()).padStart(2, '0');
+    const m = String(date.getMinutes()).padStart(2, '0');
+    const s = String(date.getSeconds()).padStart(2, '0');
+    return `${h}:${m}:${s}`;
+}
+
+function pushPoint(label, tempAHT, humidityAHT, tempBMP, pressureKPa) {
+    if (state.labels.length >= MAX_HISTORY_POINTS) {
+        state.labels.shift();
+        state.tempAHTHistory.shift();
+        state.humidityAHTHistory.shift();
+        state.tempBMPHistory.shift();
+        state.pressureBMPHistory.shift();
+    }
+    state.labels.push(label);
+    state.tempAHTHistory.push(tempAHT);
+    state.humidityAHTHistory.push(humidityAHT);
+    state.tempBMPHistory.push(tempBMP);
+    state.pressureBMPHistory.push(pressureKPa);
+}
+
+function updateCharts() {
+    if (!state.tempAHTChart) { return; }
+    updateChart(state.tempAHTChart, state.tempAHTHistory);
+    updateChart(state.humidityAHTChart, state.humidityAHTHistory);
+    updateChart(state.tempBMPChart, state.tempBMPHistory);
+    updateChart(state.pressureBMPChart, state.pressureBMPHistory);
+}
+
+// Busca só as amostras posteriores a state.lastSeq (todas na primeira carga)
+async function loadHistory() {
+    if (state.loadingHistory) { return; }
+    state.loadingHistory = true;
+    try {
+        const r = await fetch(`/history?since=${state.lastSeq}`);
+        if (!r.ok) { throw new Error('Erro ao carregar histórico'); }
+        const first = Number(r.headers.get('X-History-First'));
+        const deviceNow = Number(r.headers.get('X-History-Now'));
+        const view = new DataView(await r.arrayBuffer());
+        const now = Date.now();
+        const count = Math.floor(view.byteLength / HISTORY_RECORD_SIZE);
+        // Só os pontos que cabem no gráfico
+        for (let i = Math.max(0, count - MAX_HISTORY_POINTS); i < count; i++) {
+            const seq = first + i;
+            if (seq <= state.lastSeq) { continue; }
+            const o = i * HISTORY_RECORD_SIZE;
+            const timeMs = view.getUint32(o, true);
+            pushPoint(timeLabel(new Date(now - (deviceNow - timeMs))),
+                      view.getInt16(o + 8, true) / 100,
+                      view.getUint16(o + 10, true) / 100,
+                      view.getInt16(o + 12, true) / 100,
+                      view.getUint32(o + 4, true) / 100 / 1000);
+            state.lastSeq = seq;
+        }
+        updateCharts();
+    } catch (error) {
+        console.error('Erro ao buscar histórico:', error);
+    } finally {
+        state.loadingHistory = false;
+    }
+}
+
+function applySystemState(data) {
+    document.getElementById('tempAHT').textContent = (data.temperatura_aht !== undefined ? data.temperatura_aht.toFixed(2) : '--') + ' °C';
+    document.getElementById('humidityAHT').textContent = (data.umidade_aht !== undefined ? data.umidade_aht.toFixed(2) : '--') + ' %';
+    document.getElementById('tempBMP').textContent = (data.temperatura_bmp !== undefined ? data.temperatura_bmp.toFixed(2) : '--') + ' °C';
+    const pressureKPa = data.pressao_bmp !== undefined ? (data.pressao_bmp / 1000).toFixed(2) : '--';
+    document.getElementById('pressureBMP').textContent = pressureKPa + ' kPa';
+    if (data.temp_offset !== undefined && !isOffsetInputFocused) {
+        offsetInputs.temp.value = data.temp_offset.toFixed(1);
+        offsetInputs.humidity.value = data.humidity_offset.toFixed(1);
+        offsetInputs.pressure.value = data.pressure_offset.toFixed(1);
+    }
+    if (state.loadingHistory || data.seq <= state.lastSeq) {
+        return; // Já desenhada (ou chegará pela carga do histórico em andamento)
+    }
+    if (state.lastSeq && data.seq > state.lastSeq + 1) {
+        loadHistory(); // Amostras perdidas (reconexão, aba em segundo plano): busca só o intervalo
+        return;
+    }
+    pushPoint(timeLabel(new Date()), data.temperatura_aht, data.umidade_aht, data.temperatura_bmp, data.pressao_bmp / 1000);
+    state.lastSeq = data.seq;
+    updateCharts();
+}
+
+async function fetchSystemState() {
+    try {
+        const r = await fetch('/system_state');
+        if (!r.ok) { throw new Error('Erro na rede ou no servidor'); }
+        applySystemState(await r.json());
+    } catch (error) {
+        console.error('Erro ao buscar dados do sistema:', error);
+    }
+}
+
+// Cada amostra nova chega pelo stream; o EventSource reconecta sozinho se cair
+function startEventStream() {
+    if (!window.EventSource) {
+        setInterval(fetchSystemState, 5000);
+        return;
+    }
+    const source = new EventSource('/events');
+    source.onmessage = (event) => applySystemState(JSON.parse(event.data));
+}
+
+async function saveOffsets() {
+    const tOffset = parseFloat(offsetInputs.temp.value);
+    const hOffset = parseFloat(offsetInputs.humidity.value);
+    const pOffset = parseFloat(offsetInputs.pressure.value);
+    if (isNaN(tOffset) || isNaN(hOffset) || isNaN(pOffset)) {
+        offsetStatusMsg.textContent = 'Insira números válidos.';
+        offsetStatusMsg.style.color = '#ff6b6b';
+        return;
+    }
+    try {
+        const response = await fetch('/set_offsets', {
+            method: 'POST',
+            headers: { 'Content-Type': 'application/json' },
+            body: JSON.stringify({ temp_offset: tOffset, humidity_offset: hOffset, pressure_offset: pOffset })
+        });
+        if (response.ok) {
+            offsetStatusMsg.textContent = await response.text();
+            offsetStatusMsg.style.color = '#4ade80';
+            fetchSystemState();
+        } else {
+            const errorText = await response.text();
+            offsetStatusMsg.textContent = `Erro: ${response.status} - ${errorText}`;
+            offsetStatusMsg.style.color = '#ff6b6b';
+        }
+    } catch (error) {
+        console.error('Erro ao definir offsets:', error);
+        offsetStatusMsg.textContent = 'Erro de conexão.';
+        offsetStatusMsg.style.color = '#ff6b6b';
+    }
+    setTimeout(() => { offsetStatusMsg.textContent = ''; }, 5000);
+}
+
+document.addEventListener('DOMContentLoaded', () => {
+    initializeCharts();
+    loadHistory().then(fetchSystemState);
+    startEventStream();
+    Object.values(offsetInputs).forEach(input => {
+        input.addEventListener('focus', () => { isOffsetInputFocused = true; });
+        input.addEventListener('blur', () => { isOffsetInputFocused = false; });
+    });
+    document.getElementById('saveOffsetsBtn').addEventListener('click', saveOffsets);
+});
@@ -0,0 +1,99 @@
+// Página de limites: acompanha os limites atuais via /events e envia alterações para /set_limits
+const limitInputs = {
+    tempMin: document.getElementById('tempMin'),
+    tempMax: document.getElementById('tempMax'),
+    humidityMin: document.getElementById('humidityMin'),
+    humidityMax: document.getElementById('humidityMax'),
+    pressureMin: document.getElementById('pressureMin'),
+    pressureMax: document.getElementById('pressureMax'),
+    alertsEnabled: document.getElementById('alertsEnabled')
+};
+const statusMessage = document.getElementById('statusMessage');
+let isLimitsInputFocused = false;
+
+function applyLimits(data) {
+    if (!isLimitsInputFocused) {
+        limitInputs.tempMin.value = data.temp_min !== undefined ? data.temp_min.toFixed(1) : '';
+        limitInputs.tempMax.value = data.temp_max !== undefined ? data.temp_max.toFixed(1) : '';
+        limitInputs.humidityMin.value = data.humidity_min !== undefined ? data.humidity_min.toFixed(1) : '';
+        limitInputs.humidityMax.value = data.humidity_max !== undefined ? data.humidity_max.toFixed(1) : '';
+        limitInputs.pressureMin.value = data.pressure_min !== undefined ? data.pressure_min.toFixed(0) : '';
+        limitInputs.pressureMax.value = data.pressure_max !== undefined ? data.pressure_max.toFixed(0) : '';
+        limitInputs.alertsEnabled.checked = data.alerts_enabled == 1;
+    }
+}
+
+async function loadLimits() {
+    try {
+        const response = await fetch('/system_state');
+        if (!response.ok) throw new Error('Erro ao carregar limites do servidor');
+        applyLimits(await response.json());
+    } catch (error) {
+        console.error('Erro ao carregar limites:', error);
+        statusMessage.textContent = 'Erro ao carregar limites.';
+        statusMessage.style.color = '#ff6b6b';
+    }
+}
+
+async function saveLimits() {
+    const temp_min = parseFloat(limitInputs.tempMin.value);
+    const temp_max = parseFloat(limitInputs.tempMax.value);
+    const humidity_min = parseFloat(limitInputs.humidityMin.value);
+    const humidity_max = parseFloat(limitInputs.humidityMax.value);
+    const pressure_min = parseFloat(limitInputs.pressureMin.value);
+    const pressure_max = parseFloat(limitInputs.pressureMax.value);
+    const alerts_enabled = limitInputs.alertsEnabled.checked ? 1 : 0;
+    if (isNaN(temp_min) || isNaN(temp_max) || isNaN(humidity_min) || isNaN(humidity_max) || isNaN(pressure_min) || isNaN(pressure_max)) {
+        statusMessage.textContent = 'Por favor, preencha todos os campos com números válidos.';
+        statusMessage.style.color = '#ff6b6b';
+        return;
+    }
+    if (temp_min >= temp_max || humidity_min >= humidity_max || pressure_min >= pressure_max) {
+        statusMessage.textContent = 'O valor mínimo deve ser menor que o máximo.';
+        statusMessage.style.color = '#ff6b6b';
+        return;
+    }
+    try {
+        const response = await fetch('/set_limits', {
+            method: 'POST',
+            headers: { 'Content-Type': 'application/json' },
+            body: JSON.stringify({ temp_min, temp_max, humidity_min, humidity_max, pressure_min, pressure_max, alerts_enabled })
+        });
+        if (response.ok) {
+            statusMessage.textContent = await response.text();
+            statusMessage.style.color = '#4ade80';
+        } else {
+            const errorText = await response.text();
+            statusMessage.textContent = `Erro: ${response.status} - ${errorText}`;
+            statusMessage.style.color = '#ff6b6b';
+        }
+    } catch (error) {
+        console.error('Erro ao salvar limites:', error);
+        statusMessage.textContent = 'Erro de conexão ao salvar limites.';
+        statusMessage.style.color = '#ff6b6b';
+    }
+    setTimeout(() => { statusMessage.textContent = ''; }, 5000);
+}
+
+Object.values(limitInputs).forEach(input => {
+    if (input.type === 'number') {
+        input.addEventListener('focus', () => { isLimitsInputFocused = true; });
+        input.addEventListener('blur', () => { isLimitsInputFocused = false; });
+    }
+});
+
+// Limites alterados por outro navegador chegam junto com cada amostra
+function startEventStream() {
+    if (!window.EventSource) {
+        setInterval(loadLimits, 3000);
+        return;
+    }
+    const source = new EventSource('/events');
+    source.onmessage = (event) => applyLimits(JSON.parse(event.data));
+}
+
+document.addEventListener('DOMContentLoaded', () => {
+    loadLimits();
+    startEventStream();
+    document.getElementById('saveLimitsBtn').addEventListener('click', saveLimits);
+});